@@ -0,0 +1,319 @@
+import os
+import re
+import copy
+import struct
+import hashlib
+import COMPILATOR.src.myast as myast
+from COMPILATOR.src.myast import translate_ast_to_c, print_error
+
+# === 1. Bytecode Format ===
+# Keep in sync with SDL/files.h/vm.h
+
+BYTECODE_MAGIC = b"DPPB"
+BYTECODE_VERSION = 1
+
+# Opcodes, followed by their little-endian operands
+OP_INT = 0             # i32 value
+OP_FLOAT = 1           # f64 value
+OP_STRING = 2          # u16 string index
+OP_LOAD = 3            # u16 slot
+OP_STORE = 4           # u16 slot
+OP_ADD = 5
+OP_SUB = 6
+OP_MUL = 7
+OP_DIV = 8
+OP_EQ = 9
+OP_NE = 10
+OP_LT = 11
+OP_GT = 12
+OP_LE = 13
+OP_GE = 14
+OP_AND = 15
+OP_OR = 16
+OP_JUMP = 17           # u32 address
+OP_JUMP_IF_FALSE = 18  # u32 address
+OP_CALL = 19           # u16 function
+OP_RETURN = 20
+OP_POP = 21
+OP_DRAW = 22           # u8 shape, u8 flags, u16 color name string, u8 argument count
+
+DRAW_ANIMATED = 1  # Flags of OP_DRAW
+DRAW_FILLED = 2
+
+SHAPES = ["circle", "ellipse", "line", "polygon", "rectangle", "arc", "triangle", "square"]
+
+ARITHMETIC_OPS = {"+": OP_ADD, "-": OP_SUB, "*": OP_MUL, "/": OP_DIV}
+CONDITION_OPS = {"==": OP_EQ, "!=": OP_NE, "<": OP_LT, ">": OP_GT, "<=": OP_LE, ">=": OP_GE, "and": OP_AND, "or": OP_OR}
+
+# Configuration read from the defines of the C translation, with the runtime's value of DRAW_BATCH_OFF
+CONFIG_DEFINES = ["windowW", "windowH", "bgcolorR", "bgcolorG", "bgcolorB", "cursorcolorR", "cursorcolorG",
+                  "cursorcolorB", "cursorcolorA", "cursorSize", "drawBatch"]
+DRAW_BATCH_OFF = -1
+
+# === 2. Function Compilation ===
+
+# @{
+# @brief Compiles the body of one function (or of the main program) to bytecode.
+# @details Variables live in numbered slots of the function's frame, parameters first.
+#          Every block opens a scope, so a variable declared in a loop shadows an
+#          outer one like in the C translation.
+class FunctionCompiler:
+    def __init__(self, program, params):
+        self.program = program
+        self.code = bytearray()
+        self.jumps = []  # Positions of the jump targets, relocated once the functions are laid out
+        self.scopes = [{}]
+        self.slot_count = 0
+        for param in params:
+            self.declare(param.split()[1].split("[")[0])  # "int x" or "char name[10]"
+        self.param_count = len(params)
+
+    def declare(self, name):
+        self.scopes[-1][name] = self.slot_count
+        self.slot_count += 1
+        return self.scopes[-1][name]
+
+    def lookup(self, name):
+        for scope in reversed(self.scopes):
+            if name in scope:
+                return scope[name]
+        raise ValueError(f"ValueError : Variable '{name}' is not initialized.")
+
+    def emit(self, opcode, fmt="", *operands):
+        self.code.append(opcode)
+        if fmt:
+            self.code += struct.pack("<" + fmt, *operands)
+
+    def emit_jump(self, opcode):
+        self.emit(opcode, "I", 0)
+        self.jumps.append(len(self.code) - 4)
+        return len(self.code) - 4  # Patched once the target is known
+
+    def patch_jump(self, position, target=None):
+        struct.pack_into("<I", self.code, position, len(self.code) if target is None else target)
+
+    # @brief Compiles an expression or a condition, its value is left on the stack.
+    def expression(self, node):
+        if isinstance(node, bool):
+            self.emit(OP_INT, "i", 1 if node else 0)
+        elif isinstance(node, int):
+            self.emit(OP_INT, "i", node)
+        elif isinstance(node, float):
+            self.emit(OP_FLOAT, "d", node)
+        elif isinstance(node, str) and '"' in node:
+            self.emit(OP_STRING, "H", self.program.string(node.strip('"')))
+        elif isinstance(node, str):
+            self.emit(OP_LOAD, "H", self.lookup(node))
+        elif isinstance(node, tuple) and node[0] == "op":
+            self.expression(node[2])
+            self.expression(node[3])
+            self.emit(ARITHMETIC_OPS[node[1]])
+        elif isinstance(node, tuple) and node[0] in CONDITION_OPS:
+            self.expression(node[1])
+            self.expression(node[2])
+            self.emit(CONDITION_OPS[node[0]])
+        else:
+            raise TypeError(f"TypeError : Unsupported expression {node}")
+
+    def block(self, instructions):
+        self.scopes.append({})
+        for instr in instructions:
+            self.statement(instr)
+        self.scopes.pop()
+
+    # @brief Compiles one instruction.
+    def statement(self, node):
+        kind = node[0]
+
+        if kind == "draw":
+            forme, params = node[1], node[2]
+            for param in params[3:]:
+                self.expression(param)
+            flags = (DRAW_ANIMATED if params[0] == "animated" else 0) | (DRAW_FILLED if params[1] == "filled" else 0)
+            self.emit(OP_DRAW, "BBHB", SHAPES.index(forme), flags, self.program.string(params[2]), len(params) - 3)
+
+        elif kind == "assign":
+            self.expression(node[2])
+            self.emit(OP_STORE, "H", self.declare(node[1]))
+
+        elif kind == "modify":
+            self.expression(node[2])
+            self.emit(OP_STORE, "H", self.lookup(node[1]))
+
+        elif kind == "if":
+            if len(node) > 3 and isinstance(node[3], list):
+                elif_clauses = node[3]
+                bloc_false = node[4][1] if len(node) == 5 else None
+            else:
+                elif_clauses = []
+                bloc_false = node[3][1] if len(node) == 4 else None
+
+            end_jumps = []
+            for condition, bloc in [(node[1], node[2][1])] + [(clause[1], clause[2][1]) for clause in elif_clauses]:
+                self.expression(condition)
+                next_test = self.emit_jump(OP_JUMP_IF_FALSE)
+                self.block(bloc)
+                end_jumps.append(self.emit_jump(OP_JUMP))
+                self.patch_jump(next_test)
+            if bloc_false:
+                self.block(bloc_false)
+            for jump in end_jumps:
+                self.patch_jump(jump)
+
+        elif kind == "while":
+            start = len(self.code)
+            self.expression(node[1])
+            end = self.emit_jump(OP_JUMP_IF_FALSE)
+            self.block(node[2][1])
+            self.patch_jump(self.emit_jump(OP_JUMP), start)
+            self.patch_jump(end)
+
+        elif kind == "dowhile":
+            start = len(self.code)
+            self.block(node[1][1])
+            self.expression(node[2])
+            end = self.emit_jump(OP_JUMP_IF_FALSE)
+            self.patch_jump(self.emit_jump(OP_JUMP), start)
+            self.patch_jump(end)
+
+        elif kind == "for":
+            self.scopes.append({})  # The iterator only lives in the loop
+            self.statement(node[1])
+            start = len(self.code)
+            self.expression(node[2])
+            end = self.emit_jump(OP_JUMP_IF_FALSE)
+            self.block(node[4][1])
+            self.statement(node[3])
+            self.patch_jump(self.emit_jump(OP_JUMP), start)
+            self.patch_jump(end)
+            self.scopes.pop()
+
+        elif kind == "func_call":
+            args = node[2] if len(node) == 3 else []
+            for arg in args:
+                self.expression(arg)
+            self.emit(OP_CALL, "H", self.program.functions[node[1]])
+            self.emit(OP_POP)  # Every function returns a value, 0 for the void ones
+
+        elif kind == "ret":
+            self.expression(node[1])
+            self.emit(OP_RETURN)
+
+        elif kind == "block":
+            self.block(node[1])
+
+        elif kind in ("setcolor", "setsize", "setbatch", "func"):
+            pass  # Configuration and functions are read from the top level only
+
+        else:
+            raise Exception(f"CriticalError : Unsupported node -> {node}\n")
+
+    def finish(self):
+        self.emit(OP_INT, "i", 0)
+        self.emit(OP_RETURN)
+# @}
+
+# === 3. Program Compilation ===
+
+# @{
+# @brief Holds what the functions of a program share: the function table and the strings.
+class ProgramCompiler:
+    def __init__(self):
+        self.functions = {}  # Name -> index, 0 is the main program
+        self.strings = []
+
+    def string(self, text):
+        if text not in self.strings:
+            self.strings.append(text)
+        return self.strings.index(text)
+# @}
+
+# @{
+# @brief Reads the window and cursor configuration from the validated C translation.
+# @param c_code The C code generated by translate_ast_to_c for the same program.
+# @return A dictionary of the CONFIG_DEFINES values.
+def read_config(c_code):
+    config = {}
+    for name, value in re.findall(r"^#define (\w+) (.+)$", c_code, re.MULTILINE):
+        if name in CONFIG_DEFINES:
+            config[name] = DRAW_BATCH_OFF if value == "DRAW_BATCH_OFF" else int(value)
+    return config
+
+# @brief Translates the AST into bytecode for the runtime's virtual machine.
+# @details The program is first translated to C, on a copy of the AST, so it
+#          goes through exactly the same checks and error messages as a compiled run.
+# @param ast The abstract syntax tree containing program instructions.
+# @param filename The program name, used as the window title.
+# @return The bytecode, or None if the program has errors.
+def translate_ast_to_bytecode(ast, filename):
+    c_code = translate_ast_to_c(copy.deepcopy(ast), filename)
+    if c_code is None:
+        return None
+    config = read_config(c_code)
+
+    program = ProgramCompiler()
+    program.string(filename)  # String 0 is the window title
+    funcs = [node for node in ast if isinstance(node, tuple) and node[0] == "func"]
+    for i, func in enumerate(funcs):
+        program.functions[func[1]] = i + 1
+
+    try:
+        compilers = [FunctionCompiler(program, [])]
+        for node in ast:
+            if not (isinstance(node, tuple) and node[0] in ("setcolor", "setsize", "setbatch", "func")):
+                compilers[0].statement(node)
+        for func in funcs:
+            params = func[2] if len(func) == 4 else []
+            bloc = func[3][1] if len(func) == 4 else func[2][1]
+            compiler = FunctionCompiler(program, params)
+            compiler.block(bloc)
+            compilers.append(compiler)
+    except Exception as e:
+        print_error(f"{e}")
+        return None
+
+    code = bytearray()
+    table = bytearray()
+    for compiler in compilers:
+        compiler.finish()
+        for position in compiler.jumps:
+            target = struct.unpack_from("<I", compiler.code, position)[0]
+            struct.pack_into("<I", compiler.code, position, target + len(code))
+        table += struct.pack("<IHH", len(code), compiler.param_count, compiler.slot_count)
+        code += compiler.code
+
+    strings = bytearray()
+    for text in program.strings:
+        data = text.encode()
+        strings += struct.pack("<H", len(data)) + data
+
+    body = table + strings + code
+    program_hash = int.from_bytes(hashlib.sha256(body).digest()[:8], "little")  # Identifies the program for snapshots
+    header = BYTECODE_MAGIC + struct.pack("<HHQ11iIII", BYTECODE_VERSION, 0, program_hash,
+                                          *[config[name] for name in CONFIG_DEFINES],
+                                          len(compilers), len(program.strings), len(code))
+    return bytes(header + body)
+# @}
+
+# === 4. Bytecode Output ===
+
+# @{
+# @brief Translates the AST to bytecode and writes it next to .to_run.c.
+# @param ast The abstract syntax tree containing program instructions.
+# @param debug A flag to enable or disable debug output.
+# @param filename The program name, used as the window title.
+# @return True if the bytecode was written.
+def write_bytecode(ast, debug, filename):
+    myast.DEBUG = debug  # The C translation checks the program
+    bytecode = translate_ast_to_bytecode(ast, filename)
+    if bytecode is None:
+        return False
+
+    script_dir = os.path.dirname(os.path.abspath(__file__))
+    path = os.path.normpath(os.path.join(script_dir, "..", "..", ".to_run.dpc"))
+    with open(path, "wb") as f:
+        f.write(bytecode)
+
+    print(f"-#green Compilation completed successfully")
+    return True
+# @}
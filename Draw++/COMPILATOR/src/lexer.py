@@ -86,6 +86,7 @@ keywords = {
     'color': 'COLOR',
     'size': 'SIZE',
     'set': 'SET',
+    'batch': 'BATCH',
     'animated': 'ANIMATED',
     'instant': 'INSTANT',
     'empty': 'EMPTY',
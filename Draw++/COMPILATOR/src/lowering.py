@@ -0,0 +1,284 @@
+import copy
+
+# === 1. Constant Evaluation ===
+# Values follow the C translation: every folded variable is an int, with C division and overflow checks
+
+INT_MIN = -2 ** 31
+INT_MAX = 2 ** 31 - 1
+
+MAX_STATIC_DRAWS = 4096      # A loop drawing more than this stays a loop
+MAX_LOOP_ITERATIONS = 10000  # Same for a loop running longer, e.g. one that never ends
+
+# Arguments of each shape after mode, type and color
+SHAPE_ARGUMENTS = {"circle": 3, "ellipse": 4, "line": 5, "polygon": 4, "rectangle": 4, "arc": 5, "triangle": 3, "square": 3}
+
+COMPARISONS = {"==": lambda a, b: a == b, "!=": lambda a, b: a != b, "<": lambda a, b: a < b,
+               ">": lambda a, b: a > b, "<=": lambda a, b: a <= b, ">=": lambda a, b: a >= b}
+
+# @{
+# @brief Raised when a node depends on something only known when the program runs.
+class NotStatic(Exception):
+    pass
+# @}
+
+# @{
+# @brief Variables known at compile time, one dictionary per block.
+# @details A variable mapped to None exists but its value is only known at runtime.
+class Scopes:
+    def __init__(self):
+        self.scopes = [{}]
+
+    def lookup(self, name):
+        for scope in reversed(self.scopes):
+            if name in scope:
+                if scope[name] is None:
+                    raise NotStatic()
+                return scope[name]
+        raise NotStatic()
+
+    def declare(self, name, value):
+        self.scopes[-1][name] = value
+
+    def modify(self, name, value):
+        for scope in reversed(self.scopes):
+            if name in scope:
+                if scope[name] is None:
+                    raise NotStatic()
+                scope[name] = value
+                return
+        raise NotStatic()
+# @}
+
+# @{
+# @brief Checks that a value fits in a C int.
+def check_int(value):
+    if not INT_MIN <= value <= INT_MAX:
+        raise NotStatic()  # Overflows in C, leave it to the compiler
+    return value
+
+# @brief Evaluates an arithmetic expression like the C translation does.
+# @return The int value of the expression.
+def evaluate(node, scopes):
+    if isinstance(node, bool) or isinstance(node, float):
+        raise NotStatic()  # Only ints are folded
+    elif isinstance(node, int):
+        return check_int(node)
+    elif isinstance(node, str) and '"' not in node:
+        return scopes.lookup(node)
+    elif isinstance(node, tuple) and node[0] == "op":
+        left = evaluate(node[2], scopes)
+        right = evaluate(node[3], scopes)
+        if node[1] == "+":
+            return check_int(left + right)
+        elif node[1] == "-":
+            return check_int(left - right)
+        elif node[1] == "*":
+            return check_int(left * right)
+        elif node[1] == "/":
+            if right == 0:
+                raise NotStatic()
+            quotient = abs(left) // abs(right)  # C truncates toward zero
+            return check_int(quotient if (left < 0) == (right < 0) else -quotient)
+    raise NotStatic()
+
+# @brief Evaluates a condition like the C translation does, and and or short-circuit.
+# @return True or False.
+def evaluate_condition(node, scopes):
+    if isinstance(node, bool):
+        return node
+    elif isinstance(node, tuple) and node[0] == "and":
+        return evaluate_condition(node[1], scopes) and evaluate_condition(node[2], scopes)
+    elif isinstance(node, tuple) and node[0] == "or":
+        return evaluate_condition(node[1], scopes) or evaluate_condition(node[2], scopes)
+    elif isinstance(node, tuple) and node[0] in COMPARISONS:
+        return COMPARISONS[node[0]](evaluate(node[1], scopes), evaluate(node[2], scopes))
+    return evaluate(node, scopes) != 0
+# @}
+
+# === 2. Static Execution ===
+
+# @{
+# @brief Runs the instructions that can be run at compile time and records what they draw.
+# @details Any instruction depending on the runtime (function call, float or string
+#          variable, variable modified at runtime...) raises NotStatic.
+class StaticRun:
+    def __init__(self, scopes):
+        self.scopes = scopes
+        self.draws = []  # (shape, mode, type, color, arguments)
+
+    def block(self, instructions):
+        self.scopes.scopes.append({})
+        try:
+            for instr in instructions:
+                self.statement(instr)
+        finally:
+            self.scopes.scopes.pop()
+
+    # @brief Runs a chain of if / elif / else, returns the block that ran or None.
+    def choose_branch(self, node):
+        if len(node) > 3 and isinstance(node[3], list):
+            clauses = [(node[1], node[2][1])] + [(clause[1], clause[2][1]) for clause in node[3]]
+            bloc_false = node[4][1] if len(node) == 5 else None
+        else:
+            clauses = [(node[1], node[2][1])]
+            bloc_false = node[3][1] if len(node) == 4 else None
+        for condition, bloc in clauses:
+            if evaluate_condition(condition, self.scopes):
+                return bloc
+        return bloc_false
+
+    def loop(self, condition, bloc, check_first, step=None):
+        iterations = 0
+        while not check_first or evaluate_condition(condition, self.scopes):
+            check_first = True
+            iterations += 1
+            if iterations > MAX_LOOP_ITERATIONS:
+                raise NotStatic()
+            self.block(bloc)
+            if step is not None:
+                self.statement(step)
+
+    def statement(self, node):
+        kind = node[0] if isinstance(node, tuple) else None
+
+        if kind == "draw":
+            forme, params = node[1], node[2]
+            if SHAPE_ARGUMENTS.get(forme) != len(params) - 3:
+                raise NotStatic()
+            self.draws.append((forme, params[0], params[1], params[2], [evaluate(p, self.scopes) for p in params[3:]]))
+            if len(self.draws) > MAX_STATIC_DRAWS:
+                raise NotStatic()
+
+        elif kind == "assign":
+            self.scopes.declare(node[1], evaluate(node[2], self.scopes))
+
+        elif kind == "modify":
+            self.scopes.modify(node[1], evaluate(node[2], self.scopes))
+
+        elif kind == "if":
+            bloc = self.choose_branch(node)
+            if bloc:
+                self.block(bloc)
+
+        elif kind == "while":
+            self.loop(node[1], node[2][1], True)
+
+        elif kind == "dowhile":
+            self.loop(node[2], node[1][1], False)
+
+        elif kind == "for":
+            self.scopes.scopes.append({})  # The iterator only lives in the loop
+            try:
+                self.statement(node[1])
+                self.loop(node[2], node[4][1], True, node[3])
+            finally:
+                self.scopes.scopes.pop()
+
+        elif kind == "block":
+            self.block(node[1])
+
+        else:
+            raise NotStatic()  # Function calls and returns run at runtime
+# @}
+
+# === 3. Scene Lowering ===
+
+# @{
+# @brief Lists the names a node reads or writes, used to keep the variables runtime code needs.
+def names_in(node, names):
+    if isinstance(node, str) and '"' not in node:
+        names.add(node)
+    elif isinstance(node, (tuple, list)):
+        for child in node:
+            names_in(child, names)
+    return names
+
+# @brief Lists the variables a node modifies.
+def modified_in(node, names):
+    if isinstance(node, tuple) and node[0] == "modify":
+        names.add(node[1])
+    if isinstance(node, (tuple, list)):
+        for child in node:
+            modified_in(child, names)
+    return names
+
+# @brief Plans the main instructions, folding what is known at compile time.
+# @details Draws whose arguments are all known, including the ones of loops with a
+#          constant trip count and of branches with a constant condition, become static
+#          draws the runtime ingests as a table. The other instructions are kept, with
+#          the branch a constant condition selects only. Constant variables only
+#          keep their declaration if runtime code still reads them.
+# @param ast The main instructions, functions and directives already removed.
+# @return A list of steps, each one of:
+#          ("node", i)                 the instruction at index i, as translated
+#          ("block", i, instructions)  the branch selected in the instruction at index i
+#          ("assign", i, name, value)  a constant variable declaration
+#          ("modify", i, name, value)  a constant variable, as left by a folded loop
+#          ("draws", [draws])          consecutive static draws
+def plan_static_scene(ast):
+    scopes = Scopes()
+    steps = []
+
+    for i, node in enumerate(ast):
+        saved = copy.deepcopy(scopes.scopes)
+        before = dict(scopes.scopes[0])
+        run = StaticRun(scopes)
+        try:
+            if isinstance(node, tuple) and node[0] == "assign":
+                value = evaluate(node[2], scopes)
+                scopes.declare(node[1], value)
+                steps.append(("assign", i, node[1], value))
+                continue
+
+            run.statement(node)
+            steps.append(("draws", run.draws))
+            for name, value in scopes.scopes[0].items():
+                if name in before and before[name] != value:
+                    steps.append(("modify", i, name, value))
+            continue
+        except NotStatic:
+            scopes.scopes = saved
+
+        # Runtime instruction: only the selected branch of a constant condition is kept
+        step = ("node", i)
+        if isinstance(node, tuple) and node[0] == "if":
+            try:
+                bloc = StaticRun(scopes).choose_branch(node)
+                step = ("block", i, bloc or [])
+            except NotStatic:
+                pass
+        steps.append(step)
+
+        # What it modifies is only known at runtime from now on
+        if isinstance(node, tuple) and node[0] == "assign":
+            scopes.declare(node[1], None)
+        for name in modified_in(node, set()):
+            for scope in scopes.scopes:
+                if name in scope:
+                    scope[name] = None
+
+    # Variables read by the instructions kept as they are
+    needed = set()
+    for step in steps:
+        if step[0] == "node":
+            names_in(ast[step[1]], needed)
+        elif step[0] == "block":
+            names_in(step[2], needed)
+
+    plan = []
+    for step in steps:
+        if step[0] in ("assign", "modify") and step[2] not in needed:
+            continue
+        if step[0] == "draws":
+            if not step[1]:
+                continue
+            if plan and plan[-1][0] == "draws":
+                plan[-1] = ("draws", plan[-1][1] + step[1])
+                continue
+        elif step[0] in ("assign", "modify") and plan and plan[-1][0] == "draws":
+            # Draws do not read variables: declare before them and keep them in one table
+            plan.insert(len(plan) - 1, step)
+            continue
+        plan.append(step)
+    return plan
+# @}
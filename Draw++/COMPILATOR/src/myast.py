@@ -1,7 +1,9 @@
 import os
 import sys
 import copy
+import hashlib
 from COMPILATOR.src.lexer import suggest_keyword, colors
+from COMPILATOR.src.lowering import plan_static_scene
 
 # === 1. Error Handling ===
 
@@ -38,6 +40,14 @@ def print_error_interractive(e):
         raise SyntaxError(e)
 
 # @{
+# @brief Translates an operand of a condition, in parentheses when C would group it differently.
+# @details The parser nests and / or without precedence, C gives && precedence over ||.
+def logical_operand_to_c(ast, current_position, condition, operand):
+    operand_c = condition_to_c(ast, current_position, operand)
+    if condition[0] in ("and", "or") and isinstance(operand, tuple) and operand[0] in ("and", "or"):
+        return f"({operand_c})"
+    return operand_c
+
 # @brief Converts a condition to its C representation.
 # @param condition The condition to convert (boolean or tuple).
 # @return A string representing the condition in C syntax.
@@ -76,7 +86,7 @@ def condition_to_c(ast, current_position, condition):
                 return f"FALSE {op} TRUE"
             else:
                 return f"FALSE {op} FALSE"    
-        return f"TRUE {op} {condition_to_c(ast, current_position, condition[2])}" if condition[1] else f"FALSE {op} {condition_to_c(ast, current_position, condition[2])}"
+        return f"TRUE {op} {logical_operand_to_c(ast, current_position, condition, condition[2])}" if condition[1] else f"FALSE {op} {logical_operand_to_c(ast, current_position, condition, condition[2])}"
     
     elif type(condition[2]) == bool:
         if type(condition[1]) == bool:
@@ -88,9 +98,24 @@ def condition_to_c(ast, current_position, condition):
                 return f"FALSE {op} TRUE"
             else:
                 return f"FALSE {op} FALSE"
-        return f"{condition_to_c(ast, current_position, condition[1])} {op} TRUE" if condition[2] else f"{condition_to_c(ast, current_position, condition[1])} {op} FALSE"
+        return f"{logical_operand_to_c(ast, current_position, condition, condition[1])} {op} TRUE" if condition[2] else f"{logical_operand_to_c(ast, current_position, condition, condition[1])} {op} FALSE"
     else:
-        return f"{condition_to_c(ast, current_position, condition[1])} {op} {condition_to_c(ast, current_position, condition[2])}"
+        return f"{logical_operand_to_c(ast, current_position, condition, condition[1])} {op} {logical_operand_to_c(ast, current_position, condition, condition[2])}"
+# @}
+
+ARITHMETIC_PRECEDENCE = {"+": 1, "-": 1, "*": 2, "/": 2}
+
+# @{
+# @brief Translates an operand of an arithmetic operation, in parentheses when needed.
+# @details The parser drops the parentheses of the script, the AST nesting gives the order:
+#          a lower precedence operand, or an equal precedence one on the right, is grouped.
+# @param right True for the right operand.
+def arithmetic_operand_to_c(operand, operand_c, operator, right):
+    if isinstance(operand, tuple) and operand[0] == "op":
+        precedence = ARITHMETIC_PRECEDENCE[operand[1]]
+        if precedence < ARITHMETIC_PRECEDENCE[operator] or (right and precedence == ARITHMETIC_PRECEDENCE[operator]):
+            return f"({operand_c})"
+    return f"{operand_c}"
 # @}
 
 # === 2. AST Node Resolution ===
@@ -209,8 +234,8 @@ def resolve_value_and_find_variable(ast, value, current_position=None):
             # Determine result type
             result_type = "int" if type(result) == int else "float"
 
-            # Generate a flat expression
-            expr = f"{left_c} {operator} {right_c}"
+            # Generate the expression, parentheses kept where C precedence would change it
+            expr = f"{arithmetic_operand_to_c(value[2], left_c, operator, False)} {operator} {arithmetic_operand_to_c(value[3], right_c, operator, True)}"
             return result_type, expr, result
         else:
             raise TypeError(f"TypeError : Unsupported operation type: {value[0]}")
@@ -283,9 +308,8 @@ def translate_node_to_c(ast, prototypes, node, newline, tabulation, semicolon, c
         return node
     
     elif isinstance(node, str):
-        special_words = ["animated", "instant", "filled", "empty"]
-        if node in special_words:
-            return f'"{node}"'
+        if node in DRAW_KEYWORDS:
+            return DRAW_KEYWORDS[node]
         else:
             return node
     
@@ -316,7 +340,7 @@ def translate_node_to_c(ast, prototypes, node, newline, tabulation, semicolon, c
             expected_args = 6
 
         if expected_args == len(parametres):
-            c_code += f'if(drawShape(renderer, mainTexture, "{forme}", '
+            c_code += f'if(drawShape(renderer, mainTexture, {SHAPE_TYPES[forme]}, '
             for i, param in enumerate(parametres):
                 c_code += f"{translate_node_to_c(ast, prototypes, param, 0, 0, 0)}"
                 if i<len(parametres) - 1:
@@ -324,7 +348,6 @@ def translate_node_to_c(ast, prototypes, node, newline, tabulation, semicolon, c
 
             c_code += ') == -1) {\n'
             c_code += '\t' * (tabulation+1) + 'cleanup(mainTexture, renderer, window);\n'
-            c_code += '\t' * (tabulation+1) + f'printf("%sExecutionError: Failed to draw {forme}.\\n", RED_COLOR);\n'
             c_code += '\t' * (tabulation+1) + 'return -1;\n'
             c_code += '\t' * tabulation + '}'
 
@@ -601,8 +624,7 @@ def translate_node_to_c(ast, prototypes, node, newline, tabulation, semicolon, c
                         c_code += ', '
         c_code += f'){{\n'
 
-        for instr in bloc:
-            c_code += f"{translate_node_to_c(ast, prototypes, instr, 1, tabulation+1, True)}"
+        c_code += translate_block_to_c(ast, prototypes, bloc, tabulation+1, "")
 
         if tabulation > 0: 
             c_code += "\t" * tabulation
@@ -710,7 +732,7 @@ def translate_node_to_c(ast, prototypes, node, newline, tabulation, semicolon, c
         left_c = translate_node_to_c(ast, prototypes, node[2], 0, 0, 0)
         right_c = translate_node_to_c(ast, prototypes, node[3], 0, 0, 0)
 
-        return f"{left_c} {operator} {right_c}"
+        return f"{arithmetic_operand_to_c(node[2], left_c, operator, False)} {operator} {arithmetic_operand_to_c(node[3], right_c, operator, True)}"
 
     # Case: Modification (Assigning a value to a previously declared variable)
     elif isinstance(node, tuple) and node[0] == 'modify':
@@ -808,8 +830,7 @@ def translate_node_to_c(ast, prototypes, node, newline, tabulation, semicolon, c
         condition = node[2]
 
         c_code += "\t" * tabulation + "do {\n"
-        for instr in bloc[1]:
-            c_code += f"{translate_node_to_c(ast, prototypes, instr, 1, tabulation + 1, True)}"
+        c_code += translate_block_to_c(ast, prototypes, bloc[1], tabulation + 1, "")
         c_code += "\t" * tabulation + f"}} while ({condition_to_c(ast, current_position, condition)});\n"
 
     # Handle while loop (while)
@@ -822,8 +843,7 @@ def translate_node_to_c(ast, prototypes, node, newline, tabulation, semicolon, c
 
         c_code += f"while ({condition_to_c(ast, current_position, condition)}) {{"
         
-        for instr in bloc:
-            c_code += f"\n{translate_node_to_c(ast, prototypes, instr, 1, tabulation+1, True)}"
+        c_code += translate_block_to_c(ast, prototypes, bloc, tabulation+1, "\n")
         
         if tabulation > 0: 
             c_code += "\t" * tabulation
@@ -852,8 +872,7 @@ def translate_node_to_c(ast, prototypes, node, newline, tabulation, semicolon, c
 
         # Translate the main "if" block
         c_code += f"if ({condition_to_c(ast, current_position, condition)}) {{"
-        for instr in bloc_true:
-            c_code += f"\n{translate_node_to_c(ast, prototypes, instr, 1, tabulation+1, True)}"
+        c_code += translate_block_to_c(ast, prototypes, bloc_true, tabulation+1, "\n")
         if tabulation > 0: 
             c_code += "\t" * tabulation
         c_code += f"}}\n"
@@ -865,8 +884,7 @@ def translate_node_to_c(ast, prototypes, node, newline, tabulation, semicolon, c
             if tabulation > 0: 
                 c_code += "\t" * tabulation
             c_code += f"else if ({condition_to_c(ast, current_position, elif_condition)}) {{"
-            for instr in elif_bloc:
-                c_code += f"\n{translate_node_to_c(ast, prototypes, instr, 1, tabulation+1, True)}"
+            c_code += translate_block_to_c(ast, prototypes, elif_bloc, tabulation+1, "\n")
             if tabulation > 0: 
                 c_code += "\t" * tabulation
             c_code += f"}}\n"
@@ -876,8 +894,7 @@ def translate_node_to_c(ast, prototypes, node, newline, tabulation, semicolon, c
             if tabulation > 0: 
                 c_code += "\t" * tabulation
             c_code += f"else {{"
-            for instr in bloc_false:
-                c_code += f"\n{translate_node_to_c(ast, prototypes, instr, 1, tabulation+1, True)}"
+            c_code += translate_block_to_c(ast, prototypes, bloc_false, tabulation+1, "\n")
             if tabulation > 0: 
                 c_code += "\t" * tabulation
             c_code += f"}}\n"
@@ -897,8 +914,7 @@ def translate_node_to_c(ast, prototypes, node, newline, tabulation, semicolon, c
 
         c_code += f"for ({translate_node_to_c(ast, prototypes, init, 0, 0, 0)}; {condition_to_c(ast, current_position, condition)}; {translate_node_to_c(ast, prototypes, increment, 0, 0, 0)}) {{\n"
         
-        for instr in bloc:
-            c_code += f"{translate_node_to_c(ast, prototypes, instr, 1, tabulation+1, True)}"
+        c_code += translate_block_to_c(ast, prototypes, bloc, tabulation+1, "")
 
         if tabulation > 0: 
             c_code += "\t" * tabulation
@@ -976,6 +992,14 @@ def translate_node_to_c(ast, prototypes, node, newline, tabulation, semicolon, c
             c_code += f'#define windowW {width}\n'
             c_code += f'#define windowH {height}\n'
     
+    elif isinstance(node, tuple) and node[0] == 'setbatch':
+        cadence = node[1]
+
+        if type(cadence) == float or cadence < 0:
+            raise TypeError(f"TypeError : set batch expects an int >= 0, got {cadence}")
+
+        c_code += f'#define drawBatch {cadence}\n'
+
     # Default case (unsupported node)
     else:
         raise Exception(f"CriticalError : Unsupported node -> {node}\n")
@@ -986,6 +1010,68 @@ def translate_node_to_c(ast, prototypes, node, newline, tabulation, semicolon, c
     return c_code
 # @}
 
+# @{
+# @brief ShapeType of each shape, as drawShapes takes it.
+SHAPE_TYPES = {"circle": "SHAPE_CIRCLE", "ellipse": "SHAPE_ELLIPSE", "line": "SHAPE_LINE", "polygon": "SHAPE_POLYGON",
+               "rectangle": "SHAPE_RECTANGLE", "arc": "SHAPE_ARC", "triangle": "SHAPE_TRIANGLE", "square": "SHAPE_SQUARE"}
+# @brief DrawMode and FormType of the draw keywords.
+DRAW_KEYWORDS = {"animated": "DRAW_MODE_ANIMATED", "instant": "DRAW_MODE_INSTANT", "filled": "FORM_FILLED", "empty": "FORM_EMPTY"}
+
+# @brief Translates a draw to the ShapeDesc initializer of drawShapes.
+# @param args The C expressions of the shape arguments.
+def shape_desc_to_c(forme, mode, form_type, color, args):
+    return f'{{{SHAPE_TYPES[forme]}, {DRAW_KEYWORDS[mode]}, {DRAW_KEYWORDS[form_type]}, COLOR_{colors[color]}, {{{", ".join(str(arg) for arg in args)}}}}}'
+
+# @brief Translates a run of draws to a ShapeDesc table and a single drawShapes call.
+# @param descs The ShapeDesc initializers, from shape_desc_to_c.
+# @param table Name of a static table, for draws known at compile time. None for a local
+#              table evaluated where the draws are, in its own scope.
+def draw_run_to_c(descs, tabulation, table=None):
+    c_code = ""
+    if table is None:
+        c_code += "\t" * tabulation + "{\n"
+        tabulation += 1
+        table = "draws"
+        c_code += "\t" * tabulation + f"const ShapeDesc {table}[] = {{\n"
+    else:
+        c_code += "\t" * tabulation + f"static const ShapeDesc {table}[] = {{\n"
+    for desc in descs:
+        c_code += "\t" * (tabulation + 1) + f"{desc},\n"
+    c_code += "\t" * tabulation + "};\n"
+    c_code += "\t" * tabulation + f"if (drawShapes(renderer, mainTexture, {table}, {len(descs)}, DRAW_SHAPES_DEFAULT) == -1) {{\n"
+    c_code += "\t" * (tabulation + 1) + "cleanup(mainTexture, renderer, window);\n"
+    c_code += "\t" * (tabulation + 1) + "return -1;\n"
+    c_code += "\t" * tabulation + "}\n"
+    if table == "draws":
+        c_code += "\t" * (tabulation - 1) + "}\n"
+    return c_code
+
+# @brief Translates the instructions of a block, runs of consecutive draws become one drawShapes call.
+# @details Draw arguments cannot call functions, evaluating the arguments of a whole run
+#          before drawing it gives the same shapes.
+# @param separator Text put before each translated instruction.
+def translate_block_to_c(ast, prototypes, instructions, tabulation, separator):
+    c_code = ""
+    i = 0
+    while i < len(instructions):
+        end = i
+        while end < len(instructions) and isinstance(instructions[end], tuple) and instructions[end][0] == 'draw':
+            end += 1
+
+        if end - i >= 2:
+            descs = []
+            for instr in instructions[i:end]:
+                translate_node_to_c(ast, prototypes, instr, 1, tabulation, True)  # Checks the draw
+                args = [translate_node_to_c(ast, prototypes, param, 0, 0, 0) for param in instr[2][3:]]
+                descs.append(shape_desc_to_c(instr[1], instr[2][0], instr[2][1], instr[2][2], args))
+            c_code += separator + draw_run_to_c(descs, tabulation)
+            i = end
+        else:
+            c_code += separator + f"{translate_node_to_c(ast, prototypes, instructions[i], 1, tabulation, True)}"
+            i += 1
+    return c_code
+# @}
+
 # === 4. AST to C Code Translation ===
 
 # @{
@@ -1007,10 +1093,7 @@ def translate_ast_to_c(ast, filename):
     c_code += "//////////////////////////\n\n"
 
     # Includes
-    c_code += '#include "./SDL/files.h/main.h"\n'
-    c_code += '#include "./SDL/files.h/colors.h"\n'
-    c_code += '#include "./SDL/files.h/cursorEvents.h"\n'
-    c_code += '#include "./SDL/files.h/form.h"\n\n'
+    c_code += '#include "./SDL/files.h/runtime.h"\n\n'  # Public headers of libdpp_runtime
 
     c_code += "// ANSI escape codes for colors\n"
     c_code += '#define RED_COLOR "-#red "\n'
@@ -1018,9 +1101,15 @@ def translate_ast_to_c(ast, filename):
     c_code += "#define TRUE 1\n"
     c_code += "#define FALSE 0\n\n"
 
+    # Compiled with -DDPP_MODULE, the program is a scene module for the runtime host (make module)
+    c_code += "#ifdef DPP_MODULE\n"
+    c_code += "// The host owns the window, a failed draw only abandons the scene\n"
+    c_code += "#define cleanup(mainTexture, renderer, window) ((void)(mainTexture), (void)(renderer), (void)(window))\n"
+    c_code += "#endif\n\n"
+
     try:
         for i, node in enumerate(ast):
-            if isinstance(node, tuple) and node[0] in ['setcolor', 'setsize']:
+            if isinstance(node, tuple) and node[0] in ['setcolor', 'setsize', 'setbatch']:
                 topop.append(i) # Save the node's position
                 c_code += translate_node_to_c(ast, prototypes, node,0,0,False)
     except Exception as e:
@@ -1048,7 +1137,10 @@ def translate_ast_to_c(ast, filename):
         c_code += '#define windowW 800\n'
     if "#define windowH" not in c_code:
         c_code += '#define windowH 600\n'
-    c_code += f'#define windowTitle "{filename}"\n\n'
+    if "#define drawBatch" not in c_code:
+        c_code += '#define drawBatch DRAW_BATCH_OFF\n'
+    c_code += f'#define windowTitle "{filename}"\n'
+    c_code += '#define programId PROGRAM_HASH\n\n'  # Filled in once the whole program is generated
 
     if DEBUG:
         print("\n[DEBUG] Translating AST to C code...")
@@ -1089,9 +1181,8 @@ def translate_ast_to_c(ast, filename):
     c_code += "// Main function //\n"
     c_code += "///////////////////\n\n"
 
+    c_code += "#ifndef DPP_MODULE\n"
     c_code += f"int main(int argc, char *argv[]) {{\n"
-    c_code += "    (void)argc;\n"    # Suppress unused parameter warning
-    c_code += "    (void)argv;\n\n"  # Suppress unused parameter warning
 
     c_code += "    /////////////////////////\n"
     c_code += "    // Configuration Start //\n"
@@ -1101,25 +1192,37 @@ def translate_ast_to_c(ast, filename):
     c_code += f'    SDL_Renderer *renderer = NULL;\n'
     c_code += f'    SDL_Event event;\n'
     c_code += f'    SDL_Texture* mainTexture = NULL;\n'
+    c_code += f'    if (parseHeadlessArgs(argc, argv) != 0) return -1;\n'  # --headless selects the dummy video driver, before SDL_Init
+    c_code += f'    setDrawBatch(drawBatch);\n'
+    c_code += f'    if (parseDrawBatchArgs(argc, argv) != 0) return -1;\n'  # --batch N overrides the set batch directive
+    c_code += f'    snapshot.programHash = programId;\n'
+    c_code += f'    if (parseSnapshotArgs(argc, argv) != 0) return -1;\n'  # --snapshot FILE restores the scene saved by a previous run
     c_code += f'    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS) != 0) {{\n' 
     c_code += f'        printf("%sExecutionError: Failed to initialize SDL.\\n", RED_COLOR);\n'
     c_code += f'        return -1;\n'
     c_code += f'    }}\n'
-    c_code += f'    if (SDL_CreateWindowAndRenderer(windowW, windowH, SDL_WINDOW_RESIZABLE, &window, &renderer) != 0) {{\n'
-    c_code += f'        printf("%sExecutionError: Failed to create window and renderer.\\n", RED_COLOR);\n'
-    c_code += f'        SDL_Quit();\n'
-    c_code += f'        return -1;\n'
-    c_code += f'    }}\n'
-    c_code += f'    SDL_Surface* icon = SDL_LoadBMP("IDE/Dpp_circle.bmp");\n'
-    c_code += f'    if (icon) {{\n'
-    c_code += f'        SDL_SetWindowIcon(window, icon);\n'
-    c_code += f'        SDL_FreeSurface(icon);\n'
+    c_code += f'    if (headless.enabled) {{\n'
+    c_code += f'        if (createHeadlessRenderer(windowW, windowH, &renderer) != 0) {{\n'
+    c_code += f'            SDL_Quit();\n'
+    c_code += f'            return -1;\n'
+    c_code += f'        }}\n'
     c_code += f'    }} else {{\n'
-    c_code += f'        printf("%sExecutionError: Failed to load icon.\\n", RED_COLOR);\n'
-    c_code += f'        cleanup(mainTexture, renderer, window);\n'
-    c_code += f'        return -1;\n'
+    c_code += f'        if (SDL_CreateWindowAndRenderer(windowW, windowH, SDL_WINDOW_RESIZABLE, &window, &renderer) != 0) {{\n'
+    c_code += f'            printf("%sExecutionError: Failed to create window and renderer.\\n", RED_COLOR);\n'
+    c_code += f'            SDL_Quit();\n'
+    c_code += f'            return -1;\n'
+    c_code += f'        }}\n'
+    c_code += f'        SDL_Surface* icon = SDL_LoadBMP("IDE/Dpp_circle.bmp");\n'
+    c_code += f'        if (icon) {{\n'
+    c_code += f'            SDL_SetWindowIcon(window, icon);\n'
+    c_code += f'            SDL_FreeSurface(icon);\n'
+    c_code += f'        }} else {{\n'
+    c_code += f'            printf("%sExecutionError: Failed to load icon.\\n", RED_COLOR);\n'
+    c_code += f'            cleanup(mainTexture, renderer, window);\n'
+    c_code += f'            return -1;\n'
+    c_code += f'        }}\n'
+    c_code += f'        SDL_SetWindowTitle(window, windowTitle);\n'
     c_code += f'    }}\n'
-    c_code += f'    SDL_SetWindowTitle(window, windowTitle);\n'
     c_code += f'    mainTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, windowW, windowH);\n'
     c_code += f'    if (!mainTexture) {{\n'
     c_code += f'        printf("%sExecutionError: Failed to create main texture.\\n", RED_COLOR);\n'
@@ -1144,14 +1247,56 @@ def translate_ast_to_c(ast, filename):
     c_code += "    // User Instructions Start //\n"
     c_code += "    /////////////////////////////\n\n"
 
+    # A valid snapshot holds the scene the instructions would draw, skip them
+    c_code += f'    bool sceneRestored = snapshot.enabled && loadSnapshot(snapshot.path) == 0;\n'
+    c_code += f'    if (!sceneRestored) {{\n'
+
+    instructions = ""  # Shared with the scene function of the module
     try:
-        for i, node in enumerate(ast):
-            c_code += translate_node_to_c(ast, prototypes, node, 1, 1, 1, current_position=i)
+        # Every instruction is translated, which also checks it, even if folded below
+        translations = [translate_node_to_c(ast, prototypes, node, 1, 2, 1, current_position=i) for i, node in enumerate(ast)]
+
+        # Constant draws go to static tables, constant conditions only keep their branch
+        table_count = 0
+        run = []  # Consecutive runtime draws, drawn together
+        for step in plan_static_scene(ast) + [("end",)]:
+            if step[0] == "node" and isinstance(ast[step[1]], tuple) and ast[step[1]][0] == "draw":
+                run.append(step[1])
+                continue
+            if len(run) == 1:
+                instructions += translations[run[0]]
+            elif run:
+                descs = []
+                for i in run:
+                    params = ast[i][2]
+                    args = [translate_node_to_c(ast, prototypes, param, 0, 0, 0) for param in params[3:]]
+                    descs.append(shape_desc_to_c(ast[i][1], params[0], params[1], params[2], args))
+                instructions += draw_run_to_c(descs, 2)
+            run = []
+
+            if step[0] == "node":
+                instructions += translations[step[1]]
+            elif step[0] == "block":
+                instructions += "\t" * 2 + "{\n"
+                instructions += translate_block_to_c(ast, prototypes, step[2], 3, "")
+                instructions += "\t" * 2 + "}\n"
+            elif step[0] == "assign":
+                instructions += "\t" * 2 + f"int {step[2]} = {step[3]};\n"
+            elif step[0] == "modify":
+                instructions += "\t" * 2 + f"{step[2]} = {step[3]};\n"
+            elif step[0] == "draws":
+                descs = [shape_desc_to_c(*draw[:4], draw[4]) for draw in step[1]]
+                instructions += draw_run_to_c(descs, 2, f"staticDraws{table_count}")
+                table_count += 1
+                if DEBUG:
+                    print(f"[DEBUG] {len(descs)} static draws lowered to staticDraws{table_count - 1}")
     except Exception as e:
         if DEBUG : print_error(f"Error during the traduction of the main AST : {e}")
         else : print_error(f"{e}")
         return None  # Signal an error occurred
     
+    c_code += instructions
+    c_code += f'    }}\n'
     c_code += f'\n'
     c_code += "    ///////////////////////////\n"
     c_code += "    // User Instructions End //\n"
@@ -1170,12 +1315,44 @@ def translate_ast_to_c(ast, filename):
     c_code += f'        return -1;\n'
     c_code += f'    }}\n'
     c_code += f'    SDL_RenderPresent(renderer);\n'
+    c_code += f'    if (headless.enabled) {{\n'
+    c_code += f'        int result = runHeadless(renderer, bgcolorR, bgcolorG, bgcolorB);\n'
+    c_code += f'        cleanup(mainTexture, renderer, window);\n'
+    c_code += f'        return result;\n'
+    c_code += f'    }}\n'
     c_code += f'    mainLoop(window, renderer, event, cursor, bgcolorR, bgcolorG, bgcolorB);\n'
     c_code += f'    cleanup(mainTexture, renderer, window);\n'
 
     c_code += f"\n\treturn 0;\n"
     c_code += f"}}\n"
 
+    c_code += "#else\n\n"
+
+    c_code += "////////////////////\n"
+    c_code += "// Scene function //\n"
+    c_code += "////////////////////\n\n"
+
+    # What main draws, run by the host on every rebuild of the module
+    c_code += f"int dppScene(SDL_Window *window, SDL_Renderer *renderer, SDL_Texture *mainTexture) {{\n"
+    c_code += f'    (void)window;  // Only passed to the user functions\n'
+    c_code += f'    {{\n'
+    c_code += instructions
+    c_code += f'    }}\n'
+    c_code += f"\treturn 0;\n"
+    c_code += f"}}\n\n"
+
+    # Read by the host to create the window before running the scene
+    c_code += f'const SceneModule dppModule = {{\n'
+    c_code += f'    windowW, windowH, bgcolorR, bgcolorG, bgcolorB,\n'
+    c_code += f'    {{cursorcolorR, cursorcolorG, cursorcolorB, cursorcolorA}}, cursorSize, drawBatch,\n'
+    c_code += f'    windowTitle, programId, dppScene\n'
+    c_code += f'}};\n'
+    c_code += "#endif\n"
+
+    # Snapshots saved by another program are stale, identify this one by its code
+    program_hash = hashlib.sha256(c_code.encode()).hexdigest()[:16]
+    c_code = c_code.replace('#define programId PROGRAM_HASH', f'#define programId 0x{program_hash}ULL', 1)
+
     if DEBUG:
         print(f"[DEBUG] Successfully generated C code :")
         lines = c_code.splitlines()
@@ -183,6 +183,12 @@ def p_set_size_curs(p):
     '''set : SET CURSOR SIZE LPAREN NUMBER RPAREN'''
     p[0] = ('setsize', p[2], p[5])
 
+# @brief Handles instant draw batching instructions
+# @param p Tuple containing production information
+def p_set_batch(p):
+    '''set : SET BATCH LPAREN NUMBER RPAREN'''
+    p[0] = ('setbatch', p[4])
+
 # @brief Defines modifiable elements (window, cursor)
 # @param p Tuple containing production information
 def p_elem(p):
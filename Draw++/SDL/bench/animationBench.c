@@ -0,0 +1,123 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../files.h/formEvents.h"
+#include "../files.h/animations.h"
+#include "../files.h/animationKernels.h"
+
+// Size of the window the bouncing shapes are kept in
+#define BENCH_WIDTH 1280
+#define BENCH_HEIGHT 720
+#define BENCH_DT (1.0f / 60.0f)
+
+/**
+ * @brief Builds an animating shape inside the benchmark window.
+ *
+ * Cycles through circles, rectangles and polygons. Every shape rotates, and gets
+ * zoom, color and bounce animations in turn, so each lane holds a share of the scene.
+ *
+ * @param i Index of the shape, used to pick its type and animations.
+ * @return The shape; addShape clears isAnimating, so it is set again once stored.
+ */
+static Shape animatedShape(int i) {
+    Shape shape = {0};
+    shape.color = (SDL_Color){rand() % 256, rand() % 256, rand() % 256, 255};
+    shape.typeForm = FORM_FILLED;
+
+    int x = 50 + rand() % (BENCH_WIDTH - 100);
+    int y = 50 + rand() % (BENCH_HEIGHT - 100);
+    int size = 5 + rand() % 40;
+
+    switch (i % 3) {
+        case 0:
+            shape.type = SHAPE_CIRCLE;
+            shape.data.circle.x = x;
+            shape.data.circle.y = y;
+            shape.data.circle.radius = size;
+            break;
+        case 1:
+            shape.type = SHAPE_RECTANGLE;
+            shape.data.rectangle.x = x;
+            shape.data.rectangle.y = y;
+            shape.data.rectangle.width = size * 2;
+            shape.data.rectangle.height = size;
+            break;
+        default:
+            shape.type = SHAPE_POLYGON;
+            shape.data.polygon.cx = x;
+            shape.data.polygon.cy = y;
+            shape.data.polygon.radius = size;
+            shape.data.polygon.sides = 3 + rand() % 8;
+            break;
+    }
+
+    shape.animations[shape.num_animations++] = ANIM_ROTATE;
+    shape.animations[shape.num_animations++] = (i % 2) ? ANIM_ZOOM : ANIM_COLOR;
+    if (i % 4 == 0) shape.animations[shape.num_animations++] = ANIM_BOUNCE;
+    return shape;
+}
+
+/**
+ * @brief Runs a number of animation updates on the whole scene.
+ *
+ * @param level The lane kernels to use, or -1 for the per-shape updateAnimations path.
+ * @param frames Number of updates.
+ * @return The average update time in microseconds.
+ */
+static double timeUpdates(int level, int frames) {
+    double frequency = (double)SDL_GetPerformanceFrequency();
+    if (level >= 0) setAnimationKernels((KernelLevel)level);
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int f = 0; f < frames; f++) {
+        if (level < 0) {
+            updateAnimations(shapes, shapeCount, BENCH_WIDTH, BENCH_HEIGHT, BENCH_DT);
+        } else {
+            updateAnimationLanes(BENCH_WIDTH, BENCH_HEIGHT, BENCH_DT);
+        }
+    }
+    return (SDL_GetPerformanceCounter() - start) * 1000000.0 / frequency / frames;
+}
+
+/**
+ * @brief Measures the average time of one animation update as the scene grows.
+ *
+ * Compares the per-shape path (updateAnimations) with the animation lanes, once for
+ * every kernel level the CPU supports. No renderer is needed.
+ * Usage: animationBench [maxShapes] [framesPerStep]
+ */
+int main(int argc, char *argv[]) {
+    int maxShapes = argc > 1 ? atoi(argv[1]) : 50000;
+    int frames = argc > 2 ? atoi(argv[2]) : 200;
+    if (maxShapes <= 0 || frames <= 0) {
+        printf("Usage: %s [maxShapes] [framesPerStep]\n", argv[0]);
+        return 1;
+    }
+
+    srand(42);
+    int bestLevel = setAnimationKernels(KERNEL_AVX2);
+
+    printf("%10s %14s", "shapes", "per-shape (us)");
+    for (int level = KERNEL_SCALAR; level <= bestLevel; level++) {
+        printf(" %9s (us)", getKernelLevelName((KernelLevel)level));
+    }
+    printf("\n");
+
+    for (int count = 100; count <= maxShapes; count *= 2) {
+        while (shapeCount < count) {
+            getShape(addShape(animatedShape(shapeCount)))->isAnimating = true;
+        }
+        invalidateAnimationLanes();
+
+        printf("%10d %14.1f", shapeCount, timeUpdates(-1, frames));
+        for (int level = KERNEL_SCALAR; level <= bestLevel; level++) {
+            printf(" %14.1f", timeUpdates(level, frames));
+        }
+        printf("\n");
+    }
+
+    freeAnimationLanes();
+    freeShapes();
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <SDL2/SDL.h>
+#include <stdlib.h>
+
+#include "benchShapes.h"
+
+// Shape types cycled through, the first four are the basic scene
+static const ShapeType benchTypes[] = {
+    SHAPE_CIRCLE, SHAPE_RECTANGLE, SHAPE_POLYGON, SHAPE_LINE,
+    SHAPE_SQUARE, SHAPE_ELLIPSE, SHAPE_TRIANGLE, SHAPE_ARC
+};
+
+/**
+ * @brief Builds a random shape that fits in a benchmark target.
+ *
+ * Cycles through the shape types, alternating filled and empty from one cycle to
+ * the next. Call srand first so that runs draw the same scene.
+ *
+ * @param i Index of the shape, used to pick its type and fill mode.
+ * @param width Width of the target.
+ * @param height Height of the target.
+ * @param maxSize Largest radius or side, at least 5.
+ * @param flags BENCH_SHAPES_* options.
+ * @return The shape, ready to be passed to addShape (which keeps the selection flag).
+ */
+Shape randomBenchShape(int i, int width, int height, int maxSize, Uint32 flags) {
+    int types = (flags & BENCH_SHAPES_ALL_TYPES) ? 8 : 4;
+
+    Shape shape = {0};
+    shape.type = benchTypes[i % types];
+    shape.color = (SDL_Color){rand() % 256, rand() % 256, rand() % 256, 255};
+    shape.typeForm = ((i / types) % 2) ? FORM_FILLED : FORM_EMPTY;
+    if ((flags & BENCH_SHAPES_TRANSLUCENT) && i % 8 == 0) shape.color.a = 128;
+    if (flags & BENCH_SHAPES_ROTATED) shape.rotation = rand() % 360;
+    if (flags & BENCH_SHAPES_SELECTED) shape.selected = (i % 10 == 0);
+
+    int x = rand() % width;
+    int y = rand() % height;
+    int size = 5 + rand() % (maxSize > 5 ? maxSize - 4 : 1);
+
+    switch (shape.type) {
+        case SHAPE_CIRCLE:
+            shape.data.circle.x = x;
+            shape.data.circle.y = y;
+            shape.data.circle.radius = size;
+            break;
+        case SHAPE_RECTANGLE:
+            shape.data.rectangle.x = x;
+            shape.data.rectangle.y = y;
+            shape.data.rectangle.width = size * 2;
+            shape.data.rectangle.height = size;
+            break;
+        case SHAPE_SQUARE:
+            shape.data.square.x = x;
+            shape.data.square.y = y;
+            shape.data.square.c = size;
+            break;
+        case SHAPE_ELLIPSE:
+            shape.data.ellipse.x = x;
+            shape.data.ellipse.y = y;
+            shape.data.ellipse.rx = size;
+            shape.data.ellipse.ry = size / 2 + 1;
+            break;
+        case SHAPE_POLYGON:
+            shape.data.polygon.cx = x;
+            shape.data.polygon.cy = y;
+            shape.data.polygon.radius = size;
+            shape.data.polygon.sides = 3 + rand() % 10;
+            break;
+        case SHAPE_TRIANGLE:
+            shape.data.triangle.cx = x;
+            shape.data.triangle.cy = y;
+            shape.data.triangle.radius = size;
+            break;
+        case SHAPE_ARC:
+            shape.data.arc.x = x;
+            shape.data.arc.y = y;
+            shape.data.arc.radius = size;
+            shape.data.arc.start_angle = rand() % 360;
+            shape.data.arc.end_angle = rand() % 360;
+            break;
+        case SHAPE_LINE:
+            shape.data.line.x1 = x;
+            shape.data.line.y1 = y;
+            shape.data.line.x2 = x + size * 2;
+            shape.data.line.y2 = y + size;
+            shape.data.line.thickness = 1 + rand() % 6;
+            break;
+    }
+    return shape;
+}
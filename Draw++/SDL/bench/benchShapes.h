@@ -0,0 +1,16 @@
+#ifndef BENCH_SHAPES_H
+#define BENCH_SHAPES_H
+
+#include <SDL2/SDL.h>
+#include "../files.h/main.h"
+
+// Scene options of randomBenchShape, combined with |
+#define BENCH_SHAPES_BASIC       0           // Circles, rectangles, polygons and lines, opaque, not rotated
+#define BENCH_SHAPES_ALL_TYPES   (1u << 0)   // Cycle through every shape type
+#define BENCH_SHAPES_ROTATED     (1u << 1)   // Random rotation
+#define BENCH_SHAPES_SELECTED    (1u << 2)   // One shape in ten is selected
+#define BENCH_SHAPES_TRANSLUCENT (1u << 3)   // One shape in eight is half transparent
+
+Shape randomBenchShape(int i, int width, int height, int maxSize, Uint32 flags);
+
+#endif // BENCH_SHAPES_H
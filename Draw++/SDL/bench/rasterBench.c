@@ -0,0 +1,109 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../files.h/formEvents.h"
+#include "../files.h/geometry.h"
+#include "../files.h/softRaster.h"
+#include "benchShapes.h"
+
+// Size of the offscreen target the scene is rendered into
+#define BENCH_WIDTH 1920
+#define BENCH_HEIGHT 1080
+
+// Channels further apart than this count as a differing pixel
+#define BENCH_TOLERANCE 2
+
+/**
+ * @brief Clears the target and draws the scene with the given back-end.
+ */
+static void drawScene(SDL_Renderer *renderer, RenderPath path) {
+    setRenderPath(path);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    renderAllShapes(renderer);
+}
+
+/**
+ * @brief Counts the pixels that differ between two RGBA frames.
+ */
+static int countDifferences(const Uint8 *a, const Uint8 *b, int pixels) {
+    int differences = 0;
+    for (int i = 0; i < pixels * 4; i += 4) {
+        for (int c = 0; c < 4; c++) {
+            if (abs(a[i + c] - b[i + c]) > BENCH_TOLERANCE) {
+                differences++;
+                break;
+            }
+        }
+    }
+    return differences;
+}
+
+/**
+ * @brief Compares the software rasterizer with SDL_RenderGeometry, then measures
+ *        how its frame time scales with the number of threads.
+ *
+ * Both run on a software renderer bound to an offscreen surface, from the same
+ * tessellation, so the differing pixels come from coverage rules and blending only.
+ * Usage: rasterBench [shapes] [frames]
+ */
+int main(int argc, char *argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 50000;
+    int frames = argc > 2 ? atoi(argv[2]) : 10;
+    if (count <= 0 || frames <= 0) {
+        printf("Usage: %s [shapes] [frames]\n", argv[0]);
+        return 1;
+    }
+
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, BENCH_WIDTH, BENCH_HEIGHT, 32, SDL_PIXELFORMAT_RGBA32);
+    SDL_Renderer *renderer = surface ? SDL_CreateSoftwareRenderer(surface) : NULL;
+    Uint8 *reference = malloc((size_t)BENCH_WIDTH * BENCH_HEIGHT * 4);
+    if (!renderer || !reference) {
+        printf("Failed to create the offscreen renderer: %s\n", SDL_GetError());
+        if (renderer) SDL_DestroyRenderer(renderer);
+        if (surface) SDL_FreeSurface(surface);
+        free(reference);
+        return 1;
+    }
+
+    srand(42);
+    while (shapeCount < count) {
+        addShape(randomBenchShape(shapeCount, BENCH_WIDTH, BENCH_HEIGHT, 64,
+                                  BENCH_SHAPES_ALL_TYPES | BENCH_SHAPES_ROTATED | BENCH_SHAPES_SELECTED | BENCH_SHAPES_TRANSLUCENT));
+    }
+
+    drawScene(renderer, RENDER_GEOMETRY);
+    memcpy(reference, surface->pixels, (size_t)BENCH_WIDTH * BENCH_HEIGHT * 4);
+    drawScene(renderer, RENDER_SOFTWARE);
+    int differences = countDifferences(reference, surface->pixels, BENCH_WIDTH * BENCH_HEIGHT);
+    printf("%d shapes, %dx%d: %d pixels (%.3f%%) differ from SDL_RenderGeometry\n\n", shapeCount,
+           BENCH_WIDTH, BENCH_HEIGHT, differences, differences * 100.0 / (BENCH_WIDTH * BENCH_HEIGHT));
+
+    double frequency = (double)SDL_GetPerformanceFrequency();
+    double singleMs = 0;
+    printf("%10s %12s %10s\n", "threads", "frame (ms)", "speedup");
+    for (int threads = 1; threads <= SDL_GetCPUCount() && threads <= RASTER_MAX_THREADS; threads *= 2) {
+        setRasterThreads(threads);
+        drawScene(renderer, RENDER_SOFTWARE);  // Starts the workers outside of the timing
+
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (int f = 0; f < frames; f++) {
+            drawScene(renderer, RENDER_SOFTWARE);
+        }
+        double ms = (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency / frames;
+        if (threads == 1) singleMs = ms;
+        printf("%10d %12.3f %9.2fx\n", threads, ms, singleMs / ms);
+    }
+
+    freeSoftRaster();
+    freeShapes();
+    freeGeometry();
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(surface);
+    free(reference);
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../files.h/formEvents.h"
+#include "../files.h/geometry.h"
+#include "../files.h/softRaster.h"
+#include "benchShapes.h"
+
+// Size of the offscreen target the scene is rendered into
+#define BENCH_WIDTH 1280
+#define BENCH_HEIGHT 720
+
+/**
+ * @brief Renders the current scene a number of times with the given back-end.
+ *
+ * @param renderer The offscreen renderer.
+ * @param path The back-end to use.
+ * @param frames Number of frames to render.
+ * @param stats Receives the counters of the last frame.
+ * @return The average frame time in milliseconds.
+ */
+static double timeFrames(SDL_Renderer *renderer, RenderPath path, int frames, RenderStats *stats) {
+    double frequency = (double)SDL_GetPerformanceFrequency();
+    setRenderPath(path);
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int f = 0; f < frames; f++) {
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+        renderAllShapes(renderer);
+    }
+    *stats = getRenderStats();
+    return (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency / frames;
+}
+
+/**
+ * @brief Measures the average time of renderAllShapes as the scene grows.
+ *
+ * Renders into a software renderer bound to an offscreen surface, so no window
+ * or display is needed. The gfx, geometry and software back-ends are measured.
+ * Usage: renderBench [maxShapes] [framesPerStep]
+ */
+int main(int argc, char *argv[]) {
+    int maxShapes = argc > 1 ? atoi(argv[1]) : 20000;
+    int frames = argc > 2 ? atoi(argv[2]) : 20;
+    if (maxShapes <= 0 || frames <= 0) {
+        printf("Usage: %s [maxShapes] [framesPerStep]\n", argv[0]);
+        return 1;
+    }
+
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, BENCH_WIDTH, BENCH_HEIGHT, 32, SDL_PIXELFORMAT_RGBA8888);
+    SDL_Renderer *renderer = surface ? SDL_CreateSoftwareRenderer(surface) : NULL;
+    if (!renderer) {
+        printf("Failed to create the offscreen renderer: %s\n", SDL_GetError());
+        if (surface) SDL_FreeSurface(surface);
+        return 1;
+    }
+
+    srand(42);
+
+    printf("%10s %14s %14s %12s %14s\n", "shapes", "gfx (ms)", "geometry (ms)", "geo calls", "software (ms)");
+    for (int count = 100; count <= maxShapes; count *= 2) {
+        while (shapeCount < count) {
+            addShape(randomBenchShape(shapeCount, BENCH_WIDTH, BENCH_HEIGHT, 44, BENCH_SHAPES_BASIC));
+        }
+
+        // Shuffle a few layers at each step, as an editing session would
+        for (int i = 0; i < shapeCount; i += shapeCount / 8 + 1) {
+            shapes[i].selected = true;
+            moveShapeUp();
+            shapes[i].selected = false;
+        }
+
+        RenderStats gfxStats, geometryStats, softwareStats;
+        double gfxMs = timeFrames(renderer, RENDER_GFX, frames, &gfxStats);
+        double geometryMs = timeFrames(renderer, RENDER_GEOMETRY, frames, &geometryStats);
+        double softwareMs = timeFrames(renderer, RENDER_SOFTWARE, frames, &softwareStats);
+
+        printf("%10d %14.3f %14.3f %12d %14.3f\n", shapeCount,
+               gfxMs, geometryMs, geometryStats.drawCalls, softwareMs);
+    }
+
+    freeSoftRaster();
+    freeShapes();
+    freeGeometry();
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(surface);
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL2_gfxPrimitives.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "../files.h/spanFill.h"
+
+// Size of the offscreen target the shapes are filled into
+#define BENCH_WIDTH 1280
+#define BENCH_HEIGHT 720
+
+// Shapes filled by the benchmark, each with an SDL2_gfx equivalent
+typedef enum {
+    BENCH_CIRCLE,
+    BENCH_ELLIPSE,
+    BENCH_PIE,
+    BENCH_POLYGON,
+    BENCH_SHAPE_COUNT
+} BenchShape;
+
+static const char *shapeNames[BENCH_SHAPE_COUNT] = {"circle", "ellipse", "pie", "polygon"};
+
+/**
+ * @brief Fills one shape of the given size, with SDL2_gfx or with spans.
+ */
+static void fillShape(SDL_Renderer *renderer, BenchShape shape, int size, bool spans) {
+    SDL_Color color = {200, 120, 40, 160};
+    int x = BENCH_WIDTH / 2, y = BENCH_HEIGHT / 2;
+    Sint16 vx[12], vy[12];
+    SDL_FPoint points[12];
+    for (int i = 0; i < 12; i++) {
+        vx[i] = x + size * cos(i * 2 * M_PI / 12);
+        vy[i] = y + size * sin(i * 2 * M_PI / 12);
+        points[i] = (SDL_FPoint){vx[i], vy[i]};
+    }
+
+    if (!spans) {
+        switch (shape) {
+            case BENCH_CIRCLE: filledCircleRGBA(renderer, x, y, size, color.r, color.g, color.b, color.a); break;
+            case BENCH_ELLIPSE: filledEllipseRGBA(renderer, x, y, size, size / 2, color.r, color.g, color.b, color.a); break;
+            case BENCH_PIE: filledPieRGBA(renderer, x, y, size, 30, 250, color.r, color.g, color.b, color.a); break;
+            default: filledPolygonRGBA(renderer, vx, vy, 12, color.r, color.g, color.b, color.a); break;
+        }
+        return;
+    }
+
+    SpanList list = {0};
+    switch (shape) {
+        case BENCH_CIRCLE: pushCircleSpans(&list, x, y, size); break;
+        case BENCH_ELLIPSE: pushEllipseSpans(&list, x, y, size, size / 2); break;
+        case BENCH_PIE: pushPieSpans(&list, x, y, size, 30, 250); break;
+        default: pushConvexSpans(&list, points, 12); break;
+    }
+    fillSpans(renderer, list.items, list.count, color);
+    free(list.items);
+}
+
+/**
+ * @brief Returns the average time of one fill, in microseconds.
+ */
+static double timeFill(SDL_Renderer *renderer, BenchShape shape, int size, bool spans, int iterations) {
+    double frequency = (double)SDL_GetPerformanceFrequency();
+    fillShape(renderer, shape, size, spans);  // Creates the span texture outside of the timing
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < iterations; i++) {
+        fillShape(renderer, shape, size, spans);
+    }
+    return (SDL_GetPerformanceCounter() - start) * 1e6 / frequency / iterations;
+}
+
+/**
+ * @brief Compares the SDL2_gfx filled primitives with the span fills at every
+ *        span writer level, for small and large shapes.
+ *
+ * Both run on a software renderer bound to an offscreen surface.
+ * Usage: spanBench [iterations]
+ */
+int main(int argc, char *argv[]) {
+    int iterations = argc > 1 ? atoi(argv[1]) : 200;
+    if (iterations <= 0) {
+        printf("Usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, BENCH_WIDTH, BENCH_HEIGHT, 32, SDL_PIXELFORMAT_RGBA32);
+    SDL_Renderer *renderer = surface ? SDL_CreateSoftwareRenderer(surface) : NULL;
+    if (!renderer) {
+        printf("Failed to create the offscreen renderer: %s\n", SDL_GetError());
+        if (surface) SDL_FreeSurface(surface);
+        return 1;
+    }
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+
+    int bestLevel = setSpanKernels(KERNEL_AVX2);
+    const int sizes[] = {20, 300};
+
+    printf("%10s %6s %12s", "shape", "size", "gfx (us)");
+    for (int level = KERNEL_SCALAR; level <= bestLevel; level++) {
+        printf(" %9s (us)", getKernelLevelName((KernelLevel)level));
+    }
+    printf("\n");
+
+    for (int shape = 0; shape < BENCH_SHAPE_COUNT; shape++) {
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            printf("%10s %6d %12.2f", shapeNames[shape], sizes[s],
+                   timeFill(renderer, (BenchShape)shape, sizes[s], false, iterations));
+            for (int level = KERNEL_SCALAR; level <= bestLevel; level++) {
+                setSpanKernels((KernelLevel)level);
+                printf(" %14.2f", timeFill(renderer, (BenchShape)shape, sizes[s], true, iterations));
+            }
+            printf("\n");
+        }
+    }
+
+    freeSpanFill();
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(surface);
+    return 0;
+}
@@ -0,0 +1,31 @@
+#ifndef ANIMATION_KERNELS_H
+#define ANIMATION_KERNELS_H
+
+#include "kernelLevel.h"
+
+// Zoom animation limits, shared by the per-shape and the lane paths
+#define ZOOM_MIN 0.5f
+#define ZOOM_MAX 1.5f
+#define ANIMATION_MAX_STEP (1.0f / 60.0f)  // Longest bounce integration step, in seconds
+
+// Bounce lane arrays, one entry per bouncing shape
+typedef struct {
+    float *vx, *vy;                   // Velocities in pixels per second
+    float *remX, *remY;               // Sub-pixel movement not applied yet
+    float *minX, *minY, *maxX, *maxY; // Shape box, moved along with the shape
+    float *dx, *dy;                   // Out: whole pixels moved during the call
+} BounceLanes;
+
+// One update function per animation type, each advancing a whole lane by delta
+typedef struct {
+    void (*rotate)(float *angle, int count, float delta);
+    void (*zoom)(float *phase, float *zoom, float *direction, int count, float delta);
+    void (*color)(float *phase, float *r, float *g, float *b, int count, float delta);
+    void (*bounce)(const BounceLanes *lanes, int count, float dt, float width, float height);
+} AnimationKernels;
+
+KernelLevel setAnimationKernels(KernelLevel level);
+KernelLevel getAnimationKernelLevel(void);
+const AnimationKernels* getAnimationKernels(void);
+
+#endif // ANIMATION_KERNELS_H
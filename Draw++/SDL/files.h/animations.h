@@ -7,11 +7,16 @@
 // Animation functions
 void applyAnimation(Shape *shape);
 void unapplyAnimation(Shape *shape);
-void animation_rotate(Shape *shape, AnimationType animation);
-void animation_zoom(Shape *shape, AnimationType animation);
-void animation_color(Shape *shape, AnimationType animation);
-void animation_bounce(Shape *shape, AnimationType animation, int width, int height);
+void animation_rotate(Shape *shape, AnimationType animation, float dt);
+void animation_zoom(Shape *shape, AnimationType animation, float dt);
+void animation_color(Shape *shape, AnimationType animation, float dt);
+void animation_bounce(Shape *shape, AnimationType animation, int width, int height, float dt);
 void apply_zoom_to_shape(Shape *shape, float zoom, AnimationType animation);
-void updateAnimations(Shape *shapes, int shapeCount, int windowWidth, int windowHeight);
+void updateAnimations(Shape *shapes, int shapeCount, int windowWidth, int windowHeight, float deltaTime);
+
+// Vectorized path over the shape store, used by the runtime
+void updateAnimationLanes(int windowWidth, int windowHeight, float deltaTime);
+void invalidateAnimationLanes(void);
+void freeAnimationLanes(void);
 
 #endif // ANIMATIONS_H
\ No newline at end of file
@@ -3,6 +3,26 @@
 
 #include <SDL2/SDL.h>
 
+// Color values, usable in static initializers like the generated draw tables
+#define COLOR_RED {255, 0, 0, 255}
+#define COLOR_BLUE {0, 0, 255, 255}
+#define COLOR_GREEN {0, 255, 0, 255}
+#define COLOR_YELLOW {255, 255, 0, 255}
+#define COLOR_MAGENTA {255, 0, 255, 255}
+#define COLOR_CYAN {0, 255, 255, 255}
+#define COLOR_DARK_GRAY {100, 100, 100, 255}
+#define COLOR_GRAY {150, 150, 150, 255}
+#define COLOR_LIGHT_GRAY {200, 200, 200, 255}
+#define COLOR_WHITE {255, 255, 255, 255}
+#define COLOR_BLACK {0, 0, 0, 255}
+#define COLOR_ORANGE {255, 165, 0, 255}
+#define COLOR_PURPLE {128, 0, 128, 255}
+#define COLOR_BROWN {165, 42, 42, 255}
+#define COLOR_PINK {255, 192, 203, 255}
+#define COLOR_GOLD {255, 215, 0, 255}
+#define COLOR_SILVER {192, 192, 192, 255}
+#define COLOR_BRONZE {205, 127, 50, 255}
+
 // External color variables declaration
 extern SDL_Color red;
 extern SDL_Color blue;
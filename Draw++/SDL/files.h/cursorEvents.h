@@ -13,6 +13,10 @@ typedef struct {
     bool selected;  // Indicates whether the shape is selected
 } Circle;
 
+// Called by mainLoop once per frame, after the events and before rendering. It may
+// change the background color the loop clears the scene with.
+typedef void (*FrameHook)(SDL_Window *window, SDL_Renderer *renderer, SDL_Color *background, void *userdata);
+
 
 int handleEvents(SDL_Renderer* renderer, SDL_Texture* texture);
 Cursor createCursor(int x, int y, SDL_Color color, int thickness, bool visible);
@@ -27,6 +31,7 @@ void renderLastKeyPressed(SDL_Renderer *renderer, TTF_Font *font, int bgR, int b
 void handleShapeDeletion(int cursorX, int cursorY);
 void cleanup(SDL_Texture* texture, SDL_Renderer* renderer, SDL_Window* window);
 
+void setFrameHook(FrameHook hook, void *userdata);
 void mainLoop(SDL_Window *window, SDL_Renderer *renderer, SDL_Event event, Cursor cursor, int bgcolorR, int bgcolorG, int bgcolorB);
 
 extern char lastKeyPressed[32];  // Buffer to store the last pressed key
@@ -0,0 +1,13 @@
+#ifndef DAMAGE_H
+#define DAMAGE_H
+
+#include <SDL2/SDL.h>
+
+#define DAMAGE_MAX_RECTS 16         // Further regions are merged into the closest one
+#define DAMAGE_FULL_PERCENT 60      // Above this share of the window, the whole scene is redrawn
+
+void invalidateDamage(void);
+int renderDamagedScene(SDL_Renderer *renderer, SDL_Color background);
+void freeDamage(void);
+
+#endif // DAMAGE_H
@@ -6,38 +6,54 @@
 #include "formEvents.h"
 #define PI 3.14159265
 
-int drawCircle(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, int radius, SDL_Color color, char *type);
+int drawCircle(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, int radius, SDL_Color color, FormType type);
 
-int drawEllipse(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, int rx, int ry, SDL_Color color, char *type);
+int drawEllipse(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, int rx, int ry, SDL_Color color, FormType type);
 
-int drawArc(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, int radius, int start_angle, int end_angle, SDL_Color color, char *type);
+int drawArc(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, int radius, int start_angle, int end_angle, SDL_Color color, FormType type);
 
-int drawRectangle(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, int w, int h, SDL_Color color, char *type);
+int drawRectangle(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, int w, int h, SDL_Color color, FormType type);
 
-int drawPolygon(SDL_Renderer *renderer, SDL_Texture *texture, Sint16 *vx, Sint16 *vy, int n, SDL_Color color, char *type);
+int drawPolygon(SDL_Renderer *renderer, SDL_Texture *texture, Sint16 *vx, Sint16 *vy, int n, SDL_Color color, FormType type);
 
-int drawCustomPolygon(SDL_Renderer *renderer, SDL_Texture *texture, Sint16 cx, Sint16 cy, int radius, int sides, SDL_Color color, char *type);
+int drawCustomPolygon(SDL_Renderer *renderer, SDL_Texture *texture, Sint16 cx, Sint16 cy, int radius, int sides, SDL_Color color, FormType type);
 
-int drawLine(SDL_Renderer *renderer, SDL_Texture *texture, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint8 width, SDL_Color color, char *type);
+int drawLine(SDL_Renderer *renderer, SDL_Texture *texture, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint8 width, SDL_Color color, FormType type);
 
-int drawTriangle(SDL_Renderer *renderer, SDL_Texture *texture, Sint16 cx, Sint16 cy, int radius, SDL_Color color, char *type);
+int drawTriangle(SDL_Renderer *renderer, SDL_Texture *texture, Sint16 cx, Sint16 cy, int radius, SDL_Color color, FormType type);
 
 
-int drawAnimatedTriangle(SDL_Renderer *renderer, SDL_Texture *texture, int cx, int cy, int radius, SDL_Color color, char *type);
+int drawAnimatedTriangle(SDL_Renderer *renderer, SDL_Texture *texture, int cx, int cy, int radius, SDL_Color color, FormType type);
 
-int drawAnimatedCircle(SDL_Renderer* renderer, SDL_Texture *texture, int x, int y, int radius, SDL_Color color, char *type);
+int drawAnimatedCircle(SDL_Renderer* renderer, SDL_Texture *texture, int x, int y, int radius, SDL_Color color, FormType type);
 
-int drawAnimatedRectangle(SDL_Renderer* renderer, SDL_Texture *texture, int x, int y, int w, int h, SDL_Color color, char *type);
+int drawAnimatedRectangle(SDL_Renderer* renderer, SDL_Texture *texture, int x, int y, int w, int h, SDL_Color color, FormType type);
 
-int drawAnimatedEllipse(SDL_Renderer* renderer, SDL_Texture *texture, int x, int y, int rx, int ry, SDL_Color color, char *type);
+int drawAnimatedEllipse(SDL_Renderer* renderer, SDL_Texture *texture, int x, int y, int rx, int ry, SDL_Color color, FormType type);
 
-int drawAnimatedArc(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, int radius, int start_angle, int end_angle, SDL_Color color, char *type);
+int drawAnimatedArc(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, int radius, int start_angle, int end_angle, SDL_Color color, FormType type);
 
-int drawAnimatedCustomPolygon(SDL_Renderer *renderer, SDL_Texture *texture, int cx, int cy, int radius, int sides, SDL_Color color, char *type);
+int drawAnimatedCustomPolygon(SDL_Renderer *renderer, SDL_Texture *texture, int cx, int cy, int radius, int sides, SDL_Color color, FormType type);
 
-int drawAnimatedLine(SDL_Renderer *renderer, SDL_Texture *texture, int x1, int y1, int x2, int y2, int thickness, SDL_Color color, char *type);
+int drawAnimatedLine(SDL_Renderer *renderer, SDL_Texture *texture, int x1, int y1, int x2, int y2, int thickness, SDL_Color color, FormType type);
 
 
-int drawShape(SDL_Renderer *renderer, SDL_Texture *texture, char *shape, char *mode, char *type, SDL_Color color, ...);
+int drawShape(SDL_Renderer *renderer, SDL_Texture *texture, ShapeType shape, DrawMode mode, FormType type, SDL_Color color, ...);
+
+// Typed description of a draw, what drawShape reads out of its varargs
+#define SHAPE_DESC_ARGS 5
+typedef struct {
+    ShapeType shape;
+    DrawMode mode;
+    FormType type;
+    SDL_Color color;
+    int args[SHAPE_DESC_ARGS];   // In drawShape order, unused ones are 0
+} ShapeDesc;
+
+// Flags of drawShapes
+#define DRAW_SHAPES_DEFAULT 0
+#define DRAW_SHAPES_REGISTER_ONLY (1u << 0)   // Register without rasterizing, like a captured scene
+
+int drawShapes(SDL_Renderer *renderer, SDL_Texture *texture, const ShapeDesc *descs, size_t n, Uint32 flags);
 
 #endif
\ No newline at end of file
@@ -8,22 +8,58 @@
 #include "cursorEvents.h"
 #include "form.h"
 
-// Declaration of the list of shapes and its counter
-#define MAX_SHAPES 100
-extern Shape shapes[MAX_SHAPES];
+// Stable reference to a shape in the store. The generation is bumped every time
+// the slot is released, so a handle to a deleted shape never resolves again.
+typedef struct {
+    Uint32 slot;
+    Uint32 generation;
+} ShapeHandle;
+
+#define NULL_SHAPE_HANDLE ((ShapeHandle){0, 0})
+
+// Instant draws are presented one by one with a delay unless batching is enabled
+#define DRAW_BATCH_OFF -1
+
+// Dense, growable view of the shape store: iterate shapes[0..shapeCount).
+// Deleting swaps the last shape into the freed index, so loops that delete
+// must walk backwards (or hold ShapeHandles instead of indices).
+extern Shape *shapes;
 extern int shapeCount;
 
 void setRenderColor(SDL_Renderer* renderer, SDL_Color color);
 SDL_Color selectColor(SDL_Color color);
 
 int renderTexture(SDL_Renderer* renderer, SDL_Texture* texture, int time);
+int presentInstantDraw(SDL_Renderer* renderer, SDL_Texture* texture);
+void setDrawBatch(int cadence);
+int getDrawBatch(void);
+int parseDrawBatchArgs(int argc, char *argv[]);
+void setDrawCapture(bool capture);
+bool isDrawCaptured(void);
 void renderShape(SDL_Renderer *renderer, Shape *shape);
 void renderAllShapes(SDL_Renderer *renderer);
-void addShape(Shape shape);
+void renderShapesInRect(SDL_Renderer *renderer, const SDL_Rect *area);
+void renderShapeRange(SDL_Renderer *renderer, const SDL_Rect *area, int first, int last);
+Shape* getShapeInDrawOrder(int position);
+ShapeHandle addShape(Shape shape);
+int addShapes(const Shape *source, int count);
 void deleteShape(int index);
+bool removeShape(ShapeHandle handle);
+int removeShapes(const ShapeHandle *handles, int count);
+Shape* getShape(ShapeHandle handle);
+int getShapeIndex(ShapeHandle handle);
+ShapeHandle getShapeHandle(int index);
+void replaceShapes(const Shape *source, int count);
+void restackShapes(const ShapeHandle *handles, int count);
+void freeShapes(void);
 void zoomShape(Shape *shape, float zoomFactor);
 void rotateShape(Shape *shape, float angle);
 
+bool getShapeBounds(const Shape *shape, int *minX, int *minY, int *maxX, int *maxY);
+bool getShapeDrawBounds(const Shape *shape, SDL_Rect *bounds);
+void updateShapeInGrid(Shape *shape);
+int queryShapesAt(int x, int y, const int **indices);
+
 void moveShapesWithMouse(Shape *shapes, int shapeCount, SDL_Event *event, Cursor *cursor);
 void moveSelectedShapes(Shape *shapes, int shapeCount, int dx, int dy);
 
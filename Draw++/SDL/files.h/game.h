@@ -10,6 +10,7 @@
 #include "form.h"
 #include "animations.h"
 #include "colors.h"
+#include "spatialGrid.h"
 
 // Game types
 typedef enum {
@@ -37,20 +38,24 @@ typedef struct {
     bool hasShapes;
     float winMessageTimer;
     bool gameJustEnded;
-    Shape savedShapes[MAX_SHAPES];
+    Shape *savedShapes;      // Snapshot of the scene taken when the game starts
     int savedShapeCount;
+    int savedShapeCapacity;
     GameType currentGame;
     // Defense mode specific
     EnemyShape enemies[50];  // Array of enemy shapes
     int enemyCount;          // Current number of enemies
     float spawnTimer;        // Timer for enemy spawning
     int basesRemaining;      // Number of bases (original shapes) still alive
+    SpatialGrid baseGrid;    // Collision boxes of the bases, built once per round
+    ShapeHandle *baseHandles;  // Base of each grid key
+    int baseHandleCapacity;
 } GameState;
 
 // Function prototypes
 void initGame(GameState* game);
 void updateGame(GameState* game, float deltaTime, int cursorX, int cursorY, SDL_Window* window, SDL_Renderer* renderer);
-void renderGameUI(SDL_Renderer* renderer, TTF_Font* font, GameState* game, int bgR, int bgG, int bgB);
+void renderGameUI(SDL_Renderer* renderer, GameState* game, int bgR, int bgG, int bgB);
 void restoreShapes(GameState* game);  // Restore shapes to original positions
 void resetShapes(GameState* game, SDL_Window* window, SDL_Renderer* renderer);    // Reset shapes to random positions
 void escapeRun(GameState* game, int cursorX, int cursorY);  // Run the escape game logic
@@ -61,8 +66,6 @@ void initDefenseMode(GameState* game);
 void updateDefenseGame(GameState* game, float deltaTime, int cursorX, int cursorY, SDL_Window* window, SDL_Renderer* renderer);
 void renderDefenseGame(SDL_Renderer* renderer, GameState* game);
 void spawnEnemy(GameState* game, SDL_Window* window, SDL_Renderer* renderer);
-
-extern Shape shapes[];
-extern int shapeCount;
+void freeGame(GameState* game);
 
 #endif /* GAME_H */
\ No newline at end of file
@@ -0,0 +1,42 @@
+#ifndef GEOMETRY_H
+#define GEOMETRY_H
+
+#include <SDL2/SDL.h>
+#include "main.h"
+
+// Back-ends available to renderAllShapes
+typedef enum {
+    RENDER_GFX,         // One SDL2_gfx call per primitive (default)
+    RENDER_GEOMETRY,    // All shapes tessellated into a shared buffer, sent with SDL_RenderGeometry
+    RENDER_SOFTWARE,    // Same tessellation, rasterized on the CPU by tiles, see softRaster.h
+    RENDER_PATH_COUNT
+} RenderPath;
+
+// Counters for the last frame drawn by renderAllShapes
+typedef struct {
+    int drawCalls;      // Calls submitted to the renderer, not counting the ones SDL2_gfx makes
+    int gfxPrimitives;  // SDL2_gfx primitives drawn, each one issues several renderer calls
+    int vertices;       // Vertices sent through SDL_RenderGeometry (0 on the gfx path)
+    int triangles;      // Triangles sent through SDL_RenderGeometry (0 on the gfx path)
+    int tessellated;    // Shapes whose cached geometry had to be rebuilt
+} RenderStats;
+
+// Outline of a polygonal shape, as drawn by the gfx path
+typedef struct {
+    const Sint16 *x;
+    const Sint16 *y;
+    int count;
+} ShapeOutline;
+
+void setRenderPath(RenderPath path);
+RenderPath getRenderPath(void);
+const char* getRenderPathName(RenderPath path);
+int parseRenderPath(const char *name, RenderPath *path);
+void setRenderStats(RenderStats stats);
+RenderStats getRenderStats(void);
+
+int getShapeOutline(Shape *shape, bool selection, ShapeOutline *outline);
+void renderShapesGeometry(SDL_Renderer *renderer, const SDL_Rect *area, int first, int last);
+void freeGeometry(void);
+
+#endif // GEOMETRY_H
@@ -0,0 +1,25 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+#define HEADLESS_FPS 60                 // Simulated frame rate when a duration is given in seconds
+#define HEADLESS_DEFAULT_FRAMES 60
+
+// Options of an offscreen run, filled from the command line by parseHeadlessArgs
+typedef struct {
+    bool enabled;                // --headless
+    int frames;                  // --frames N, number of simulated frames
+    const char *imagePath;       // --output FILE, final framebuffer (BMP)
+    const char *timingsPath;     // --timings FILE, per-frame timings (CSV)
+} HeadlessConfig;
+
+extern HeadlessConfig headless;
+
+int parseHeadlessArgs(int argc, char *argv[]);
+int createHeadlessRenderer(int width, int height, SDL_Renderer **renderer);
+int runHeadless(SDL_Renderer *renderer, int bgcolorR, int bgcolorG, int bgcolorB);
+void freeHeadless(void);
+
+#endif // HEADLESS_H
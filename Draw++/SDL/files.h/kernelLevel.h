@@ -0,0 +1,32 @@
+#ifndef KERNEL_LEVEL_H
+#define KERNEL_LEVEL_H
+
+#include <stdbool.h>
+
+// The vector kernels need GCC/Clang target attributes, other compilers get the scalar ones.
+// Sources defining kernels include <immintrin.h> when KERNELS_X86 is set.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define KERNELS_X86 1
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+// Instruction sets the kernels are compiled for, from slowest to fastest
+typedef enum {
+    KERNEL_SCALAR,
+    KERNEL_SSE2,
+    KERNEL_AVX2
+} KernelLevel;
+
+// Level used by one family of kernels, the fastest supported one until it is set
+typedef struct {
+    KernelLevel level;
+    bool selected;
+} KernelSelection;
+
+KernelLevel getSupportedKernelLevel(void);
+const char* getKernelLevelName(KernelLevel level);
+KernelLevel selectKernelLevel(KernelSelection *selection, KernelLevel level);
+KernelLevel getSelectedKernelLevel(KernelSelection *selection);
+
+#endif // KERNEL_LEVEL_H
@@ -29,6 +29,20 @@ typedef enum
     SHAPE_LINE 
 } ShapeType;
 
+// How a shape is drawn, "filled" or "empty" in the scripts
+typedef enum
+{
+    FORM_EMPTY,
+    FORM_FILLED
+} FormType;
+
+// How a draw appears, "instant" or "animated" in the scripts
+typedef enum
+{
+    DRAW_MODE_INSTANT,
+    DRAW_MODE_ANIMATED
+} DrawMode;
+
 typedef enum
 {
     ANIM_NONE,
@@ -45,8 +59,9 @@ typedef struct {
     SDL_Color initial_color;  // Initial color when created
     double rotation;      // Rotation in degrees
     double initial_rotation;  // Initial rotation when created
-    char* typeForm;
+    FormType typeForm;    // Filled or outlined
     int zIndex;          // Z-index for layer ordering
+    bool geometryDirty;  // Position, size or rotation changed since the shape was last tessellated
     AnimationType animations[3];  // List of 3 animations max
     int num_animations;                       // Number of animations currently stored
     AnimationType animation_parser;                  // Current animation
@@ -54,8 +69,11 @@ typedef struct {
     float zoom;                              // Current zoom factor for zoom animation
     float zoom_direction;                     // Direction of zoom animation (1.0 = growing, -1.0 = shrinking)
     float color_phase;    // Phase for color cycling animation (0.0 to 1.0)
-    float bounce_velocity; // Velocity for bounce animation
-    float bounce_direction; // Direction for bounce animation
+    float bounce_velocity; // Horizontal bounce velocity in pixels per second
+    float bounce_direction; // Vertical bounce velocity in pixels per second
+    float bounce_remainder_x; // Sub-pixel bounce movement not applied yet
+    float bounce_remainder_y;
+    float animation_lag;  // Animation time (s) not applied yet, accumulates while the shape is off-screen
     union {
         struct { 
             int x, y, radius;
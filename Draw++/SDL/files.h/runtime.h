@@ -0,0 +1,14 @@
+#ifndef RUNTIME_H
+#define RUNTIME_H
+
+// Headers of libdpp_runtime used by the generated code, the only ones it includes.
+// The library is built once (make runtime), each script only compiles .to_run.c against it.
+#include "main.h"
+#include "colors.h"
+#include "cursorEvents.h"
+#include "form.h"
+#include "headless.h"
+#include "snapshot.h"
+#include "sceneHost.h"
+
+#endif // RUNTIME_H
@@ -0,0 +1,61 @@
+#ifndef SCENEHOST_H
+#define SCENEHOST_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include "main.h"
+#include "formEvents.h"
+
+#define SCENE_MODULE_SYMBOL "dppModule"   // Exported by .to_run.c compiled with -DDPP_MODULE
+#define SCENE_MODULE_POLL 250             // Milliseconds between two checks of the module file
+
+// Runs the user instructions of a script, drawShape registers what they draw
+typedef int (*SceneFunction)(SDL_Window *window, SDL_Renderer *renderer, SDL_Texture *mainTexture);
+
+// What the main function of a compiled program sets up, exported by its scene module
+typedef struct {
+    int windowW, windowH;
+    int bgcolorR, bgcolorG, bgcolorB;
+    SDL_Color cursorColor;
+    int cursorSize;
+    int drawBatch;
+    const char *title;
+    Uint64 programHash;
+    SceneFunction scene;
+} SceneModule;
+
+// What a draw of the scene created: shape type, form, color and drawShape arguments.
+// Two draws with the same definition are the same shape of the script.
+#define SCENE_DEFINITION_SIZE 8
+typedef struct {
+    int values[SCENE_DEFINITION_SIZE];
+    Uint32 hash;
+} SceneDefinition;
+
+// Long-lived host of a scene module: the window, renderer and font stay alive and
+// the scene is reloaded whenever the module file is rebuilt
+typedef struct {
+    const char *path;          // Scene module, replaced (not rewritten) by each build
+    SDL_Texture *texture;      // Main texture the first load draws into
+    SceneModule config;        // Of the last load, the title points into titleBuffer
+    char titleBuffer[256];
+
+    // File identity of the last load, any change means a new build
+    Uint64 fileId;
+    Sint64 fileTime;
+    Sint64 fileSize;
+    Uint32 lastPoll;
+
+    // Shapes the last load drew, to match against the next one, and the handles
+    // of the shapes in the store that stand for them
+    SceneDefinition *definitions;
+    ShapeHandle *handles;
+    int count;
+} SceneHost;
+
+int loadSceneConfig(SceneHost *host);
+int loadScene(SceneHost *host, SDL_Window *window, SDL_Renderer *renderer, bool capture);
+void reloadSceneIfChanged(SDL_Window *window, SDL_Renderer *renderer, SDL_Color *background, void *userdata);
+void freeSceneHost(SceneHost *host);
+
+#endif // SCENEHOST_H
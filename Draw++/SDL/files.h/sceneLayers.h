@@ -0,0 +1,12 @@
+#ifndef SCENE_LAYERS_H
+#define SCENE_LAYERS_H
+
+#include <SDL2/SDL.h>
+
+#define SCENE_LAYERS_MIN_SHAPES 64      // Smaller scenes are cheaper to draw directly
+
+void invalidateSceneLayers(void);
+int renderSceneLayers(SDL_Renderer *renderer, const SDL_Rect *area);
+void freeSceneLayers(void);
+
+#endif // SCENE_LAYERS_H
@@ -0,0 +1,24 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include "main.h"
+
+#define SNAPSHOT_VERSION 1                  // Bumped whenever the record layout changes
+#define SNAPSHOT_DEFAULT_PATH "scene.dpps"  // Where the snapshot key saves without --snapshot
+
+// Options of the scene snapshot, filled from the command line by parseSnapshotArgs
+typedef struct {
+    bool enabled;            // --snapshot FILE: restore the scene at startup, save it at exit
+    const char *path;        // File the scene is saved to and restored from
+    Uint64 programHash;      // Program that drew the scene, a snapshot of another one is stale
+} SnapshotConfig;
+
+extern SnapshotConfig snapshot;
+
+int parseSnapshotArgs(int argc, char *argv[]);
+int saveSnapshot(const char *path, const Shape *source, int count);
+int loadSnapshot(const char *path);
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,21 @@
+#ifndef SOFT_RASTER_H
+#define SOFT_RASTER_H
+
+#include <SDL2/SDL.h>
+
+#define RASTER_TILE_SIZE 64         // Side of a screen tile in pixels
+#define RASTER_MAX_THREADS 64       // Upper bound on the threads rasterizing tiles, main thread included
+
+// Triangles of one shape in a geometry batch, as a range of its index buffer
+typedef struct {
+    int firstIndex;
+    int lastIndex;
+} RasterShape;
+
+void setRasterThreads(int threads);
+int getRasterThreads(void);
+int rasterizeShapes(SDL_Renderer *renderer, const SDL_Rect *area, const SDL_Vertex *vertices,
+                    const int *indices, const RasterShape *rasterShapes, int count);
+void freeSoftRaster(void);
+
+#endif // SOFT_RASTER_H
@@ -0,0 +1,33 @@
+#ifndef SPAN_FILL_H
+#define SPAN_FILL_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include "kernelLevel.h"
+
+// Run of pixels x1..x2 (both included) on row y
+typedef struct {
+    int y;
+    int x1, x2;
+} FillSpan;
+
+// Growable list of spans, from top to bottom for every shape below
+typedef struct {
+    FillSpan *items;
+    int count;
+    int capacity;
+} SpanList;
+
+int pushCircleSpans(SpanList *list, int cx, int cy, int radius);
+int pushEllipseSpans(SpanList *list, int cx, int cy, int rx, int ry);
+int pushPieSpans(SpanList *list, int cx, int cy, int radius, double startAngle, double endAngle);
+int pushConvexSpans(SpanList *list, const SDL_FPoint *points, int count);
+int pushRotatedRectSpans(SpanList *list, float cx, float cy, float w, float h, float angle);
+bool isConvexPolygon(const SDL_FPoint *points, int count);
+
+KernelLevel setSpanKernels(KernelLevel level);
+KernelLevel getSpanKernelLevel(void);
+int fillSpans(SDL_Renderer *renderer, const FillSpan *spans, int count, SDL_Color color);
+void freeSpanFill(void);
+
+#endif // SPAN_FILL_H
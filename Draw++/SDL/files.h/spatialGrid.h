@@ -0,0 +1,49 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+#define GRID_CELL_SIZE 64           // Side of a cell in pixels
+#define GRID_MAX_CELLS 64           // Boxes covering more cells are kept in a separate list
+#define GRID_INITIAL_BUCKETS 1024   // Power of two, doubled as the grid fills up
+
+// Growable list of keys
+typedef struct {
+    Uint32 *keys;
+    int count;
+    int capacity;
+} GridList;
+
+// Where a key is stored
+typedef struct {
+    int minX, minY, maxX, maxY;          // Box in pixels, inclusive
+    int minCX, minCY, maxCX, maxCY;      // Cells covered by the box
+    bool inserted;
+    bool oversized;                      // Stored in the oversized list instead of the cells
+    Uint32 stamp;                        // Last query that returned the key
+} GridEntry;
+
+// Uniform grid hashed into buckets: the cells are unbounded, only occupied ones use memory.
+// Keys are small integers (store slots, array indices) chosen by the caller.
+typedef struct {
+    int cellSize;
+    GridList *buckets;
+    int bucketCount;
+    int cellEntries;        // Number of (key, cell) pairs stored in the buckets
+    GridEntry *entries;     // Indexed by key
+    int entryCapacity;
+    GridList oversized;
+    GridList results;       // Output of the last query
+    Uint32 stamp;
+} SpatialGrid;
+
+void initSpatialGrid(SpatialGrid *grid, int cellSize);
+int updateGridBox(SpatialGrid *grid, Uint32 key, int minX, int minY, int maxX, int maxY);
+void removeGridBox(SpatialGrid *grid, Uint32 key);
+int queryGridPoint(SpatialGrid *grid, int x, int y, const Uint32 **keys);
+int queryGridBox(SpatialGrid *grid, int minX, int minY, int maxX, int maxY, const Uint32 **keys);
+void clearSpatialGrid(SpatialGrid *grid);
+void freeSpatialGrid(SpatialGrid *grid);
+
+#endif // SPATIAL_GRID_H
@@ -0,0 +1,14 @@
+#ifndef TEXT_H
+#define TEXT_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+// Glyph atlas text renderer: every printable ASCII glyph of the font is rasterized
+// once into a single texture, strings are drawn as batches of textured quads.
+int initTextAtlas(SDL_Renderer *renderer, TTF_Font *font);
+void freeTextAtlas(void);
+void getTextSize(const char *text, float scale, int wrapWidth, int *w, int *h);
+void renderText(SDL_Renderer *renderer, const char *text, int x, int y, SDL_Color color, float scale, int wrapWidth);
+
+#endif // TEXT_H
@@ -0,0 +1,73 @@
+#ifndef VM_H
+#define VM_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+// Bytecode written by COMPILATOR/src/bytecode.py, keep both in sync
+#define BYTECODE_MAGIC "DPPB"
+#define BYTECODE_VERSION 1
+
+#define VM_STACK_SIZE 4096   // Values, shared by the frames' variables and the expressions
+#define VM_MAX_FRAMES 256    // Nested function calls
+
+typedef enum {
+    OP_INT,             // i32 value
+    OP_FLOAT,           // f64 value
+    OP_STRING,          // u16 string index
+    OP_LOAD,            // u16 slot
+    OP_STORE,           // u16 slot
+    OP_ADD,
+    OP_SUB,
+    OP_MUL,
+    OP_DIV,
+    OP_EQ,
+    OP_NE,
+    OP_LT,
+    OP_GT,
+    OP_LE,
+    OP_GE,
+    OP_AND,
+    OP_OR,
+    OP_JUMP,            // u32 address
+    OP_JUMP_IF_FALSE,   // u32 address
+    OP_CALL,            // u16 function
+    OP_RETURN,
+    OP_POP,
+    OP_DRAW             // u8 shape, u8 flags, u16 color name string, u8 argument count
+} Opcode;
+
+#define DRAW_ANIMATED 1   // Flags of OP_DRAW
+#define DRAW_FILLED 2
+
+// Entry of the function table, function 0 is the main program
+typedef struct {
+    Uint32 entry;        // Offset in the code
+    Uint16 paramCount;   // First slots of the frame
+    Uint16 slotCount;
+} BytecodeFunction;
+
+// Program loaded from a bytecode file, with the configuration the C translation puts in defines
+typedef struct {
+    Uint64 programHash;            // Identifies the program for snapshots
+    int windowW, windowH;
+    int bgcolorR, bgcolorG, bgcolorB;
+    SDL_Color cursorColor;
+    int cursorSize;
+    int drawBatch;
+    const char *title;
+
+    BytecodeFunction *functions;
+    int functionCount;
+    char **strings;
+    int stringCount;
+    const Uint8 *code;
+    Uint32 codeSize;
+    Uint8 *data;                   // Whole file, code points into it
+} Bytecode;
+
+int loadBytecode(const char *path, Bytecode *program);
+int runBytecode(const Bytecode *program, SDL_Renderer *renderer, SDL_Texture *mainTexture);
+void freeBytecode(Bytecode *program);
+
+#endif // VM_H
@@ -0,0 +1,79 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+
+#include "../files.h/runtime.h"
+
+// ANSI escape codes for colors
+#define RED_COLOR "-#red "
+
+/**
+ * @brief Runs a scene module and reloads it every time it is rebuilt.
+ *
+ * The module is .to_run.c compiled with -DDPP_MODULE as a shared object (make module).
+ * The window, renderer and font are created once: a rebuilt module only replaces the
+ * shapes that changed. Built once with the runtime library (make host).
+ * Usage: dpphost MODULE [--batch N]
+ */
+int main(int argc, char *argv[]) {
+    SDL_Window *window = NULL;
+    SDL_Renderer *renderer = NULL;
+    SDL_Event event;
+    SDL_Texture* mainTexture = NULL;
+    SceneHost host = {0};
+
+    if (argc < 2) {
+        printf("%sExecutionError: Usage: %s MODULE [--batch N]\n", RED_COLOR, argv[0]);
+        return -1;
+    }
+    host.path = argv[1];
+    if (loadSceneConfig(&host) != 0) return -1;
+    SceneModule *config = &host.config;
+
+    setDrawBatch(config->drawBatch);
+    if (parseDrawBatchArgs(argc, argv) != 0) return -1;
+    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS) != 0) {
+        printf("%sExecutionError: Failed to initialize SDL.\n", RED_COLOR);
+        return -1;
+    }
+    if (SDL_CreateWindowAndRenderer(config->windowW, config->windowH, SDL_WINDOW_RESIZABLE, &window, &renderer) != 0) {
+        printf("%sExecutionError: Failed to create window and renderer.\n", RED_COLOR);
+        SDL_Quit();
+        return -1;
+    }
+    SDL_Surface* icon = SDL_LoadBMP("IDE/Dpp_circle.bmp");
+    if (icon) {
+        SDL_SetWindowIcon(window, icon);
+        SDL_FreeSurface(icon);
+    }
+    SDL_SetWindowTitle(window, config->title);
+
+    mainTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, config->windowW, config->windowH);
+    if (!mainTexture || SDL_SetRenderTarget(renderer, mainTexture) != 0) {
+        printf("%sExecutionError: Failed to create main texture.\n", RED_COLOR);
+        cleanup(mainTexture, renderer, window);
+        return -1;
+    }
+    SDL_SetRenderDrawColor(renderer, config->bgcolorR, config->bgcolorG, config->bgcolorB, 255);
+    SDL_RenderClear(renderer);
+    Cursor cursor = createCursor(config->windowW / 2, config->windowH / 2, config->cursorColor, config->cursorSize, true);
+
+    // The first load draws like a compiled program, the next ones only update the store
+    host.texture = mainTexture;
+    if (loadScene(&host, window, renderer, false) != 0) {
+        cleanup(mainTexture, renderer, window);
+        freeSceneHost(&host);
+        return -1;
+    }
+
+    SDL_SetRenderTarget(renderer, NULL);
+    SDL_RenderCopy(renderer, mainTexture, NULL, NULL);
+    SDL_RenderPresent(renderer);
+
+    setFrameHook(reloadSceneIfChanged, &host);
+    mainLoop(window, renderer, event, cursor, config->bgcolorR, config->bgcolorG, config->bgcolorB);
+    setFrameHook(NULL, NULL);
+
+    cleanup(mainTexture, renderer, window);
+    freeSceneHost(&host);
+    return 0;
+}
@@ -0,0 +1,334 @@
+#include "../files.h/animationKernels.h"
+#include <math.h>
+#include <stdbool.h>
+
+#ifdef KERNELS_X86
+#include <immintrin.h>
+#endif
+
+#define ZOOM_RANGE (ZOOM_MAX - ZOOM_MIN)
+
+/*
+ * Every kernel exists in three versions that give the same results: wrapping uses
+ * the truncated quotient (phases never go negative) and movement truncates to whole
+ * pixels, so the scalar version is also the tail of the vector ones.
+ */
+
+// Scalar kernels
+
+static void rotateScalar(float *angle, int count, float delta) {
+    for (int i = 0; i < count; i++) {
+        float a = angle[i] + delta;
+        angle[i] = a - (float)(int)(a * (1.0f / 360.0f)) * 360.0f;
+    }
+}
+
+static void zoomScalar(float *phase, float *zoom, float *direction, int count, float delta) {
+    for (int i = 0; i < count; i++) {
+        // Position on the triangle wave: growing below ZOOM_RANGE, shrinking above
+        float p = phase[i] + delta;
+        p -= (float)(int)(p * (1.0f / (2 * ZOOM_RANGE))) * (2 * ZOOM_RANGE);
+        phase[i] = p;
+        zoom[i] = (p < ZOOM_RANGE) ? ZOOM_MIN + p : ZOOM_MAX + ZOOM_RANGE - p;
+        direction[i] = (p < ZOOM_RANGE) ? 1.0f : -1.0f;
+    }
+}
+
+static void colorScalar(float *phase, float *r, float *g, float *b, int count, float delta) {
+    for (int i = 0; i < count; i++) {
+        float p = phase[i] + delta;
+        p -= (float)(int)p;
+        phase[i] = p;
+
+        // HSV to RGB at full saturation and value, without branching on the sector
+        float h = p * 6.0f;
+        r[i] = fminf(fmaxf(fabsf(h - 3.0f) - 1.0f, 0.0f), 1.0f);
+        g[i] = fminf(fmaxf(2.0f - fabsf(h - 2.0f), 0.0f), 1.0f);
+        b[i] = fminf(fmaxf(2.0f - fabsf(h - 4.0f), 0.0f), 1.0f);
+    }
+}
+
+/**
+ * @brief Moves one bouncing shape per lane by dt, in steps of at most ANIMATION_MAX_STEP.
+ *
+ * @param start Index of the first lane to update, the vector kernels use it for their tail.
+ */
+static void bounceRange(const BounceLanes *lanes, int start, int count, float dt, float width, float height) {
+    for (int i = start; i < count; i++) {
+        float vx = lanes->vx[i], vy = lanes->vy[i];
+        float minX = lanes->minX[i], minY = lanes->minY[i], maxX = lanes->maxX[i], maxY = lanes->maxY[i];
+        float dx = 0, dy = 0;
+
+        for (float left = dt; left > 0; left -= ANIMATION_MAX_STEP) {
+            float step = fminf(left, ANIMATION_MAX_STEP);
+            float moveX = lanes->remX[i] + vx * step;
+            float moveY = lanes->remY[i] + vy * step;
+            float stepX = (float)(int)moveX, stepY = (float)(int)moveY;
+            lanes->remX[i] = moveX - stepX;
+            lanes->remY[i] = moveY - stepY;
+
+            minX += stepX; maxX += stepX; dx += stepX;
+            minY += stepY; maxY += stepY; dy += stepY;
+
+            // Reverse only when heading into a boundary, so a shape past it comes back
+            if ((minX <= 0 && vx < 0) || (maxX >= width && vx > 0)) vx = -vx;
+            if ((minY <= 0 && vy < 0) || (maxY >= height && vy > 0)) vy = -vy;
+        }
+
+        lanes->vx[i] = vx; lanes->vy[i] = vy;
+        lanes->minX[i] = minX; lanes->minY[i] = minY;
+        lanes->maxX[i] = maxX; lanes->maxY[i] = maxY;
+        lanes->dx[i] = dx; lanes->dy[i] = dy;
+    }
+}
+
+static void bounceScalar(const BounceLanes *lanes, int count, float dt, float width, float height) {
+    bounceRange(lanes, 0, count, dt, width, height);
+}
+
+#ifdef KERNELS_X86
+
+// SSE2 kernels, 4 lanes per iteration
+
+TARGET_SSE2 static inline __m128 truncSSE2(__m128 v) {
+    return _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+}
+
+TARGET_SSE2 static inline __m128 selectSSE2(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+TARGET_SSE2 static inline __m128 clamp01SSE2(__m128 v) {
+    return _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+}
+
+TARGET_SSE2 static inline __m128 absSSE2(__m128 v) {
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+}
+
+TARGET_SSE2 static void rotateSSE2(float *angle, int count, float delta) {
+    const __m128 d = _mm_set1_ps(delta), turn = _mm_set1_ps(360.0f), inv = _mm_set1_ps(1.0f / 360.0f);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 a = _mm_add_ps(_mm_loadu_ps(angle + i), d);
+        a = _mm_sub_ps(a, _mm_mul_ps(truncSSE2(_mm_mul_ps(a, inv)), turn));
+        _mm_storeu_ps(angle + i, a);
+    }
+    rotateScalar(angle + i, count - i, delta);
+}
+
+TARGET_SSE2 static void zoomSSE2(float *phase, float *zoom, float *direction, int count, float delta) {
+    const __m128 d = _mm_set1_ps(delta), range = _mm_set1_ps(ZOOM_RANGE);
+    const __m128 period = _mm_set1_ps(2 * ZOOM_RANGE), inv = _mm_set1_ps(1.0f / (2 * ZOOM_RANGE));
+    const __m128 growBase = _mm_set1_ps(ZOOM_MIN), shrinkBase = _mm_set1_ps(ZOOM_MAX + ZOOM_RANGE);
+    const __m128 one = _mm_set1_ps(1.0f), minusOne = _mm_set1_ps(-1.0f);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 p = _mm_add_ps(_mm_loadu_ps(phase + i), d);
+        p = _mm_sub_ps(p, _mm_mul_ps(truncSSE2(_mm_mul_ps(p, inv)), period));
+        __m128 growing = _mm_cmplt_ps(p, range);
+        _mm_storeu_ps(phase + i, p);
+        _mm_storeu_ps(zoom + i, selectSSE2(growing, _mm_add_ps(growBase, p), _mm_sub_ps(shrinkBase, p)));
+        _mm_storeu_ps(direction + i, selectSSE2(growing, one, minusOne));
+    }
+    zoomScalar(phase + i, zoom + i, direction + i, count - i, delta);
+}
+
+TARGET_SSE2 static void colorSSE2(float *phase, float *r, float *g, float *b, int count, float delta) {
+    const __m128 d = _mm_set1_ps(delta), six = _mm_set1_ps(6.0f);
+    const __m128 one = _mm_set1_ps(1.0f), two = _mm_set1_ps(2.0f);
+    const __m128 three = _mm_set1_ps(3.0f), four = _mm_set1_ps(4.0f);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 p = _mm_add_ps(_mm_loadu_ps(phase + i), d);
+        p = _mm_sub_ps(p, truncSSE2(p));
+        _mm_storeu_ps(phase + i, p);
+
+        __m128 h = _mm_mul_ps(p, six);
+        _mm_storeu_ps(r + i, clamp01SSE2(_mm_sub_ps(absSSE2(_mm_sub_ps(h, three)), one)));
+        _mm_storeu_ps(g + i, clamp01SSE2(_mm_sub_ps(two, absSSE2(_mm_sub_ps(h, two)))));
+        _mm_storeu_ps(b + i, clamp01SSE2(_mm_sub_ps(two, absSSE2(_mm_sub_ps(h, four)))));
+    }
+    colorScalar(phase + i, r + i, g + i, b + i, count - i, delta);
+}
+
+/**
+ * @brief Flips the velocities of the lanes heading into a boundary.
+ */
+TARGET_SSE2 static inline __m128 reflectSSE2(__m128 v, __m128 min, __m128 max, __m128 limit) {
+    const __m128 zero = _mm_setzero_ps();
+    __m128 hit = _mm_or_ps(_mm_and_ps(_mm_cmple_ps(min, zero), _mm_cmplt_ps(v, zero)),
+                           _mm_and_ps(_mm_cmpge_ps(max, limit), _mm_cmpgt_ps(v, zero)));
+    return _mm_xor_ps(v, _mm_and_ps(hit, _mm_set1_ps(-0.0f)));
+}
+
+TARGET_SSE2 static void bounceSSE2(const BounceLanes *lanes, int count, float dt, float width, float height) {
+    const __m128 w = _mm_set1_ps(width), h = _mm_set1_ps(height);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 vx = _mm_loadu_ps(lanes->vx + i), vy = _mm_loadu_ps(lanes->vy + i);
+        __m128 remX = _mm_loadu_ps(lanes->remX + i), remY = _mm_loadu_ps(lanes->remY + i);
+        __m128 minX = _mm_loadu_ps(lanes->minX + i), minY = _mm_loadu_ps(lanes->minY + i);
+        __m128 maxX = _mm_loadu_ps(lanes->maxX + i), maxY = _mm_loadu_ps(lanes->maxY + i);
+        __m128 dx = _mm_setzero_ps(), dy = _mm_setzero_ps();
+
+        for (float left = dt; left > 0; left -= ANIMATION_MAX_STEP) {
+            __m128 step = _mm_set1_ps(fminf(left, ANIMATION_MAX_STEP));
+            __m128 moveX = _mm_add_ps(remX, _mm_mul_ps(vx, step));
+            __m128 moveY = _mm_add_ps(remY, _mm_mul_ps(vy, step));
+            __m128 stepX = truncSSE2(moveX), stepY = truncSSE2(moveY);
+            remX = _mm_sub_ps(moveX, stepX);
+            remY = _mm_sub_ps(moveY, stepY);
+
+            minX = _mm_add_ps(minX, stepX); maxX = _mm_add_ps(maxX, stepX); dx = _mm_add_ps(dx, stepX);
+            minY = _mm_add_ps(minY, stepY); maxY = _mm_add_ps(maxY, stepY); dy = _mm_add_ps(dy, stepY);
+
+            vx = reflectSSE2(vx, minX, maxX, w);
+            vy = reflectSSE2(vy, minY, maxY, h);
+        }
+
+        _mm_storeu_ps(lanes->vx + i, vx); _mm_storeu_ps(lanes->vy + i, vy);
+        _mm_storeu_ps(lanes->remX + i, remX); _mm_storeu_ps(lanes->remY + i, remY);
+        _mm_storeu_ps(lanes->minX + i, minX); _mm_storeu_ps(lanes->minY + i, minY);
+        _mm_storeu_ps(lanes->maxX + i, maxX); _mm_storeu_ps(lanes->maxY + i, maxY);
+        _mm_storeu_ps(lanes->dx + i, dx); _mm_storeu_ps(lanes->dy + i, dy);
+    }
+    bounceRange(lanes, i, count, dt, width, height);
+}
+
+// AVX2 kernels, 8 lanes per iteration
+
+TARGET_AVX2 static inline __m256 truncAVX2(__m256 v) {
+    return _mm256_round_ps(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+}
+
+TARGET_AVX2 static inline __m256 clamp01AVX2(__m256 v) {
+    return _mm256_min_ps(_mm256_max_ps(v, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+}
+
+TARGET_AVX2 static inline __m256 absAVX2(__m256 v) {
+    return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v);
+}
+
+TARGET_AVX2 static void rotateAVX2(float *angle, int count, float delta) {
+    const __m256 d = _mm256_set1_ps(delta), turn = _mm256_set1_ps(360.0f), inv = _mm256_set1_ps(1.0f / 360.0f);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 a = _mm256_add_ps(_mm256_loadu_ps(angle + i), d);
+        a = _mm256_sub_ps(a, _mm256_mul_ps(truncAVX2(_mm256_mul_ps(a, inv)), turn));
+        _mm256_storeu_ps(angle + i, a);
+    }
+    rotateScalar(angle + i, count - i, delta);
+}
+
+TARGET_AVX2 static void zoomAVX2(float *phase, float *zoom, float *direction, int count, float delta) {
+    const __m256 d = _mm256_set1_ps(delta), range = _mm256_set1_ps(ZOOM_RANGE);
+    const __m256 period = _mm256_set1_ps(2 * ZOOM_RANGE), inv = _mm256_set1_ps(1.0f / (2 * ZOOM_RANGE));
+    const __m256 growBase = _mm256_set1_ps(ZOOM_MIN), shrinkBase = _mm256_set1_ps(ZOOM_MAX + ZOOM_RANGE);
+    const __m256 one = _mm256_set1_ps(1.0f), minusOne = _mm256_set1_ps(-1.0f);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 p = _mm256_add_ps(_mm256_loadu_ps(phase + i), d);
+        p = _mm256_sub_ps(p, _mm256_mul_ps(truncAVX2(_mm256_mul_ps(p, inv)), period));
+        __m256 growing = _mm256_cmp_ps(p, range, _CMP_LT_OQ);
+        _mm256_storeu_ps(phase + i, p);
+        _mm256_storeu_ps(zoom + i, _mm256_blendv_ps(_mm256_sub_ps(shrinkBase, p), _mm256_add_ps(growBase, p), growing));
+        _mm256_storeu_ps(direction + i, _mm256_blendv_ps(minusOne, one, growing));
+    }
+    zoomScalar(phase + i, zoom + i, direction + i, count - i, delta);
+}
+
+TARGET_AVX2 static void colorAVX2(float *phase, float *r, float *g, float *b, int count, float delta) {
+    const __m256 d = _mm256_set1_ps(delta), six = _mm256_set1_ps(6.0f);
+    const __m256 one = _mm256_set1_ps(1.0f), two = _mm256_set1_ps(2.0f);
+    const __m256 three = _mm256_set1_ps(3.0f), four = _mm256_set1_ps(4.0f);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 p = _mm256_add_ps(_mm256_loadu_ps(phase + i), d);
+        p = _mm256_sub_ps(p, truncAVX2(p));
+        _mm256_storeu_ps(phase + i, p);
+
+        __m256 h = _mm256_mul_ps(p, six);
+        _mm256_storeu_ps(r + i, clamp01AVX2(_mm256_sub_ps(absAVX2(_mm256_sub_ps(h, three)), one)));
+        _mm256_storeu_ps(g + i, clamp01AVX2(_mm256_sub_ps(two, absAVX2(_mm256_sub_ps(h, two)))));
+        _mm256_storeu_ps(b + i, clamp01AVX2(_mm256_sub_ps(two, absAVX2(_mm256_sub_ps(h, four)))));
+    }
+    colorScalar(phase + i, r + i, g + i, b + i, count - i, delta);
+}
+
+TARGET_AVX2 static inline __m256 reflectAVX2(__m256 v, __m256 min, __m256 max, __m256 limit) {
+    const __m256 zero = _mm256_setzero_ps();
+    __m256 hit = _mm256_or_ps(_mm256_and_ps(_mm256_cmp_ps(min, zero, _CMP_LE_OQ), _mm256_cmp_ps(v, zero, _CMP_LT_OQ)),
+                              _mm256_and_ps(_mm256_cmp_ps(max, limit, _CMP_GE_OQ), _mm256_cmp_ps(v, zero, _CMP_GT_OQ)));
+    return _mm256_xor_ps(v, _mm256_and_ps(hit, _mm256_set1_ps(-0.0f)));
+}
+
+TARGET_AVX2 static void bounceAVX2(const BounceLanes *lanes, int count, float dt, float width, float height) {
+    const __m256 w = _mm256_set1_ps(width), h = _mm256_set1_ps(height);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 vx = _mm256_loadu_ps(lanes->vx + i), vy = _mm256_loadu_ps(lanes->vy + i);
+        __m256 remX = _mm256_loadu_ps(lanes->remX + i), remY = _mm256_loadu_ps(lanes->remY + i);
+        __m256 minX = _mm256_loadu_ps(lanes->minX + i), minY = _mm256_loadu_ps(lanes->minY + i);
+        __m256 maxX = _mm256_loadu_ps(lanes->maxX + i), maxY = _mm256_loadu_ps(lanes->maxY + i);
+        __m256 dx = _mm256_setzero_ps(), dy = _mm256_setzero_ps();
+
+        for (float left = dt; left > 0; left -= ANIMATION_MAX_STEP) {
+            __m256 step = _mm256_set1_ps(fminf(left, ANIMATION_MAX_STEP));
+            __m256 moveX = _mm256_add_ps(remX, _mm256_mul_ps(vx, step));
+            __m256 moveY = _mm256_add_ps(remY, _mm256_mul_ps(vy, step));
+            __m256 stepX = truncAVX2(moveX), stepY = truncAVX2(moveY);
+            remX = _mm256_sub_ps(moveX, stepX);
+            remY = _mm256_sub_ps(moveY, stepY);
+
+            minX = _mm256_add_ps(minX, stepX); maxX = _mm256_add_ps(maxX, stepX); dx = _mm256_add_ps(dx, stepX);
+            minY = _mm256_add_ps(minY, stepY); maxY = _mm256_add_ps(maxY, stepY); dy = _mm256_add_ps(dy, stepY);
+
+            vx = reflectAVX2(vx, minX, maxX, w);
+            vy = reflectAVX2(vy, minY, maxY, h);
+        }
+
+        _mm256_storeu_ps(lanes->vx + i, vx); _mm256_storeu_ps(lanes->vy + i, vy);
+        _mm256_storeu_ps(lanes->remX + i, remX); _mm256_storeu_ps(lanes->remY + i, remY);
+        _mm256_storeu_ps(lanes->minX + i, minX); _mm256_storeu_ps(lanes->minY + i, minY);
+        _mm256_storeu_ps(lanes->maxX + i, maxX); _mm256_storeu_ps(lanes->maxY + i, maxY);
+        _mm256_storeu_ps(lanes->dx + i, dx); _mm256_storeu_ps(lanes->dy + i, dy);
+    }
+    bounceRange(lanes, i, count, dt, width, height);
+}
+
+#endif // KERNELS_X86
+
+static const AnimationKernels kernelTable[] = {
+    [KERNEL_SCALAR] = {rotateScalar, zoomScalar, colorScalar, bounceScalar},
+#ifdef KERNELS_X86
+    [KERNEL_SSE2] = {rotateSSE2, zoomSSE2, colorSSE2, bounceSSE2},
+    [KERNEL_AVX2] = {rotateAVX2, zoomAVX2, colorAVX2, bounceAVX2},
+#endif
+};
+
+static KernelSelection animationKernels = {KERNEL_SCALAR, false};
+
+/**
+ * @brief Selects the kernels used by the animation lanes, see selectKernelLevel.
+ *
+ * @param level The requested instruction set.
+ * @return The level actually selected.
+ */
+KernelLevel setAnimationKernels(KernelLevel level) {
+    return selectKernelLevel(&animationKernels, level);
+}
+
+/**
+ * @brief Returns the level of the kernels in use, selecting the fastest one on first use.
+ */
+KernelLevel getAnimationKernelLevel(void) {
+    return getSelectedKernelLevel(&animationKernels);
+}
+
+/**
+ * @brief Returns the kernels in use, selecting the fastest ones on first use.
+ */
+const AnimationKernels* getAnimationKernels(void) {
+    return &kernelTable[getAnimationKernelLevel()];
+}
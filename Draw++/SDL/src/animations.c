@@ -1,6 +1,16 @@
 #include "../files.h/animations.h"
+#include "../files.h/animationKernels.h"
 #include <math.h>
 
+// ANSI escape codes for colors
+#define RED_COLOR "-#red "
+
+// Animation speeds, matching the former per-frame steps at 60 FPS
+#define ROTATE_SPEED 240.0f      // Degrees per second
+#define ZOOM_SPEED 1.5f          // Zoom factor change per second
+#define COLOR_SPEED 0.54f        // Color cycles per second
+#define BOUNCE_SPEED 1200.0f     // Pixels per second on each axis
+
 /**
  * @brief Applies or removes an animation to/from a shape
  * 
@@ -33,6 +43,7 @@ void applyAnimation(Shape *shape) {
     if (check == 0) {
         shape->animations[shape->num_animations] = shape->animation_parser;
         shape->num_animations++;
+        invalidateAnimationLanes();
     }
 }
 
@@ -69,154 +80,113 @@ void unapplyAnimation(Shape *shape) {
             shape->animations[i + 1] = ANIM_NONE;
         }
     }
+    invalidateAnimationLanes();
+}
+
+/**
+ * @brief Tells whether a shape may cover part of the window.
+ *
+ * The box is padded by its largest side so that rotation and zoom (up to 1.5x from
+ * the smallest size) never make a shape reported as hidden visible on screen.
+ */
+static bool isShapeOnScreen(const Shape *shape, int width, int height) {
+    int minX, minY, maxX, maxY;
+    if (!getShapeBounds(shape, &minX, &minY, &maxX, &maxY)) return true;
+
+    int margin = (int)fmax(maxX - minX, maxY - minY);
+    return maxX + margin >= 0 && minX - margin <= width &&
+           maxY + margin >= 0 && minY - margin <= height;
 }
 
 /**
  * @brief Applies a bouncing animation to a shape
  * 
  * Implements a DVD logo style bouncing animation where the shape moves at a constant
- * velocity and bounces off the window boundaries. The movement is slowed down by
- * only updating every 7 frames.
+ * velocity (BOUNCE_SPEED on each axis) and bounces off the window boundaries. The
+ * movement is integrated over dt in steps of at most one 60 FPS frame, so the speed
+ * does not depend on the frame rate and long frames cannot skip over a wall.
  * 
  * @param shape Pointer to the shape to animate
  * @param animation The type of animation being applied
  * @param width The window width for boundary checking
  * @param height The window height for boundary checking
+ * @param dt Elapsed time in seconds
  */
-void animation_bounce(Shape *shape, AnimationType animation, int width, int height) {
-    static const float velocity = 20.0f;  // Base velocity
-
+void animation_bounce(Shape *shape, AnimationType animation, int width, int height, float dt) {
     // Initialize velocities if not set
     if (shape->bounce_velocity == 0 && shape->bounce_direction == 0) {
-        shape->bounce_velocity = velocity;  // Initial x velocity
-        shape->bounce_direction = velocity; // Initial y velocity
+        shape->bounce_velocity = BOUNCE_SPEED;  // Initial x velocity
+        shape->bounce_direction = BOUNCE_SPEED; // Initial y velocity
     }
 
-    // Move the shape
-    moveShape(shape, (int)shape->bounce_velocity, (int)shape->bounce_direction);
+    int minX, minY, maxX, maxY;
+    if (!getShapeBounds(shape, &minX, &minY, &maxX, &maxY)) return;
 
-    // Check and handle boundary collisions based on shape type
-    switch (shape->type) {
-        case SHAPE_CIRCLE: {
-            if (shape->data.circle.x - shape->data.circle.radius <= 0 || 
-                shape->data.circle.x + shape->data.circle.radius >= width) {
-                shape->bounce_velocity *= -1;  // Reverse x direction
-            }
-            if (shape->data.circle.y - shape->data.circle.radius <= 0 || 
-                shape->data.circle.y + shape->data.circle.radius >= height) {
-                shape->bounce_direction *= -1;  // Reverse y direction
-            }
-            break;
-        }
-        case SHAPE_RECTANGLE: {
-            if (shape->data.rectangle.x <= 0 || 
-                shape->data.rectangle.x + shape->data.rectangle.width >= width) {
-                shape->bounce_velocity *= -1;
-            }
-            if (shape->data.rectangle.y <= 0 || 
-                shape->data.rectangle.y + shape->data.rectangle.height >= height) {
-                shape->bounce_direction *= -1;
-            }
-            break;
-        }
+    while (dt > 0) {
+        float step = fminf(dt, ANIMATION_MAX_STEP);
+        dt -= step;
 
-        case SHAPE_LINE: {
-            // Move both endpoints of the line
-            shape->data.line.x1 += (int)shape->bounce_velocity;
-            shape->data.line.y1 += (int)shape->bounce_direction;
-            shape->data.line.x2 += (int)shape->bounce_velocity;
-            shape->data.line.y2 += (int)shape->bounce_direction;
-
-            // Check for collision with window boundaries
-            // Horizontal collision
-            if (shape->data.line.x1 <= 0 || shape->data.line.x2 <= 0 || 
-                shape->data.line.x1 >= width || shape->data.line.x2 >= width) {
-                shape->bounce_velocity *= -1;  // Reverse horizontal direction
-            }
+        // Move by whole pixels, keeping the fraction for the next step
+        float moveX = shape->bounce_remainder_x + shape->bounce_velocity * step;
+        float moveY = shape->bounce_remainder_y + shape->bounce_direction * step;
+        int dx = (int)moveX, dy = (int)moveY;
+        shape->bounce_remainder_x = moveX - dx;
+        shape->bounce_remainder_y = moveY - dy;
+        moveShape(shape, dx, dy);
 
-            // Vertical collision
-            if (shape->data.line.y1 <= 0 || shape->data.line.y2 <= 0 || 
-                shape->data.line.y1 >= height || shape->data.line.y2 >= height) {
-                shape->bounce_direction *= -1;  // Reverse vertical direction
-            }
-            break;
-        }
+        minX += dx; maxX += dx;
+        minY += dy; maxY += dy;
 
-        case SHAPE_SQUARE: {
-            if (shape->data.square.x <= 0 || 
-                shape->data.square.x + shape->data.square.c >= width) {
-                shape->bounce_velocity *= -1;
-            }
-            if (shape->data.square.y <= 0 || 
-                shape->data.square.y + shape->data.square.c >= height) {
-                shape->bounce_direction *= -1;
-            }
-            break;
-        }
-        case SHAPE_ELLIPSE: {
-            if (shape->data.ellipse.x - shape->data.ellipse.rx <= 0 || 
-                shape->data.ellipse.x + shape->data.ellipse.rx >= width) {
-                shape->bounce_velocity *= -1;
-            }
-            if (shape->data.ellipse.y - shape->data.ellipse.ry <= 0 || 
-                shape->data.ellipse.y + shape->data.ellipse.ry >= height) {
-                shape->bounce_direction *= -1;
-            }
-            break;
+        // Reverse only when heading into a boundary, so a shape past it comes back
+        if ((minX <= 0 && shape->bounce_velocity < 0) || (maxX >= width && shape->bounce_velocity > 0)) {
+            shape->bounce_velocity *= -1;
         }
-        case SHAPE_POLYGON:
-        case SHAPE_TRIANGLE: {
-            if (shape->data.polygon.cx - shape->data.polygon.radius <= 0 || 
-                shape->data.polygon.cx + shape->data.polygon.radius >= width) {
-                shape->bounce_velocity *= -1;
-            }
-            if (shape->data.polygon.cy - shape->data.polygon.radius <= 0 || 
-                shape->data.polygon.cy + shape->data.polygon.radius >= height) {
-                shape->bounce_direction *= -1;
-            }
-            break;
+        if ((minY <= 0 && shape->bounce_direction < 0) || (maxY >= height && shape->bounce_direction > 0)) {
+            shape->bounce_direction *= -1;
         }
-        default:
-            break;
     }
 }
 
 /**
  * @brief Applies a rotation animation to a shape
  * 
- * Rotates the shape by 0.15 degrees per frame. The rotation wraps around
+ * Rotates the shape by ROTATE_SPEED degrees per second. The rotation wraps around
  * at 360 degrees back to 0.
  * 
  * @param shape Pointer to the shape to animate
  * @param animation The type of animation being applied
+ * @param dt Elapsed time in seconds
  */
-void animation_rotate(Shape *shape, AnimationType animation) {
-    shape->rotation += 4;  // Increment rotation by 0.15 degrees
-    if (shape->rotation >= 360.0f) {
-        shape->rotation = 0.0f;  // Wrap around at 360 degrees
-    }
+void animation_rotate(Shape *shape, AnimationType animation, float dt) {
+    shape->rotation = fmod(shape->rotation + ROTATE_SPEED * dt, 360.0);
+    shape->geometryDirty = true;
 }
 
 /**
  * @brief Applies a zoom animation to a shape
  * 
  * Creates a pulsing effect by scaling the shape between 50% and 150%
- * of its original size. The zoom direction reverses at these limits.
+ * of its original size at ZOOM_SPEED per second. The zoom is evaluated on
+ * the triangle wave between these limits, so any dt is applied in O(1).
  * 
  * @param shape Pointer to the shape to animate
  * @param animation The type of animation being applied
+ * @param dt Elapsed time in seconds
  */
-void animation_zoom(Shape *shape, AnimationType animation) {
-    // Update zoom value using shape's own direction (slower speed)
-    shape->zoom += 0.025f * shape->zoom_direction;
-    
-    // Check bounds and reverse direction if needed
-    if (shape->zoom >= 1.5f) {
-        shape->zoom = 1.5f;
-        shape->zoom_direction = -1.0f;
-    } else if (shape->zoom <= 0.5f) {
-        shape->zoom = 0.5f;
+void animation_zoom(Shape *shape, AnimationType animation, float dt) {
+    const float range = ZOOM_MAX - ZOOM_MIN;
+
+    // Position on the wave: [0, range) while growing, [range, 2 * range) while shrinking
+    float zoom = fminf(fmaxf(shape->zoom, ZOOM_MIN), ZOOM_MAX);
+    float phase = (shape->zoom_direction > 0) ? zoom - ZOOM_MIN : range + (ZOOM_MAX - zoom);
+    phase = fmodf(phase + ZOOM_SPEED * dt, 2 * range);
+
+    if (phase < range) {
+        shape->zoom = ZOOM_MIN + phase;
         shape->zoom_direction = 1.0f;
+    } else {
+        shape->zoom = ZOOM_MAX - (phase - range);
+        shape->zoom_direction = -1.0f;
     }
     
     apply_zoom_to_shape(shape, shape->zoom, animation);
@@ -233,6 +203,8 @@ void animation_zoom(Shape *shape, AnimationType animation) {
  * @param animation The type of animation being applied
  */
 void apply_zoom_to_shape(Shape *shape, float zoom, AnimationType animation) {
+    shape->geometryDirty = true;
+
     // Apply zoom based on current zoom value
     switch (shape->type) {
         case SHAPE_RECTANGLE: {
@@ -272,6 +244,7 @@ void apply_zoom_to_shape(Shape *shape, float zoom, AnimationType animation) {
             break;
         }
     }
+    updateShapeInGrid(shape);
 }
 
 /**
@@ -279,17 +252,15 @@ void apply_zoom_to_shape(Shape *shape, float zoom, AnimationType animation) {
  * 
  * Creates a rainbow effect by cycling through the HSV color space
  * and converting to RGB for display. The cycle completes when the
- * color phase reaches 1.0.
+ * color phase reaches 1.0, COLOR_SPEED times per second.
  * 
  * @param shape Pointer to the shape to animate
  * @param animation The type of animation being applied
+ * @param dt Elapsed time in seconds
  */
-void animation_color(Shape *shape, AnimationType animation) {
+void animation_color(Shape *shape, AnimationType animation, float dt) {
     // Update the color phase (controls the position in the color cycle)
-    shape->color_phase += 0.009f;
-    if (shape->color_phase >= 1.0f) {
-        shape->color_phase = 0.0f;
-    }
+    shape->color_phase = fmodf(shape->color_phase + COLOR_SPEED * dt, 1.0f);
 
     // Convert HSV to RGB (hue = phase * 360, saturation = 1, value = 1)
     float hue = shape->color_phase * 360.0f;
@@ -325,35 +296,326 @@ void animation_color(Shape *shape, AnimationType animation) {
 /**
  * @brief Updates all active animations for all shapes
  * 
+ * Per-shape reference path, the runtime uses updateAnimationLanes.
  * This function handles the animation updates for all shapes that have active animations.
  * It processes each animation type (rotate, zoom, color, bounce) for each shape.
+ * Rotate, zoom and color are evaluated from the elapsed time: shapes that are off-screen
+ * only accumulate it and catch up in one step once they become visible again.
  * 
  * @param shapes Array of shapes to animate
  * @param shapeCount Number of shapes in the array
  * @param windowWidth Width of the window for bounce animation boundaries
  * @param windowHeight Height of the window for bounce animation boundaries
+ * @param deltaTime Time elapsed since the previous update, in seconds
  */
-void updateAnimations(Shape *shapes, int shapeCount, int windowWidth, int windowHeight) {
+void updateAnimations(Shape *shapes, int shapeCount, int windowWidth, int windowHeight, float deltaTime) {
     for (int i = 0; i < shapeCount; i++) {
-        if (shapes[i].isAnimating) {
-            for (int j = 0; j < shapes[i].num_animations; j++) {
-                switch (shapes[i].animations[j]) {
-                    case ANIM_ROTATE:
-                        animation_rotate(&shapes[i], shapes[i].animations[j]);
-                        break;
-                    case ANIM_ZOOM:
-                        animation_zoom(&shapes[i], shapes[i].animations[j]);
-                        break;
-                    case ANIM_COLOR:
-                        animation_color(&shapes[i], shapes[i].animations[j]);
-                        break;
-                    case ANIM_BOUNCE:
-                        animation_bounce(&shapes[i], shapes[i].animations[j], windowWidth, windowHeight);
-                        break;
-                    default:
-                        break;
+        Shape *shape = &shapes[i];
+        if (!shape->isAnimating) continue;
+
+        // Bouncing moves the shape, so it is integrated every frame
+        float dt = shape->animation_lag + deltaTime;
+        for (int j = 0; j < shape->num_animations; j++) {
+            if (shape->animations[j] == ANIM_BOUNCE) {
+                animation_bounce(shape, shape->animations[j], windowWidth, windowHeight, deltaTime);
+            }
+        }
+
+        if (!isShapeOnScreen(shape, windowWidth, windowHeight)) {
+            shape->animation_lag = dt;
+            continue;
+        }
+        shape->animation_lag = 0.0f;
+
+        for (int j = 0; j < shape->num_animations; j++) {
+            switch (shape->animations[j]) {
+                case ANIM_ROTATE:
+                    animation_rotate(shape, shape->animations[j], dt);
+                    break;
+                case ANIM_ZOOM:
+                    animation_zoom(shape, shape->animations[j], dt);
+                    break;
+                case ANIM_COLOR:
+                    animation_color(shape, shape->animations[j], dt);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+}
+
+/*
+ * Animation lanes: the state of every running animation, stored as one array per
+ * field and grouped by animation type, so that each type is updated by a single
+ * vectorized kernel call (see animationKernels.c). Each lane entry points to one of
+ * the animated shapes, which are resolved from their handles and checked for
+ * visibility once per update. The lanes own the animation state while a shape is
+ * animating and write it back to the shape every update, so they are only rebuilt
+ * when the set of animations changes.
+ */
+
+enum { ROTATE_ANGLE, ROTATE_FIELDS };
+enum { ZOOM_PHASE, ZOOM_FACTOR, ZOOM_DIRECTION, ZOOM_FIELDS };
+enum { COLOR_PHASE, COLOR_R, COLOR_G, COLOR_B, COLOR_FIELDS };
+enum { BOUNCE_VX, BOUNCE_VY, BOUNCE_REM_X, BOUNCE_REM_Y, BOUNCE_MIN_X, BOUNCE_MIN_Y,
+       BOUNCE_MAX_X, BOUNCE_MAX_Y, BOUNCE_DX, BOUNCE_DY, BOUNCE_FIELDS };
+
+typedef struct {
+    int *members;                  // Index of the animated shape of each entry
+    float *fields[BOUNCE_FIELDS];  // One array per field, the bounce lane has the most
+    int fieldCount;
+    int count;
+    int capacity;
+} AnimationLane;
+
+typedef struct {
+    ShapeHandle *handles;
+    Shape **shapes;    // Resolved at the start of each update, NULL once deleted or stopped
+    bool *visible;     // Whether the shape is on screen after this update's bounce
+    int count;
+    int capacity;
+} AnimatedShapes;
+
+static AnimatedShapes animated = {0};
+static AnimationLane rotateLane = {.fieldCount = ROTATE_FIELDS};
+static AnimationLane zoomLane = {.fieldCount = ZOOM_FIELDS};
+static AnimationLane colorLane = {.fieldCount = COLOR_FIELDS};
+static AnimationLane bounceLane = {.fieldCount = BOUNCE_FIELDS};
+static bool lanesDirty = true;
+
+/**
+ * @brief Requests a rebuild of the animation lanes before the next update.
+ *
+ * Must be called whenever a shape starts animating, gains or loses an animation, or
+ * has its animation state changed from outside (reset, manual rotation). Shapes that
+ * are deleted or stop animating are detected by the update itself.
+ */
+void invalidateAnimationLanes(void) {
+    lanesDirty = true;
+}
+
+/**
+ * @brief Appends an animated shape, growing the arrays when full.
+ *
+ * @return Index of the new member, or -1 on allocation failure.
+ */
+static int pushAnimatedShape(ShapeHandle handle) {
+    if (animated.count == animated.capacity) {
+        int capacity = animated.capacity ? animated.capacity * 2 : 64;
+
+        ShapeHandle *handles = realloc(animated.handles, capacity * sizeof(ShapeHandle));
+        if (!handles) return -1;
+        animated.handles = handles;
+        Shape **resolved = realloc(animated.shapes, capacity * sizeof(Shape*));
+        if (!resolved) return -1;
+        animated.shapes = resolved;
+        bool *visible = realloc(animated.visible, capacity * sizeof(bool));
+        if (!visible) return -1;
+        animated.visible = visible;
+
+        animated.capacity = capacity;
+    }
+    animated.handles[animated.count] = handle;
+    return animated.count++;
+}
+
+/**
+ * @brief Appends an entry to a lane, growing its arrays when full.
+ *
+ * @return Index of the new entry, or -1 on allocation failure.
+ */
+static int pushLane(AnimationLane *lane, int member) {
+    if (lane->count == lane->capacity) {
+        int capacity = lane->capacity ? lane->capacity * 2 : 64;
+
+        int *members = realloc(lane->members, capacity * sizeof(int));
+        if (!members) return -1;
+        lane->members = members;
+
+        for (int f = 0; f < lane->fieldCount; f++) {
+            float *field = realloc(lane->fields[f], capacity * sizeof(float));
+            if (!field) return -1;
+            lane->fields[f] = field;
+        }
+        lane->capacity = capacity;
+    }
+    lane->members[lane->count] = member;
+    return lane->count++;
+}
+
+/**
+ * @brief Refills the lanes from the animation state of the shapes.
+ */
+static void rebuildAnimationLanes(void) {
+    animated.count = 0;
+    rotateLane.count = zoomLane.count = colorLane.count = bounceLane.count = 0;
+
+    for (int i = 0; i < shapeCount; i++) {
+        Shape *shape = &shapes[i];
+        if (!shape->isAnimating || shape->num_animations == 0) continue;
+
+        int member = pushAnimatedShape(getShapeHandle(i));
+        if (member < 0) goto failed;
+
+        for (int j = 0; j < shape->num_animations; j++) {
+            int k;
+            switch (shape->animations[j]) {
+                case ANIM_ROTATE: {
+                    if ((k = pushLane(&rotateLane, member)) < 0) goto failed;
+                    float angle = fmod(shape->rotation, 360.0);
+                    rotateLane.fields[ROTATE_ANGLE][k] = (angle < 0) ? angle + 360.0f : angle;
+                    break;
+                }
+                case ANIM_ZOOM: {
+                    if ((k = pushLane(&zoomLane, member)) < 0) goto failed;
+                    // Same wave position as animation_zoom
+                    float zoom = fminf(fmaxf(shape->zoom, ZOOM_MIN), ZOOM_MAX);
+                    zoomLane.fields[ZOOM_PHASE][k] = (shape->zoom_direction > 0) ? zoom - ZOOM_MIN
+                                                                                 : (ZOOM_MAX - ZOOM_MIN) + (ZOOM_MAX - zoom);
+                    break;
                 }
+                case ANIM_COLOR:
+                    if ((k = pushLane(&colorLane, member)) < 0) goto failed;
+                    colorLane.fields[COLOR_PHASE][k] = shape->color_phase;
+                    break;
+                case ANIM_BOUNCE:
+                    if ((k = pushLane(&bounceLane, member)) < 0) goto failed;
+                    if (shape->bounce_velocity == 0 && shape->bounce_direction == 0) {
+                        shape->bounce_velocity = BOUNCE_SPEED;
+                        shape->bounce_direction = BOUNCE_SPEED;
+                    }
+                    bounceLane.fields[BOUNCE_VX][k] = shape->bounce_velocity;
+                    bounceLane.fields[BOUNCE_VY][k] = shape->bounce_direction;
+                    bounceLane.fields[BOUNCE_REM_X][k] = shape->bounce_remainder_x;
+                    bounceLane.fields[BOUNCE_REM_Y][k] = shape->bounce_remainder_y;
+                    break;
+                default:
+                    break;
             }
         }
     }
-}
\ No newline at end of file
+    lanesDirty = false;
+    return;
+
+failed:
+    printf("%sExecutionError: Memory allocation failed for the animation lanes\n", RED_COLOR);
+    animated.count = 0;
+    rotateLane.count = zoomLane.count = colorLane.count = bounceLane.count = 0;
+}
+
+/**
+ * @brief Moves the bouncing shapes. The boxes are gathered every update since shapes can be dragged.
+ */
+static void updateBounceLane(const AnimationKernels *kernels, int windowWidth, int windowHeight, float deltaTime) {
+    float **f = bounceLane.fields;
+    for (int i = 0; i < bounceLane.count; i++) {
+        Shape *shape = animated.shapes[bounceLane.members[i]];
+        int minX = 0, minY = 0, maxX = 0, maxY = 0;
+        if (shape) getShapeBounds(shape, &minX, &minY, &maxX, &maxY);
+        f[BOUNCE_MIN_X][i] = minX; f[BOUNCE_MIN_Y][i] = minY;
+        f[BOUNCE_MAX_X][i] = maxX; f[BOUNCE_MAX_Y][i] = maxY;
+    }
+
+    BounceLanes lanes = {f[BOUNCE_VX], f[BOUNCE_VY], f[BOUNCE_REM_X], f[BOUNCE_REM_Y],
+                         f[BOUNCE_MIN_X], f[BOUNCE_MIN_Y], f[BOUNCE_MAX_X], f[BOUNCE_MAX_Y],
+                         f[BOUNCE_DX], f[BOUNCE_DY]};
+    kernels->bounce(&lanes, bounceLane.count, deltaTime, windowWidth, windowHeight);
+
+    for (int i = 0; i < bounceLane.count; i++) {
+        Shape *shape = animated.shapes[bounceLane.members[i]];
+        if (!shape) continue;
+        int dx = (int)f[BOUNCE_DX][i], dy = (int)f[BOUNCE_DY][i];
+        if (dx || dy) moveShape(shape, dx, dy);
+        shape->bounce_velocity = f[BOUNCE_VX][i];
+        shape->bounce_direction = f[BOUNCE_VY][i];
+        shape->bounce_remainder_x = f[BOUNCE_REM_X][i];
+        shape->bounce_remainder_y = f[BOUNCE_REM_Y][i];
+    }
+}
+
+/**
+ * @brief Updates all active animations for all shapes, one lane at a time
+ * 
+ * Same behavior as updateAnimations, computed by the vectorized kernels. Every lane
+ * advances by deltaTime; shapes that are off-screen only get their animation state
+ * written back, their size, color and geometry are refreshed once they are visible.
+ * 
+ * @param windowWidth Width of the window for bounce animation boundaries
+ * @param windowHeight Height of the window for bounce animation boundaries
+ * @param deltaTime Time elapsed since the previous update, in seconds
+ */
+void updateAnimationLanes(int windowWidth, int windowHeight, float deltaTime) {
+    if (lanesDirty) rebuildAnimationLanes();
+    const AnimationKernels *kernels = getAnimationKernels();
+
+    // Shapes deleted or stopped since the last rebuild are skipped, and dropped at the next one
+    for (int m = 0; m < animated.count; m++) {
+        Shape *shape = getShape(animated.handles[m]);
+        if (!shape || !shape->isAnimating) {
+            shape = NULL;
+            lanesDirty = true;
+        }
+        animated.shapes[m] = shape;
+    }
+
+    // Bouncing first, the other animations check visibility at the new position
+    updateBounceLane(kernels, windowWidth, windowHeight, deltaTime);
+    for (int m = 0; m < animated.count; m++) {
+        animated.visible[m] = animated.shapes[m] && isShapeOnScreen(animated.shapes[m], windowWidth, windowHeight);
+    }
+
+    float *angle = rotateLane.fields[ROTATE_ANGLE];
+    kernels->rotate(angle, rotateLane.count, ROTATE_SPEED * deltaTime);
+    for (int i = 0; i < rotateLane.count; i++) {
+        Shape *shape = animated.shapes[rotateLane.members[i]];
+        if (!shape) continue;
+        shape->rotation = angle[i];
+        if (animated.visible[rotateLane.members[i]]) shape->geometryDirty = true;
+    }
+
+    float **zoom = zoomLane.fields;
+    kernels->zoom(zoom[ZOOM_PHASE], zoom[ZOOM_FACTOR], zoom[ZOOM_DIRECTION], zoomLane.count, ZOOM_SPEED * deltaTime);
+    for (int i = 0; i < zoomLane.count; i++) {
+        Shape *shape = animated.shapes[zoomLane.members[i]];
+        if (!shape) continue;
+        shape->zoom = zoom[ZOOM_FACTOR][i];
+        shape->zoom_direction = zoom[ZOOM_DIRECTION][i];
+        if (animated.visible[zoomLane.members[i]]) apply_zoom_to_shape(shape, shape->zoom, ANIM_ZOOM);
+    }
+
+    float **color = colorLane.fields;
+    kernels->color(color[COLOR_PHASE], color[COLOR_R], color[COLOR_G], color[COLOR_B], colorLane.count, COLOR_SPEED * deltaTime);
+    for (int i = 0; i < colorLane.count; i++) {
+        Shape *shape = animated.shapes[colorLane.members[i]];
+        if (!shape) continue;
+        shape->color_phase = color[COLOR_PHASE][i];
+        if (animated.visible[colorLane.members[i]]) {
+            shape->color.r = (Uint8)(color[COLOR_R][i] * 255);
+            shape->color.g = (Uint8)(color[COLOR_G][i] * 255);
+            shape->color.b = (Uint8)(color[COLOR_B][i] * 255);
+        }
+    }
+}
+
+/**
+ * @brief Releases the memory of the animation lanes.
+ */
+void freeAnimationLanes(void) {
+    AnimationLane *lanes[] = {&rotateLane, &zoomLane, &colorLane, &bounceLane};
+    for (int l = 0; l < 4; l++) {
+        free(lanes[l]->members);
+        lanes[l]->members = NULL;
+        for (int f = 0; f < lanes[l]->fieldCount; f++) {
+            free(lanes[l]->fields[f]);
+            lanes[l]->fields[f] = NULL;
+        }
+        lanes[l]->count = lanes[l]->capacity = 0;
+    }
+
+    free(animated.handles);
+    free(animated.shapes);
+    free(animated.visible);
+    animated = (AnimatedShapes){0};
+    lanesDirty = true;
+}
@@ -1,24 +1,24 @@
 #include "../files.h/colors.h"
 
 // Definition of global color variables
-SDL_Color red = {255, 0, 0, 255};
-SDL_Color blue = {0, 0, 255, 255};
-SDL_Color green = {0, 255, 0, 255};
-SDL_Color yellow = {255, 255, 0, 255};
-SDL_Color magenta = {255, 0, 255, 255};
-SDL_Color cyan = {0, 255, 255, 255};
-SDL_Color dark_gray = {100, 100, 100, 255};
-SDL_Color gray = {150, 150, 150, 255};
-SDL_Color light_gray = {200, 200, 200, 255};
-SDL_Color white = {255, 255, 255, 255};
-SDL_Color black = {0, 0, 0, 255};
-SDL_Color orange = {255, 165, 0, 255};
-SDL_Color purple = {128, 0, 128, 255};
-SDL_Color brown = {165, 42, 42, 255};
-SDL_Color pink = {255, 192, 203, 255};
-SDL_Color gold = {255, 215, 0, 255};
-SDL_Color silver = {192, 192, 192, 255};
-SDL_Color bronze = {205, 127, 50, 255}; 
+SDL_Color red = COLOR_RED;
+SDL_Color blue = COLOR_BLUE;
+SDL_Color green = COLOR_GREEN;
+SDL_Color yellow = COLOR_YELLOW;
+SDL_Color magenta = COLOR_MAGENTA;
+SDL_Color cyan = COLOR_CYAN;
+SDL_Color dark_gray = COLOR_DARK_GRAY;
+SDL_Color gray = COLOR_GRAY;
+SDL_Color light_gray = COLOR_LIGHT_GRAY;
+SDL_Color white = COLOR_WHITE;
+SDL_Color black = COLOR_BLACK;
+SDL_Color orange = COLOR_ORANGE;
+SDL_Color purple = COLOR_PURPLE;
+SDL_Color brown = COLOR_BROWN;
+SDL_Color pink = COLOR_PINK;
+SDL_Color gold = COLOR_GOLD;
+SDL_Color silver = COLOR_SILVER;
+SDL_Color bronze = COLOR_BRONZE; 
 
 SDL_Color getInverseColor(int bgR, int bgG, int bgB) {
     SDL_Color inverseColor = {
@@ -9,6 +9,14 @@
 #include "../files.h/animations.h"
 #include "../files.h/colors.h"
 #include "../files.h/game.h"
+#include "../files.h/geometry.h"
+#include "../files.h/text.h"
+#include "../files.h/headless.h"
+#include "../files.h/damage.h"
+#include "../files.h/sceneLayers.h"
+#include "../files.h/softRaster.h"
+#include "../files.h/spanFill.h"
+#include "../files.h/snapshot.h"
 
 // ANSI escape codes for colors
 #define RED_COLOR "-#red "
@@ -21,6 +29,9 @@
 // Definition of the global variable
 char lastKeyPressed[32] = "";
 
+static FrameHook frameHook = NULL;   // See setFrameHook
+static void *frameHookData = NULL;
+
 /**
  * @brief Cleans up SDL resources.
  * 
@@ -35,9 +46,26 @@ void cleanup(SDL_Texture* mainTexture, SDL_Renderer* renderer, SDL_Window* windo
     if (mainTexture) SDL_DestroyTexture(mainTexture);
     if (renderer) SDL_DestroyRenderer(renderer);
     if (window) SDL_DestroyWindow(window);
+    freeShapes();
+    freeGeometry();
+    freeAnimationLanes();
+    freeHeadless();
     SDL_Quit();
 }
 
+/**
+ * @brief Registers a function mainLoop calls once per frame.
+ *
+ * Lets a host update the scene (e.g. reload it) without owning the event loop.
+ *
+ * @param hook Function to call, NULL to remove it.
+ * @param userdata Passed back to the hook.
+ */
+void setFrameHook(FrameHook hook, void *userdata) {
+    frameHook = hook;
+    frameHookData = userdata;
+}
+
 /**
  * @brief Main loop of the application to handle user interactions and render shapes.
  * 
@@ -79,8 +107,15 @@ void mainLoop(SDL_Window *window, SDL_Renderer *renderer, SDL_Event event, Curso
         return;
     }
 
+    // Rasterize the font once, HUD text is then drawn from the atlas
+    if (initTextAtlas(renderer, font) < 0) {
+        TTF_CloseFont(font);
+        TTF_Quit();
+        return;
+    }
+
     // Initialize game state
-    GameState gameState;
+    GameState gameState = {0};
     initGame(&gameState);
     
     Uint32 lastTime = SDL_GetTicks();
@@ -172,61 +207,7 @@ void mainLoop(SDL_Window *window, SDL_Renderer *renderer, SDL_Event event, Curso
                             printf("Toggle selection of shape under cursor\n\n");
                         }
                         strncpy(lastKeyPressed, "e", sizeof(lastKeyPressed) - 1);
-                        int topmostShapeIndex = -1;
-                        // Check if cursor is over any shape, keeping track of the last (topmost) one
-                        for (int i = 0; i < shapeCount; i++) {
-                            bool isInside = false;
-                            switch (shapes[i].type) {
-                                case SHAPE_RECTANGLE:
-                                    isInside = isPointInRectangle(cursor.x, cursor.y,
-                                        shapes[i].data.rectangle.x, shapes[i].data.rectangle.y,
-                                        shapes[i].data.rectangle.width, shapes[i].data.rectangle.height);
-                                    break;
-                                case SHAPE_SQUARE:
-                                    isInside = isPointInSquare(cursor.x, cursor.y,
-                                        shapes[i].data.square.x, shapes[i].data.square.y,
-                                        shapes[i].data.square.c);
-                                    break;
-                                case SHAPE_CIRCLE:
-                                    isInside = isPointInCircle(cursor.x, cursor.y,
-                                        shapes[i].data.circle.x, shapes[i].data.circle.y,
-                                        shapes[i].data.circle.radius);
-                                    break;
-                                case SHAPE_ELLIPSE:
-                                    isInside = isPointInEllipse(cursor.x, cursor.y,
-                                        shapes[i].data.ellipse.x, shapes[i].data.ellipse.y,
-                                        shapes[i].data.ellipse.rx, shapes[i].data.ellipse.ry);
-                                    break;
-                                case SHAPE_LINE:
-                                    isInside = isPointInLine(cursor.x, cursor.y,
-                                        shapes[i].data.line.x1, shapes[i].data.line.y1,
-                                        shapes[i].data.line.x2, shapes[i].data.line.y2,
-                                        shapes[i].data.line.thickness,
-                                        shapes[i].rotation);
-                                    break;
-                                case SHAPE_POLYGON:
-                                    isInside = isPointInPolygon(cursor.x, cursor.y,
-                                        shapes[i].data.polygon.cx, shapes[i].data.polygon.cy,
-                                        shapes[i].data.polygon.radius, shapes[i].data.polygon.sides);
-                                    break;
-                                case SHAPE_TRIANGLE:
-                                    isInside = isPointInTriangle(cursor.x, cursor.y,
-                                        shapes[i].data.triangle.cx, shapes[i].data.triangle.cy,
-                                        shapes[i].data.triangle.radius);
-                                    break;
-                                case SHAPE_ARC:
-                                    isInside = isPointInArc(cursor.x, cursor.y,
-                                        shapes[i].data.arc.x, shapes[i].data.arc.y,
-                                        shapes[i].data.arc.radius,
-                                        shapes[i].data.arc.start_angle,
-                                        shapes[i].data.arc.end_angle);
-                                    break;
-                            }
-                            
-                            if (isInside) {
-                                topmostShapeIndex = i;  // Keep track of the last (topmost) shape found
-                            }
-                        }
+                        int topmostShapeIndex = findShapeAtCursor(cursor.x, cursor.y);
                         
                         // If we found a shape under the cursor
                         if (topmostShapeIndex != -1) {
@@ -251,6 +232,29 @@ void mainLoop(SDL_Window *window, SDL_Renderer *renderer, SDL_Event event, Curso
                             }
                         }
                     }
+                    else if (strcmp(event.text.text, "b") == 0) {
+                        // Cycle through the SDL2_gfx, batched geometry and software renderers
+                        setRenderPath((RenderPath)((getRenderPath() + 1) % RENDER_PATH_COUNT));
+                        invalidateDamage();  // The paths do not draw the same pixels
+                        if (DEBUG) {
+                            RenderStats stats = getRenderStats();
+                            printf("Switch renderer to %s (last frame: %d draw calls, %d gfx primitives, %d triangles)\n\n",
+                                   getRenderPathName(getRenderPath()), stats.drawCalls, stats.gfxPrimitives, stats.triangles);
+                        }
+                        strncpy(lastKeyPressed, "b", sizeof(lastKeyPressed) - 1);
+                    }
+                    else if (strcmp(event.text.text, "w") == 0) {
+                        // Save the scene, the one from before the game when a game is running
+                        if (gameState.isGameMode) {
+                            saveSnapshot(snapshot.path, gameState.savedShapes, gameState.savedShapeCount);
+                        } else {
+                            saveSnapshot(snapshot.path, shapes, shapeCount);
+                        }
+                        if (DEBUG) {
+                            printf("Save the scene to %s\n\n", snapshot.path);
+                        }
+                        strncpy(lastKeyPressed, "w", sizeof(lastKeyPressed) - 1);
+                    }
                     else if (strcmp(event.text.text, "q") == 0) {
                         // Rotate selected shapes counterclockwise
                         if (DEBUG) {
@@ -362,7 +366,9 @@ void mainLoop(SDL_Window *window, SDL_Renderer *renderer, SDL_Event event, Curso
                                     shapes[i].selected = false;
                                     shapes[i].isAnimating = false;
                                     // Reset color to original
-                                    shapes[i].color = gameState.savedShapes[i].color;
+                                    if (i < gameState.savedShapeCount) {
+                                        shapes[i].color = gameState.savedShapes[i].color;
+                                    }
                                 }
                                 initGame(&gameState);
                                 resetShapes(&gameState, window, renderer);
@@ -423,12 +429,6 @@ void mainLoop(SDL_Window *window, SDL_Renderer *renderer, SDL_Event event, Curso
                                 gameState.isGameMode = false;
                                 gameState.isPlaying = false;
                                 gameState.gameJustEnded = false;
-                                // Clean up all enemies
-                                for (int i = 0; i < gameState.enemyCount; i++) {
-                                    if (gameState.enemies[i].shape.typeForm) {
-                                        free(gameState.enemies[i].shape.typeForm);
-                                    }
-                                }
                                 gameState.enemyCount = 0;  // Clear enemies when exiting game mode
                                 restoreShapes(&gameState);
                                 if (DEBUG) printf("Game mode exited!\n");
@@ -519,12 +519,28 @@ void mainLoop(SDL_Window *window, SDL_Renderer *renderer, SDL_Event event, Curso
 
                 case SDL_MOUSEBUTTONDOWN:
                     if (gameState.isPlaying) {
-                        // Check if we clicked on a shape
-                        for (int i = 0; i < shapeCount; i++) {
-                            if (isPointInShape(&shapes[i], event.button.x, event.button.y) && gameState.currentGame == GAME_ESCAPE) {
+                        // Check if we clicked on shapes. Every shape under the click is caught;
+                        // hits are kept as handles since deleting moves the last shape.
+                        if (gameState.currentGame == GAME_ESCAPE) {
+                            const int *candidates;
+                            int count = queryShapesAt(event.button.x, event.button.y, &candidates);
+                            ShapeHandle *hits = malloc((count > 0 ? count : 1) * sizeof(ShapeHandle));
+                            if (!hits) {
+                                printf("%sExecutionError: Memory allocation failed for the clicked shapes\n", RED_COLOR);
+                                break;
+                            }
+
+                            int hitCount = 0;
+                            for (int i = 0; i < count; i++) {
+                                if (isPointInShape(&shapes[candidates[i]], event.button.x, event.button.y)) {
+                                    hits[hitCount++] = getShapeHandle(candidates[i]);
+                                }
+                            }
+                            for (int i = 0; i < hitCount; i++) {
                                 gameState.score += 1;  // Increment by 1 for escape run
-                                deleteShape(i);
+                                removeShape(hits[i]);
                             }
+                            free(hits);
                         }
                     } else {
                         // Existing code for shape selection
@@ -544,22 +560,44 @@ void mainLoop(SDL_Window *window, SDL_Renderer *renderer, SDL_Event event, Curso
                     cursor.y = event.motion.y;
                     moveShapesWithMouse(shapes, shapeCount, &event, &cursor);
                     break;
+
+                case SDL_RENDER_TARGETS_RESET:
+                    // The back buffer and layer contents were lost
+                    invalidateDamage();
+                    invalidateSceneLayers();
+                    break;
+
+                case SDL_RENDER_DEVICE_RESET:
+                    // The back buffer, layers, rasterizer and span fill textures themselves were lost
+                    freeDamage();
+                    freeSceneLayers();
+                    freeSoftRaster();
+                    freeSpanFill();
+                    break;
             }
         }
 
-        // Clear the screen and set a background color.
-        SDL_SetRenderDrawColor(renderer, bgcolorR, bgcolorG, bgcolorB, 255);
-        SDL_RenderClear(renderer);
-
-        // Render all shapes in z-order
-        renderAllShapes(renderer);
+        // Redraw the parts of the scene that changed into the back buffer, then show it
+        SDL_Color background = {bgcolorR, bgcolorG, bgcolorB, 255};
+        if (frameHook) {
+            frameHook(window, renderer, &background, frameHookData);
+            bgcolorR = background.r;
+            bgcolorG = background.g;
+            bgcolorB = background.b;
+        }
+        if (renderDamagedScene(renderer, background) != 0) {
+            // No back buffer: clear the screen and render all shapes in z-order
+            SDL_SetRenderDrawColor(renderer, bgcolorR, bgcolorG, bgcolorB, 255);
+            SDL_RenderClear(renderer);
+            renderAllShapes(renderer);
+        }
 
         // Render the custom cursor
         renderCursor(renderer, &cursor);
 
         if (gameState.isGameMode) {
             // Game mode (active or waiting)
-            renderGameUI(renderer, font, &gameState, bgcolorR, bgcolorG, bgcolorB);
+            renderGameUI(renderer, &gameState, bgcolorR, bgcolorG, bgcolorB);
         } else {
             // Normal mode
             renderCursorCoordinates(renderer, font, cursor.x, cursor.y, bgcolorR, bgcolorG, bgcolorB);
@@ -580,7 +618,7 @@ void mainLoop(SDL_Window *window, SDL_Renderer *renderer, SDL_Event event, Curso
         // Update animations for all shapes
         int windowWidth, windowHeight;
         SDL_GetRendererOutputSize(renderer, &windowWidth, &windowHeight);
-        updateAnimations(shapes, shapeCount, windowWidth, windowHeight);
+        updateAnimationLanes(windowWidth, windowHeight, deltaTime);
 
         // Cap frame rate to 60 FPS
         Uint32 frameEnd = SDL_GetTicks();
@@ -593,6 +631,20 @@ void mainLoop(SDL_Window *window, SDL_Renderer *renderer, SDL_Event event, Curso
         // Present the updated frame
         SDL_RenderPresent(renderer);
     }
+    // With --snapshot, the next run starts from the scene as it is left
+    if (snapshot.enabled) {
+        if (gameState.isGameMode) {
+            saveSnapshot(snapshot.path, gameState.savedShapes, gameState.savedShapeCount);
+        } else {
+            saveSnapshot(snapshot.path, shapes, shapeCount);
+        }
+    }
+    freeGame(&gameState);
+    freeDamage();
+    freeSceneLayers();
+    freeSoftRaster();
+    freeSpanFill();
+    freeTextAtlas();
     TTF_CloseFont(font);
     TTF_Quit();
     SDL_ShowCursor(SDL_ENABLE); // Restore the default system cursor.
@@ -721,15 +773,21 @@ void moveCursor(Cursor *cursor, int dx, int dy) {
  * @param x X-coordinate of the cursor.
  * @param y Y-coordinate of the cursor.
  * 
- * @return The index of the shape under the cursor, or -1 if no shape is found.
+ * @return The index of the topmost shape under the cursor, or -1 if no shape is found.
  */
 int findShapeAtCursor(int x, int y) {
-    // Iterate through all the shapes in the global shapes array.
-    for (int i = 0; i < shapeCount; i++) {
+    int topmost = -1;
+
+    // Only the shapes whose box contains the point, found through the spatial grid.
+    const int *candidates;
+    int count = queryShapesAt(x, y, &candidates);
+    for (int c = 0; c < count; c++) {
+        int i = candidates[c];
         Shape *shape = &shapes[i]; // Get a reference to the current shape.
+        bool hit = false;
 
-        // Validate the shape's type form (it must be "filled" or "empty").
-        if ((strcmp(shape->typeForm, "filled") != 0) && (strcmp(shape->typeForm, "empty") != 0)) {
+        // Validate the shape's type form (it must be filled or empty).
+        if (shape->typeForm != FORM_FILLED && shape->typeForm != FORM_EMPTY) {
             continue; // Skip invalid shapes.
         }
 
@@ -738,39 +796,40 @@ int findShapeAtCursor(int x, int y) {
         {
             // Check if the cursor is inside the circle.
             case SHAPE_CIRCLE:
-                if (isPointInCircle(x, y, shape->data.circle.x, shape->data.circle.y, shape->data.circle.radius)) 
-                return i; // Return the index of the shape.
+                hit = isPointInCircle(x, y, shape->data.circle.x, shape->data.circle.y, shape->data.circle.radius);
                 break;
             case SHAPE_RECTANGLE:
-                if (isPointInRectangle(x, y, shape->data.rectangle.x, shape->data.rectangle.y, shape->data.rectangle.width, shape->data.rectangle.height)) return i;
+                hit = isPointInRectangle(x, y, shape->data.rectangle.x, shape->data.rectangle.y, shape->data.rectangle.width, shape->data.rectangle.height);
                 break;
             case SHAPE_SQUARE:
-                if (isPointInSquare(x, y, shape->data.square.x, shape->data.square.y, shape->data.square.c)) return i;
+                hit = isPointInSquare(x, y, shape->data.square.x, shape->data.square.y, shape->data.square.c);
                 break;
             case SHAPE_ELLIPSE:
-                if (isPointInEllipse(x, y, shape->data.ellipse.x, shape->data.ellipse.y, shape->data.ellipse.rx, shape->data.ellipse.ry)) return i;
+                hit = isPointInEllipse(x, y, shape->data.ellipse.x, shape->data.ellipse.y, shape->data.ellipse.rx, shape->data.ellipse.ry);
                 break;
+            // Arcs, polygons and triangles use the cached hit-test data of the store
             case SHAPE_ARC:
-                if(isPointInArc(x, y, shape->data.arc.x, shape->data.arc.y, shape->data.arc.radius, shape->data.arc.start_angle, shape->data.arc.end_angle)) return i;
-                break;
             case SHAPE_POLYGON:
-                if(isPointInPolygon(x, y, shape->data.polygon.cx, shape->data.polygon.cy, shape->data.polygon.radius, shape->data.polygon.sides)) return i;
-                break;
             case SHAPE_TRIANGLE:
-                if(isPointInTriangle(x, y, shape->data.triangle.cx, shape->data.triangle.cy, shape->data.triangle.radius)) return i;
+                hit = isPointInShape(shape, x, y);
                 break;
             case SHAPE_LINE:
-                if(isPointInLine(x, y, 
+                hit = isPointInLine(x, y, 
                                 shape->data.line.x1, 
                                 shape->data.line.y1, 
                                 shape->data.line.x2, 
                                 shape->data.line.y2, 
                                 shape->data.line.thickness,
-                                shape->rotation)) return i;
+                                shape->rotation);
                 break;
         }
+
+        // The shapes array is not in z-order, keep the one drawn on top.
+        if (hit && (topmost == -1 || shape->zIndex > shapes[topmost].zIndex)) {
+            topmost = i;
+        }
     }
-    return -1; // No shape found at the cursor's position.
+    return topmost; // -1 if no shape found at the cursor's position.
 }
 
 /**
@@ -821,24 +880,8 @@ void renderCursorCoordinates(SDL_Renderer *renderer, TTF_Font *font, int x, int
     char text[32];
     snprintf(text, sizeof(text), "x: %d, y: %d", x, y);
 
-    // Create text surface with black color
-    SDL_Surface *surface = TTF_RenderText_Solid(font, text, textColor);
-    if (!surface) return;
-
-    // Convert surface to texture for rendering
-    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
-    if (!texture) return;
-
-    // Position the text in the top-left corner with margins
-    SDL_Rect textRect;
-    SDL_QueryTexture(texture, NULL, NULL, &textRect.w, &textRect.h);
-    textRect.x = 10;  // 10 pixels margin from left
-    textRect.y = 10;  // 10 pixels margin from top
-
-    // Render the text and cleanup
-    SDL_RenderCopy(renderer, texture, NULL, &textRect);
-    SDL_DestroyTexture(texture);
+    // Draw the text from the glyph atlas in the top-left corner with 10 pixels margins
+    renderText(renderer, text, 10, 10, textColor, 1.0f, 0);
 }
 
 /**
@@ -887,7 +930,7 @@ void renderShapeInfo(SDL_Renderer *renderer, TTF_Font *font, Shape *shape, int b
     char text[128];
     char text2[128];
     // Determine if shape is empty or filled
-    const char *formType = (strcmp(shape->typeForm, "empty") == 0) ? "(empty)" : "(filled)";
+    const char *formType = (shape->typeForm == FORM_EMPTY) ? "(empty)" : "(filled)";
     
     char animation_chose[20];
     strcpy(animation_chose, getAnimationName(shape->animation_parser));
@@ -976,39 +1019,18 @@ void renderShapeInfo(SDL_Renderer *renderer, TTF_Font *font, Shape *shape, int b
             break;
     }
 
-    // Create text surface with enhanced quality rendering
-    // Use blended rendering for smoother text with word wrap at 300 pixels
-    SDL_Surface *surface = TTF_RenderText_Blended_Wrapped(font, text, textColor, 300);
-    SDL_Surface *surface2 = TTF_RenderText_Blended_Wrapped(font, text2, textColor, 400);
-    if (!surface) return;
-    if (!surface2) return;
-    // Convert surface to texture for rendering
-    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_Texture *texture2 = SDL_CreateTextureFromSurface(renderer, surface2);
-    SDL_FreeSurface(surface);
-    SDL_FreeSurface(surface2);
-    if (!texture) return;
-    if (!texture2) return;
-
     // Get window dimensions for positioning
     int windowWidth, windowHeight;
     SDL_GetRendererOutputSize(renderer, &windowWidth, &windowHeight);
 
-    // Position the text in the bottom-right corner with margins
-    SDL_Rect textRect;
-    SDL_Rect textRect2;
-    SDL_QueryTexture(texture, NULL, NULL, &textRect.w, &textRect.h);
-    SDL_QueryTexture(texture2, NULL, NULL, &textRect2.w, &textRect2.h);
-    textRect.x = windowWidth - textRect.w + 70;  // Adjust position from right edge
-    textRect.y = windowHeight - textRect.h - 10; // 10 pixels margin from bottom
-    textRect2.x = 10;  // Adjust position from left edge
-    textRect2.y = windowHeight - textRect2.h - 10; // 10 pixels margin from bottom
-
-    // Render the text and cleanup
-    SDL_RenderCopy(renderer, texture, NULL, &textRect);
-    SDL_RenderCopy(renderer, texture2, NULL, &textRect2);
-    SDL_DestroyTexture(texture);
-    SDL_DestroyTexture(texture2);
+    // Measure both blocks, wrapped at 300 and 400 pixels
+    int textW, textH, text2W, text2H;
+    getTextSize(text, 1.0f, 300, &textW, &textH);
+    getTextSize(text2, 1.0f, 400, &text2W, &text2H);
+
+    // Shape details in the bottom-right corner, animation list in the bottom-left one
+    renderText(renderer, text, windowWidth - textW + 70, windowHeight - textH - 10, textColor, 1.0f, 300);
+    renderText(renderer, text2, 10, windowHeight - text2H - 10, textColor, 1.0f, 400);
 }
 
 /**
@@ -1028,26 +1050,14 @@ void renderLastKeyPressed(SDL_Renderer *renderer, TTF_Font *font, int bgcolorR,
     char keyText[64];
     snprintf(keyText, sizeof(keyText), "Key Pressed: %s", lastKeyPressed);
     
-    // Set text color to black
-    SDL_Surface* keySurface = TTF_RenderText_Solid(font, keyText, textColor);
-    if (!keySurface) return;
-
-    // Convert surface to texture for rendering
-    SDL_Texture* keyTexture = SDL_CreateTextureFromSurface(renderer, keySurface);
-    SDL_FreeSurface(keySurface);
-    if (!keyTexture) return;
-
     // Position the text in the top-right corner
     int windowWidth, windowHeight;
     SDL_GetRendererOutputSize(renderer, &windowWidth, &windowHeight);
-    SDL_Rect keyRect;
-    SDL_QueryTexture(keyTexture, NULL, NULL, &keyRect.w, &keyRect.h);
-    keyRect.x = windowWidth - keyRect.w - 10;  // 10 pixels margin from right
-    keyRect.y = 10;                            // 10 pixels margin from top
-
-    // Render the text and cleanup
-    SDL_RenderCopy(renderer, keyTexture, NULL, &keyRect);
-    SDL_DestroyTexture(keyTexture);
+    int keyW;
+    getTextSize(keyText, 1.0f, 0, &keyW, NULL);
+
+    // 10 pixels margin from right and top
+    renderText(renderer, keyText, windowWidth - keyW - 10, 10, textColor, 1.0f, 0);
 }
 
 /**
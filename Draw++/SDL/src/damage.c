@@ -0,0 +1,264 @@
+#include "../files.h/damage.h"
+#include "../files.h/formEvents.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ANSI escape codes for colors
+#define RED_COLOR "-#red "
+
+// What renderShape draws for a shape. Built in zeroed memory and copied with memcpy,
+// so two looks can be compared with memcmp.
+typedef struct {
+    ShapeType type;
+    unsigned char data[sizeof(((Shape *)0)->data)];
+    SDL_Color color;
+    double rotation;
+    int zIndex;
+    bool selected;
+    bool filled;
+} ShapeLook;
+
+// A shape as it is in the back buffer
+typedef struct {
+    Uint32 generation;  // Generation of the store slot when it was drawn, 0 if nothing is drawn
+    Uint32 frame;       // Last frame the shape was found in the store
+    SDL_Rect bounds;    // Area it was drawn in, see getShapeDrawBounds
+    ShapeLook look;
+} DrawnShape;
+
+static DrawnShape *drawnShapes = NULL;    // Indexed by store slot
+static int drawnShapeCapacity = 0;
+static Uint32 frameNumber = 0;
+
+static SDL_Texture *backBuffer = NULL;    // The scene as of the last frame, without cursor and HUD
+static int bufferWidth = 0;
+static int bufferHeight = 0;
+static SDL_Color bufferBackground;
+static bool fullDamage = true;            // The back buffer must be redrawn entirely
+static bool noRenderTarget = false;       // Creating the back buffer failed, do not retry
+
+static SDL_Rect damage[DAMAGE_MAX_RECTS];
+static int damageCount = 0;
+
+/**
+ * @brief Redraws the whole scene on the next frame.
+ *
+ * Needed when the scene looks different without any shape changing, e.g. when
+ * switching render paths or when the renderer lost its textures.
+ */
+void invalidateDamage(void) {
+    fullDamage = true;
+}
+
+static Sint64 getArea(const SDL_Rect *rect) {
+    return (Sint64)rect->w * rect->h;
+}
+
+/**
+ * @brief Adds a region to redraw, merged with the regions it overlaps.
+ */
+static void addDamage(SDL_Rect rect) {
+    SDL_Rect window = {0, 0, bufferWidth, bufferHeight};
+    if (fullDamage || !SDL_IntersectRect(&rect, &window, &rect)) return;
+
+    // Grow the region until it overlaps none of the others
+    for (int i = 0; i < damageCount; i++) {
+        if (SDL_HasIntersection(&rect, &damage[i])) {
+            SDL_UnionRect(&rect, &damage[i], &rect);
+            damage[i] = damage[--damageCount];
+            i = -1;
+        }
+    }
+
+    if (damageCount == DAMAGE_MAX_RECTS) {
+        // Out of regions: merge with the one that adds the least area
+        int closest = 0;
+        Sint64 smallestGrowth = -1;
+        for (int i = 0; i < damageCount; i++) {
+            SDL_Rect merged;
+            SDL_UnionRect(&rect, &damage[i], &merged);
+            Sint64 growth = getArea(&merged) - getArea(&damage[i]);
+            if (smallestGrowth < 0 || growth < smallestGrowth) {
+                smallestGrowth = growth;
+                closest = i;
+            }
+        }
+        SDL_UnionRect(&rect, &damage[closest], &rect);
+        damage[closest] = damage[--damageCount];
+        addDamage(rect);  // The merged region may overlap others
+        return;
+    }
+
+    damage[damageCount++] = rect;
+}
+
+/**
+ * @brief Fills in what renderShape would draw for a shape.
+ */
+static void describeShape(const Shape *shape, ShapeLook *look) {
+    memset(look, 0, sizeof(ShapeLook));
+    look->type = shape->type;
+    memcpy(look->data, &shape->data, sizeof(look->data));
+    look->color = shape->color;
+    look->rotation = shape->rotation;
+    look->zIndex = shape->zIndex;
+    look->selected = shape->selected;
+    look->filled = shape->typeForm == FORM_FILLED;
+}
+
+/**
+ * @brief Returns the back buffer entry of a store slot, growing the table if needed.
+ */
+static DrawnShape* getDrawnShape(Uint32 slot) {
+    if ((int)slot >= drawnShapeCapacity) {
+        int capacity = drawnShapeCapacity ? drawnShapeCapacity : 64;
+        while (capacity <= (int)slot) capacity *= 2;
+        DrawnShape *newTable = realloc(drawnShapes, capacity * sizeof(DrawnShape));
+        if (!newTable) return NULL;
+        memset(newTable + drawnShapeCapacity, 0, (capacity - drawnShapeCapacity) * sizeof(DrawnShape));
+        drawnShapes = newTable;
+        drawnShapeCapacity = capacity;
+    }
+    return &drawnShapes[slot];
+}
+
+/**
+ * @brief Compares the store with the back buffer and records where they differ.
+ *
+ * A shape that was added, deleted, moved, resized, rotated, recolored, selected or
+ * moved between layers damages the area it was drawn in and the one it is drawn in now.
+ * Comparing looks rather than hooking every edit also catches animations and games.
+ *
+ * @return 0 on success, -1 if the table could not grow (the whole scene must be redrawn).
+ */
+static int trackShapes(void) {
+    frameNumber++;
+
+    for (int i = 0; i < shapeCount; i++) {
+        ShapeHandle handle = getShapeHandle(i);
+        DrawnShape *drawn = getDrawnShape(handle.slot);
+        if (!drawn) return -1;
+
+        ShapeLook look;
+        describeShape(&shapes[i], &look);
+        drawn->frame = frameNumber;
+        if (drawn->generation == handle.generation && memcmp(&drawn->look, &look, sizeof(ShapeLook)) == 0) {
+            continue;
+        }
+
+        if (drawn->generation != 0) addDamage(drawn->bounds);
+        drawn->generation = 0;
+        if (!getShapeDrawBounds(&shapes[i], &drawn->bounds)) continue;  // Unknown types are not drawn
+
+        addDamage(drawn->bounds);
+        drawn->generation = handle.generation;
+        memcpy(&drawn->look, &look, sizeof(ShapeLook));
+    }
+
+    // Shapes deleted since the last frame
+    for (int slot = 0; slot < drawnShapeCapacity; slot++) {
+        DrawnShape *drawn = &drawnShapes[slot];
+        if (drawn->generation != 0 && drawn->frame != frameNumber) {
+            addDamage(drawn->bounds);
+            drawn->generation = 0;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Creates the back buffer at the size of the output.
+ *
+ * @return 0 on success, -1 if the renderer cannot draw into textures.
+ */
+static int createBackBuffer(SDL_Renderer *renderer, int width, int height) {
+    if (backBuffer) SDL_DestroyTexture(backBuffer);
+    backBuffer = NULL;
+
+    if (SDL_RenderTargetSupported(renderer)) {
+        backBuffer = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    }
+    if (!backBuffer) {
+        printf("%sExecutionError: No back buffer for partial redraws, drawing full frames: %s\n", RED_COLOR, SDL_GetError());
+        noRenderTarget = true;
+        return -1;
+    }
+
+    SDL_SetTextureBlendMode(backBuffer, SDL_BLENDMODE_NONE);
+    bufferWidth = width;
+    bufferHeight = height;
+    fullDamage = true;
+    return 0;
+}
+
+/**
+ * @brief Brings the back buffer up to date and copies it to the current frame.
+ *
+ * Only the regions where shapes changed since the last frame are cleared and redrawn,
+ * each under its own clip rect, with the shapes that overlap it. The cursor and the
+ * HUD are drawn by the caller on top of the copy, so they never damage the scene.
+ *
+ * @param renderer The renderer of the window.
+ * @param background The color of the window.
+ * @return 0 on success, -1 if there is no back buffer: the caller then draws the
+ *         whole scene itself.
+ */
+int renderDamagedScene(SDL_Renderer *renderer, SDL_Color background) {
+    if (noRenderTarget) return -1;
+
+    int width, height;
+    SDL_GetRendererOutputSize(renderer, &width, &height);
+    if (!backBuffer || width != bufferWidth || height != bufferHeight) {
+        if (createBackBuffer(renderer, width, height) != 0) return -1;
+    }
+    if (memcmp(&background, &bufferBackground, sizeof(SDL_Color)) != 0) {
+        bufferBackground = background;
+        fullDamage = true;
+    }
+
+    damageCount = 0;
+    if (trackShapes() != 0) fullDamage = true;
+
+    // Past a certain area, clipped passes cost more than one full redraw
+    Sint64 damagedArea = 0;
+    for (int i = 0; i < damageCount; i++) damagedArea += getArea(&damage[i]);
+    if (damagedArea * 100 > (Sint64)width * height * DAMAGE_FULL_PERCENT) fullDamage = true;
+    if (fullDamage) {
+        damage[0] = (SDL_Rect){0, 0, width, height};
+        damageCount = 1;
+    }
+
+    if (SDL_SetRenderTarget(renderer, backBuffer) != 0) {
+        printf("%sExecutionError: Failed to draw into the back buffer: %s\n", RED_COLOR, SDL_GetError());
+        return -1;
+    }
+    for (int i = 0; i < damageCount; i++) {
+        SDL_RenderSetClipRect(renderer, fullDamage ? NULL : &damage[i]);
+        SDL_SetRenderDrawColor(renderer, background.r, background.g, background.b, 255);
+        SDL_RenderFillRect(renderer, &damage[i]);
+        renderShapesInRect(renderer, fullDamage ? NULL : &damage[i]);
+    }
+    SDL_RenderSetClipRect(renderer, NULL);
+    SDL_SetRenderTarget(renderer, NULL);
+    fullDamage = false;
+
+    SDL_RenderCopy(renderer, backBuffer, NULL, NULL);
+    return 0;
+}
+
+/**
+ * @brief Releases the back buffer and the damage table.
+ *
+ * Must be called before the renderer is destroyed.
+ */
+void freeDamage(void) {
+    if (backBuffer) SDL_DestroyTexture(backBuffer);
+    backBuffer = NULL;
+    bufferWidth = bufferHeight = 0;
+    free(drawnShapes);
+    drawnShapes = NULL;
+    drawnShapeCapacity = 0;
+    fullDamage = true;
+    noRenderTarget = false;
+}
@@ -1,8 +1,37 @@
 #include "../files.h/form.h"
+#include "../files.h/headless.h"
+#include "../files.h/spanFill.h"
 
 // ANSI escape codes for colors
 #define RED_COLOR "-#red "
 
+#define ANIMATED_DRAW_DURATION 1000  // Duration of an animated draw in ms, whatever the shape size
+#define ANIMATED_DRAW_FRAME 16       // At most one present per display frame (~60 FPS)
+#define POLYGON_MAX_SIDES 12         // Largest polygon the draw functions build
+
+// Piece of an animated draw, revealed in order. A point has both ends equal.
+typedef struct {
+    int x1, y1, x2, y2;
+} DrawSegment;
+
+typedef struct {
+    DrawSegment *items;
+    int count;
+    int capacity;
+} SegmentList;
+
+/**
+ * @brief Fills the spans of an instant draw in a single copy, then frees them.
+ *
+ * @return 0 on success, -1 if the spans could not be drawn.
+ */
+static int fillSpanList(SDL_Renderer *renderer, SpanList *list, SDL_Color color) {
+    int result = fillSpans(renderer, list->items, list->count, color);
+    free(list->items);
+    *list = (SpanList){0};
+    return result;
+}
+
 /**
  * @brief Draws a circle on the SDL renderer.
  * 
@@ -10,11 +39,11 @@
  * @param y The y-coordinate of the circle's center.
  * @param radius The radius of the circle.
  */
-int drawCircle(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, int radius, SDL_Color color, char *type) {
-    // Check if the type is valid ("filled" or "empty")
-    if ((strcmp(type, "filled") != 0) && (strcmp(type, "empty") != 0)){
-        printf("%sExecutionError: Invalid instantCircle type: \"%s\". Must be filled or empty.\n", 
-               RED_COLOR, type);
+int drawCircle(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, int radius, SDL_Color color, FormType type) {
+    // Check if the type is valid (FORM_FILLED or FORM_EMPTY)
+    if (type != FORM_FILLED && type != FORM_EMPTY){
+        printf("%sExecutionError: Invalid instantCircle type: %d. Must be filled or empty.\n", 
+               RED_COLOR, (int)type);
         return -1;
     }
 
@@ -25,22 +54,23 @@ int drawCircle(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, int r
     if (handleEvents(renderer, texture) == -1) return -1;
 
     // Draw the circle based on the type
-    if (strcmp(type, "empty") == 0) {
+    if (type == FORM_EMPTY) {
         if (circleRGBA(renderer, x, y, radius, color.r, color.g, color.b, color.a) != 0) {
             printf("%sExecutionError: Failed to draw empty circle.\n", 
                    RED_COLOR);
             return -1;
         }
-    } else if (strcmp(type, "filled") == 0) {
-        if (filledCircleRGBA(renderer, x, y, radius, color.r, color.g, color.b, color.a) != 0) {
+    } else if (type == FORM_FILLED) {
+        SpanList spans = {0};
+        if (pushCircleSpans(&spans, x, y, radius) == -1 || fillSpanList(renderer, &spans, color) == -1) {
             printf("%sExecutionError: Failed to draw filled circle.\n", 
                    RED_COLOR);
             return -1;
         }
     }
 
-    // Render the texture to the screen with a delay
-    if (renderTexture(renderer, texture, 750) == -1) {
+    // Render the texture to the screen (with a delay, or batched)
+    if (presentInstantDraw(renderer, texture) == -1) {
         printf("%sExecutionError: Failed to render circle to texture.\n", 
                RED_COLOR);
         return -1;
@@ -68,9 +98,9 @@ int drawCircle(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, int r
  * @param rx The horizontal radius of the ellipse.
  * @param ry The vertical radius of the ellipse.
  */
-int drawEllipse(SDL_Renderer* renderer, SDL_Texture *texture, int x, int y, int rx, int ry, SDL_Color color, char *type) {
-    if ((strcmp(type, "filled") != 0) && (strcmp(type, "empty") != 0)){
-        printf("Invalid instantEllipse type: \"%s.\". Must be filled or empty.\n", type);
+int drawEllipse(SDL_Renderer* renderer, SDL_Texture *texture, int x, int y, int rx, int ry, SDL_Color color, FormType type) {
+    if (type != FORM_FILLED && type != FORM_EMPTY){
+        printf("Invalid instantEllipse type: %d. Must be filled or empty.\n", (int)type);
         return -1;
     }
     else
@@ -78,19 +108,20 @@ int drawEllipse(SDL_Renderer* renderer, SDL_Texture *texture, int x, int y, int
 
         if (handleEvents(renderer, texture) == -1) return -1;
 
-        if (strcmp(type, "empty") == 0) {
+        if (type == FORM_EMPTY) {
             if (ellipseRGBA(renderer, x, y, rx, ry, color.r, color.g, color.b, color.a) != 0) {
                 printf("%sExecutionError: Failed to draw empty ellipse.\n", RED_COLOR);
                 return -1;
             }
-        } else if (strcmp(type, "filled") == 0) {
-            if (filledEllipseRGBA(renderer, x, y, rx, ry, color.r, color.g, color.b, color.a) != 0) {
+        } else if (type == FORM_FILLED) {
+            SpanList spans = {0};
+            if (pushEllipseSpans(&spans, x, y, rx, ry) == -1 || fillSpanList(renderer, &spans, color) == -1) {
                 printf("%sExecutionError: Failed to draw filled ellipse.\n", RED_COLOR);
                 return -1;
             }
         } 
         
-        renderTexture(renderer, texture, 750);
+        presentInstantDraw(renderer, texture);
         if (handleEvents(renderer, texture) == -1) return -1;
         SDL_SetRenderTarget(renderer, NULL); 
     }  
@@ -107,33 +138,25 @@ int drawEllipse(SDL_Renderer* renderer, SDL_Texture *texture, int x, int y, int
  * @param start_angle The starting angle of the arc in degrees.
  * @param end_angle The ending angle of the arc in degrees.
  */
-int drawArc(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, int radius, int start_angle, int end_angle, SDL_Color color, char *type) {
+int drawArc(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, int radius, int start_angle, int end_angle, SDL_Color color, FormType type) {
 
     if (handleEvents(renderer, texture) == -1) return -1;
 
-    if (strcmp(type, "filled") == 0) {
-        // Convert angles to radians
-        double startRad = start_angle * M_PI / 180.0;
-        double endRad = end_angle * M_PI / 180.0;
-
-        setRenderColor(renderer, color);
-
-        // Draw the filled arc by iterating over concentric radius and angles
-        for (int r = 0; r <= radius; ++r) { 
-            for (double angle = startRad; angle <= endRad; angle += 0.01) { // Iterate on each angle
-                int px = x + (int)(r * cos(angle));
-                int py = y + (int)(r * sin(angle));
-                SDL_RenderDrawLine(renderer, x, y, px, py);
-            }
+    if (type == FORM_FILLED) {
+        // One span per row of the pie, instead of a ray per radius and angle step
+        SpanList spans = {0};
+        if (pushPieSpans(&spans, x, y, radius, start_angle, end_angle) == -1 || fillSpanList(renderer, &spans, color) == -1) {
+            printf("%sExecutionError: Failed to draw filled arc.\n", RED_COLOR);
+            return -1;
         }
-    } else if (strcmp(type, "empty") == 0) {
+    } else if (type == FORM_EMPTY) {
         if (arcRGBA(renderer, x, y, radius, start_angle, end_angle, color.r, color.g, color.b, color.a) != 0) {
             printf("%sExecutionError: Failed to draw arc.\n", RED_COLOR);
             return -1;
         }
     }
 
-    renderTexture(renderer, texture, 750);
+    presentInstantDraw(renderer, texture);
     if (handleEvents(renderer, texture) == -1) return -1;
     SDL_SetRenderTarget(renderer, NULL); 
     return 0;
@@ -148,9 +171,9 @@ int drawArc(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, int radi
  * @param w The width of the rectangle.
  * @param h The height of the rectangle.
  */
-int drawRectangle(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, int w, int h, SDL_Color color, char *type) {
-    if ((strcmp(type, "filled") != 0) && (strcmp(type, "empty") != 0)){
-        printf("Invalid instantRectangle type: \"%s.\". Must be filled or empty.\n", type);
+int drawRectangle(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, int w, int h, SDL_Color color, FormType type) {
+    if (type != FORM_FILLED && type != FORM_EMPTY){
+        printf("Invalid instantRectangle type: %d. Must be filled or empty.\n", (int)type);
         return -1;
     }
     else
@@ -162,16 +185,16 @@ int drawRectangle(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, in
 
         if (handleEvents(renderer, texture) == -1) return -1;
 
-        if (strcmp(type, "empty") == 0) {
+        if (type == FORM_EMPTY) {
             if (SDL_RenderDrawRect(renderer, &rect) != 0) {
                 printf("%sExecutionError: Failed to draw empty rectangle.\n", RED_COLOR);
             }
-        } else if (strcmp(type, "filled") == 0) {
+        } else if (type == FORM_FILLED) {
             if (SDL_RenderFillRect(renderer, &rect) != 0) {
                 printf("%sExecutionError: Failed to draw filled rectangle.\n", RED_COLOR);
             }
         } 
-        renderTexture(renderer, texture, 750);
+        presentInstantDraw(renderer, texture);
         if (handleEvents(renderer, texture) == -1) return -1;  
         SDL_SetRenderTarget(renderer, NULL);
     }
@@ -187,18 +210,18 @@ int drawRectangle(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, in
  * @param y Y-coordinate of the top-left corner of the square
  * @param c Side length of the square
  * @param color SDL_Color structure containing the RGB values for the square color
- * @param type String specifying whether the square should be "filled" or "empty"
+ * @param type FORM_FILLED or FORM_EMPTY
  * 
  * @return Returns 0 on success, -1 on failure
  * 
  * @details This function draws either a filled or empty square on the specified renderer.
  *          The square is defined by its top-left corner coordinates (x,y) and side length c.
- *          The type parameter must be either "filled" or "empty".
+ *          The type parameter must be either FORM_FILLED or FORM_EMPTY.
  *          After drawing, the square is rendered to the texture and displayed.
  */
-int drawSquare(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, int c, SDL_Color color, char *type) {
-    if ((strcmp(type, "filled") != 0) && (strcmp(type, "empty") != 0)){
-        printf("Invalid instantSquare type: \"%s.\". Must be filled or empty.\n", type);
+int drawSquare(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, int c, SDL_Color color, FormType type) {
+    if (type != FORM_FILLED && type != FORM_EMPTY){
+        printf("Invalid instantSquare type: %d. Must be filled or empty.\n", (int)type);
         return -1;
     }
     else
@@ -210,16 +233,16 @@ int drawSquare(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, int c
 
         if (handleEvents(renderer, texture) == -1) return -1;
 
-        if (strcmp(type, "empty") == 0) {
+        if (type == FORM_EMPTY) {
             if (SDL_RenderDrawRect(renderer, &rect) != 0) {
                 printf("%sExecutionError: Failed to draw empty square.\n", RED_COLOR);
             }
-        } else if (strcmp(type, "filled") == 0) {
+        } else if (type == FORM_FILLED) {
             if (SDL_RenderFillRect(renderer, &rect) != 0) {
                 printf("%sExecutionError: Failed to draw filled square.\n", RED_COLOR);
             }
         } 
-        renderTexture(renderer, texture, 750);
+        presentInstantDraw(renderer, texture);
         if (handleEvents(renderer, texture) == -1) return -1;  
         SDL_SetRenderTarget(renderer, NULL);
     }
@@ -237,13 +260,13 @@ int drawSquare(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, int c
  * @param cy Y coordinate of the triangle's center 
  * @param radius Radius of the circumscribed circle of the triangle
  * @param color SDL_Color structure defining the triangle's color
- * @param type String indicating the type of triangle to draw
+ * @param type FORM_FILLED or FORM_EMPTY
  *
  * @return 0 on success, -1 on error/exit event
  *
  * @note The triangle is oriented with one vertex pointing upward (30 degree rotation)
  */
-int drawTriangle(SDL_Renderer *renderer, SDL_Texture *texture, Sint16 cx, Sint16 cy, int radius, SDL_Color color, char *type) 
+int drawTriangle(SDL_Renderer *renderer, SDL_Texture *texture, Sint16 cx, Sint16 cy, int radius, SDL_Color color, FormType type) 
 {
     // Validate the number of sides
     int sides = 3;
@@ -275,15 +298,15 @@ int drawTriangle(SDL_Renderer *renderer, SDL_Texture *texture, Sint16 cx, Sint16
  * @param n The number of vertices in the polygon.
  * @return int Returns 0 on success, -1 on failure.
  */
-int drawPolygon(SDL_Renderer *renderer, SDL_Texture *texture, Sint16 *vx, Sint16 *vy, int n, SDL_Color color, char *type)
+int drawPolygon(SDL_Renderer *renderer, SDL_Texture *texture, Sint16 *vx, Sint16 *vy, int n, SDL_Color color, FormType type)
 {
-    if ((strcmp(type, "filled") != 0) && (strcmp(type, "empty") != 0)){
-        printf("%sExecutionError: Invalid type for polygon '%s'. Must be 'filled' or 'empty'.\n", 
-               RED_COLOR, type);
+    if (type != FORM_FILLED && type != FORM_EMPTY){
+        printf("%sExecutionError: Invalid type for polygon %d. Must be 'filled' or 'empty'.\n", 
+               RED_COLOR, (int)type);
         return -1;
     }
 
-    if(strcmp(type, "empty") == 0)
+    if(type == FORM_EMPTY)
     {
         if(polygonRGBA(renderer, vx, vy, n, color.r, color.g, color.b, color.a) != 0)
         {
@@ -291,15 +314,30 @@ int drawPolygon(SDL_Renderer *renderer, SDL_Texture *texture, Sint16 *vx, Sint16
             return -1;
         }
     }
-    else if(strcmp(type, "filled") == 0)
+    else if(type == FORM_FILLED)
     {
-        if(filledPolygonRGBA(renderer, vx, vy, n, color.r, color.g, color.b, color.a) != 0)
+        SDL_FPoint points[POLYGON_MAX_SIDES];
+        for (int i = 0; i < n && i < POLYGON_MAX_SIDES; i++) {
+            points[i] = (SDL_FPoint){vx[i], vy[i]};
+        }
+
+        // Convex polygons (every regular one) are filled with spans, the others by SDL2_gfx
+        if (n <= POLYGON_MAX_SIDES && isConvexPolygon(points, n))
+        {
+            SpanList spans = {0};
+            if (pushConvexSpans(&spans, points, n) == -1 || fillSpanList(renderer, &spans, color) == -1)
+            {
+                printf("%sExecutionError: Failed to draw filled polygon.\n", RED_COLOR);
+                return -1;
+            }
+        }
+        else if(filledPolygonRGBA(renderer, vx, vy, n, color.r, color.g, color.b, color.a) != 0)
         {
             printf("%sExecutionError: Failed to draw filled polygon.\n", RED_COLOR);
             return -1;
         }
     }
-    renderTexture(renderer, texture, 750);
+    presentInstantDraw(renderer, texture);
     return 0;
 }
 
@@ -315,9 +353,9 @@ int drawPolygon(SDL_Renderer *renderer, SDL_Texture *texture, Sint16 *vx, Sint16
  * @param sides The number of sides of the polygon (must be between 3 and 12).
  * @param rhombusOffset Multiplier for elongating the diagonals (use <1 for flat rhombus, >1 for tall rhombus).
  * @param color The color of the polygon.
- * @param type The type of polygon ("filled" or "empty").
+ * @param type The type of polygon (FORM_FILLED or FORM_EMPTY).
  */
-int drawCustomPolygon(SDL_Renderer *renderer, SDL_Texture *texture, Sint16 cx, Sint16 cy, int radius, int sides, SDL_Color color, char *type) 
+int drawCustomPolygon(SDL_Renderer *renderer, SDL_Texture *texture, Sint16 cx, Sint16 cy, int radius, int sides, SDL_Color color, FormType type) 
 {
     // Validate the number of sides
     if (sides < 3 || sides > 12) {
@@ -352,19 +390,28 @@ int drawCustomPolygon(SDL_Renderer *renderer, SDL_Texture *texture, Sint16 cx, S
  * @param y1 The y-coordinate of the starting point of the line.
  * @param x2 The x-coordinate of the ending point of the line.
  * @param y2 The y-coordinate of the ending point of the line. 
- * @param width The thickness of the line (ignored if type is "empty").
+ * @param width The thickness of the line (ignored if type is FORM_EMPTY).
  */
-int drawLine(SDL_Renderer *renderer, SDL_Texture *texture, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint8 width, SDL_Color color, char *type) {
-    if ((strcmp(type, "filled") != 0) && (strcmp(type, "empty") != 0)){
-        printf("%sExecutionError: Invalid type for line '%s'. Must be 'filled' or 'empty'.\n", 
-               RED_COLOR, type);
+int drawLine(SDL_Renderer *renderer, SDL_Texture *texture, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint8 width, SDL_Color color, FormType type) {
+    if (type != FORM_FILLED && type != FORM_EMPTY){
+        printf("%sExecutionError: Invalid type for line %d. Must be 'filled' or 'empty'.\n", 
+               RED_COLOR, (int)type);
         return -1;
     }
 
     if (handleEvents(renderer, texture) == -1) return -1;
 
     // Use different drawing methods based on type
-    if (strcmp(type, "filled") == 0) {
+    if (type == FORM_FILLED && (x1 != x2 || y1 != y2)) {
+        // A thick line is a rectangle turned along the line
+        double dx = x2 - x1, dy = y2 - y1;
+        SpanList spans = {0};
+        if (pushRotatedRectSpans(&spans, (x1 + x2) / 2.0f, (y1 + y2) / 2.0f, sqrt(dx * dx + dy * dy), width,
+                                 atan2(dy, dx) * 180.0 / M_PI) == -1 || fillSpanList(renderer, &spans, color) == -1) {
+            printf("%sExecutionError: Failed to draw filled line.\n", RED_COLOR);
+            return -1;
+        }
+    } else if (type == FORM_FILLED) {
         if (thickLineRGBA(renderer, x1, y1, x2, y2, width, color.r, color.g, color.b, color.a) != 0) {
             printf("%sExecutionError: Failed to draw filled line.\n", RED_COLOR);
             return -1;
@@ -376,7 +423,7 @@ int drawLine(SDL_Renderer *renderer, SDL_Texture *texture, Sint16 x1, Sint16 y1,
         }
     }
     
-    renderTexture(renderer, texture, 750);
+    presentInstantDraw(renderer, texture);
     if (handleEvents(renderer, texture) == -1) return -1;
     SDL_SetRenderTarget(renderer, NULL);
     
@@ -384,50 +431,227 @@ int drawLine(SDL_Renderer *renderer, SDL_Texture *texture, Sint16 x1, Sint16 y1,
 }
 
 
+/**
+ * @brief Appends a segment to a progressive draw. A point is a segment of length 0.
+ *
+ * @return 0 on success, -1 if the list could not grow (the list is then freed).
+ */
+static int pushSegment(SegmentList *list, int x1, int y1, int x2, int y2) {
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 256;
+        DrawSegment *grown = realloc(list->items, capacity * sizeof(DrawSegment));
+        if (!grown) {
+            printf("%sExecutionError: Memory allocation failed for animated draw\n", RED_COLOR);
+            free(list->items);
+            *list = (SegmentList){0};
+            return -1;
+        }
+        list->items = grown;
+        list->capacity = capacity;
+    }
+    list->items[list->count++] = (DrawSegment){x1, y1, x2, y2};
+    return 0;
+}
+
+/**
+ * @brief Returns how many of the count pieces of an animated draw are due by the end of the frame.
+ *
+ * @param start When the draw started, in ms.
+ * @param frameStart When the current frame started, in ms.
+ */
+static int revealTarget(Uint32 start, Uint32 frameStart, int count) {
+    Uint32 due = frameStart - start + ANIMATED_DRAW_FRAME;
+    if (headless.enabled || due >= ANIMATED_DRAW_DURATION) return count;
+    return (int)((Uint64)count * due / ANIMATED_DRAW_DURATION);
+}
+
+/**
+ * @brief Waits for the end of the display frame before revealing the next chunk.
+ */
+static void waitRevealFrame(Uint32 frameStart) {
+    Uint32 frameTime = SDL_GetTicks() - frameStart;
+    if (!headless.enabled && frameTime < ANIMATED_DRAW_FRAME) {
+        SDL_Delay(ANIMATED_DRAW_FRAME - frameTime);
+    }
+}
+
+/**
+ * @brief Reveals the segments of an animated draw in order over ANIMATED_DRAW_DURATION.
+ *
+ * Each display frame draws the chunk of segments due by the end of that frame, then
+ * presents once and polls events once, so the draw time no longer depends on the
+ * shape's size. Offscreen runs reveal everything in a single frame. The list is freed.
+ *
+ * @return -1 if an event interrupts the drawing, 0 otherwise.
+ */
+static int revealSegments(SDL_Renderer *renderer, SDL_Texture *texture, SegmentList *list) {
+    Uint32 start = SDL_GetTicks();
+    int drawn = 0;
+
+    while (drawn < list->count) {
+        if (handleEvents(renderer, texture) == -1) {
+            free(list->items);
+            return -1;
+        }
+
+        Uint32 frameStart = SDL_GetTicks();
+        int target = revealTarget(start, frameStart, list->count);
+
+        for (; drawn < target; drawn++) {
+            const DrawSegment *s = &list->items[drawn];
+            if (s->x1 == s->x2 && s->y1 == s->y2) {
+                SDL_RenderDrawPoint(renderer, s->x1, s->y1);
+            } else {
+                SDL_RenderDrawLine(renderer, s->x1, s->y1, s->x2, s->y2);
+            }
+        }
+        renderTexture(renderer, texture, 0);
+        if (drawn < list->count) waitRevealFrame(frameStart);
+    }
+
+    free(list->items);
+    return 0;
+}
+
+/**
+ * @brief Reveals the spans of an animated fill in order over ANIMATED_DRAW_DURATION.
+ *
+ * Same pacing as revealSegments, but each frame fills its chunk of spans with a
+ * single fillSpans call. The list is freed.
+ *
+ * @return -1 if an event interrupts the drawing or the spans cannot be drawn, 0 otherwise.
+ */
+static int revealSpans(SDL_Renderer *renderer, SDL_Texture *texture, SpanList *list, SDL_Color color) {
+    Uint32 start = SDL_GetTicks();
+    int drawn = 0;
+
+    while (drawn < list->count) {
+        if (handleEvents(renderer, texture) == -1) {
+            free(list->items);
+            return -1;
+        }
+
+        Uint32 frameStart = SDL_GetTicks();
+        int target = revealTarget(start, frameStart, list->count);
+
+        if (fillSpans(renderer, list->items + drawn, target - drawn, color) == -1) {
+            printf("%sExecutionError: Failed to draw animated fill.\n", RED_COLOR);
+            free(list->items);
+            return -1;
+        }
+        drawn = target;
+        renderTexture(renderer, texture, 0);
+        if (drawn < list->count) waitRevealFrame(frameStart);
+    }
+
+    free(list->items);
+    return 0;
+}
+
+/**
+ * @brief Appends the rows filling a regular polygon, from top to bottom.
+ *
+ * @return 0 on success, -1 if the list could not grow.
+ */
+static int pushPolygonFill(SpanList *list, const Sint16 *vx, const Sint16 *vy, int sides) {
+    SDL_FPoint points[POLYGON_MAX_SIDES];
+    for (int i = 0; i < sides; i++) {
+        points[i] = (SDL_FPoint){vx[i], vy[i]};
+    }
+    return pushConvexSpans(list, points, sides);
+}
+
+/**
+ * @brief Appends the outline of a polygon point by point (Bresenham), edge after edge.
+ *
+ * @return 0 on success, -1 if the list could not grow.
+ */
+static int pushPolygonOutline(SegmentList *list, const Sint16 *vx, const Sint16 *vy, int sides) {
+    for (int i = 0; i < sides; i++) {
+        int x1 = vx[i];
+        int y1 = vy[i];
+        int x2 = vx[(i + 1) % sides];
+        int y2 = vy[(i + 1) % sides];
+
+        int dx = abs(x2 - x1), sx = x1 < x2 ? 1 : -1;
+        int dy = -abs(y2 - y1), sy = y1 < y2 ? 1 : -1;
+        int err = dx + dy, e2;
+
+        while (1) {
+            if (pushSegment(list, x1, y1, x1, y1) == -1) return -1;
+
+            if (x1 == x2 && y1 == y2) break;
+            e2 = 2 * err;
+            if (e2 >= dy) { err += dy; x1 += sx; }
+            if (e2 <= dx) { err += dx; y1 += sy; }
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Appends the outline of an axis-aligned box point by point, clockwise from the top-left corner.
+ *
+ * @return 0 on success, -1 if the list could not grow.
+ */
+static int pushBoxOutline(SegmentList *list, int x, int y, int w, int h) {
+    for (int i = 0; i < w; ++i)
+        if (pushSegment(list, x + i, y, x + i, y) == -1) return -1;                 // Top edge
+    for (int j = 0; j < h; ++j)
+        if (pushSegment(list, x + w - 1, y + j, x + w - 1, y + j) == -1) return -1; // Right edge
+    for (int i = w - 1; i >= 0; --i)
+        if (pushSegment(list, x + i, y + h - 1, x + i, y + h - 1) == -1) return -1; // Bottom edge
+    for (int j = h - 1; j >= 0; --j)
+        if (pushSegment(list, x, y + j, x, y + j) == -1) return -1;                 // Left edge
+    return 0;
+}
+
 /**
  * @brief Draws an animated circle progressively.
- * @param We using SDL_RenderDrawPoint to have this effect
+ * The circle is revealed row by row (spans when filled, border points when empty).
  * 
  * @param x X-coordinate of the circle's center.
  * @param y Y-coordinate of the circle's center.
  * @param radius Radius of the circle.
  * @return -1 if an event interrupts the drawing, 0 otherwise.
  */
-int drawAnimatedCircle(SDL_Renderer* renderer, SDL_Texture* texture, int x, int y, int radius, SDL_Color color, char *type) { 
-    if ((strcmp(type, "filled") != 0) && (strcmp(type, "empty") != 0)) {
-        printf("%sExecutionError: Invalid type for animated circle '%s'. Must be 'filled' or 'empty'.\n", 
-               RED_COLOR, type);
+int drawAnimatedCircle(SDL_Renderer* renderer, SDL_Texture* texture, int x, int y, int radius, SDL_Color color, FormType type) { 
+    if (type != FORM_FILLED && type != FORM_EMPTY) {
+        printf("%sExecutionError: Invalid type for animated circle %d. Must be 'filled' or 'empty'.\n", 
+               RED_COLOR, (int)type);
         return -1;
     }
 
     SDL_SetRenderTarget(renderer, texture); // Set the texture as the rendering target.
     setRenderColor(renderer, color);
 
+    if (type == FORM_FILLED) {
+        SpanList spans = {0};
+        if (pushCircleSpans(&spans, x, y, radius) == -1) return -1;
+        if (revealSpans(renderer, texture, &spans, color) == -1) return -1;
+
+        SDL_SetRenderTarget(renderer, NULL);
+        return 0;
+    }
+
+    SegmentList list = {0};
+
     // Iterate through the vertical range of the circle.
     for (int dy = -radius; dy <= radius; ++dy) {
-        if (handleEvents(renderer, texture) == -1) return -1; // Handle events less frequently.
-
         // Calculate the horizontal range for the current row.
         int dxLimit = (int)sqrt(radius * radius - dy * dy); // Limit of x for the current y.
 
         for (int dx = -dxLimit; dx <= dxLimit; ++dx) {
+            // Check if the point lies on the border of the circle.
             int distanceSquared = dx * dx + dy * dy;
-
-            if (strcmp(type, "empty") == 0) {
-                // Check if the point lies on the border of the circle.
-                if (distanceSquared >= (radius - 1) * (radius - 1) && distanceSquared <= radius * radius) {
-                    SDL_RenderDrawPoint(renderer, x + dx, y + dy);
-                }
-            } else if (strcmp(type, "filled") == 0) {
-                // Check if the point lies inside the circle.
-                SDL_RenderDrawPoint(renderer, x + dx, y + dy);
+            if (distanceSquared >= (radius - 1) * (radius - 1) && distanceSquared <= radius * radius) {
+                if (pushSegment(&list, x + dx, y + dy, x + dx, y + dy) == -1) return -1;
             }
         }
-
-        // Render the texture after finishing a row.
-        renderTexture(renderer, texture, 6);
     }
 
+    if (revealSegments(renderer, texture, &list) == -1) return -1;
+
     SDL_SetRenderTarget(renderer, NULL); // Reset the rendering target to the default.
     return 0; // Return success.
 }
@@ -441,71 +665,30 @@ int drawAnimatedCircle(SDL_Renderer* renderer, SDL_Texture* texture, int x, int
  * @param h Height of the rectangle.
  * @return -1 if an event interrupts the drawing, 0 otherwise.
  */
-int drawAnimatedRectangle(SDL_Renderer* renderer, SDL_Texture *texture, int x, int y, int w, int h, SDL_Color color, char *type) {
+int drawAnimatedRectangle(SDL_Renderer* renderer, SDL_Texture *texture, int x, int y, int w, int h, SDL_Color color, FormType type) {
 
-    if ((strcmp(type, "filled") != 0) && (strcmp(type, "empty") != 0)){
-        printf("Invalid animatedRectangle type: \"%s.\". Must be filled or empty.\n", type);
+    if (type != FORM_FILLED && type != FORM_EMPTY){
+        printf("Invalid animatedRectangle type: %d. Must be filled or empty.\n", (int)type);
         return -1;
     }
     else
     {
         SDL_SetRenderTarget(renderer, texture);
+        setRenderColor(renderer, color);
 
-        if(strcmp(type, "empty") == 0)
-        {
-
-            setRenderColor(renderer, color);
-
-            // Draw the top edge of the rectangle.
-            for (int i = 0; i < w; ++i) {
-                if (handleEvents(renderer, texture) == -1) return -1;
-
-                SDL_RenderDrawPoint(renderer, x + i, y);
-                renderTexture(renderer, texture, 3);
-            }
-
-            // Draw the right edge.
-            for (int j = 0; j < h; ++j) {
-                if (handleEvents(renderer, texture) == -1) return -1;
-
-                SDL_RenderDrawPoint(renderer, x + w - 1, y + j);
-                renderTexture(renderer, texture, 3);
-            }
-
-            // Draw the bottom edge.
-            for (int i = w - 1; i >= 0; --i) {
-                if (handleEvents(renderer, texture) == -1) return -1;
-
-                SDL_RenderDrawPoint(renderer, x + i, y + h - 1);
-                renderTexture(renderer, texture, 3);
-            }
-
-            // Draw the left edge.
-            for (int j = h - 1; j >= 0; --j) {
-                if (handleEvents(renderer, texture) == -1) return -1;
-
-                SDL_RenderDrawPoint(renderer, x, y + j);
-                renderTexture(renderer, texture, 3);
-            }
-
-        }
-        else if(strcmp(type, "filled") == 0)
+        if(type == FORM_EMPTY)
         {
-            setRenderColor(renderer, color);
-
-            for (int i = 0; i < w; ++i) 
-            {
-                if (handleEvents(renderer, texture) == -1) return -1;
-
-                for (int j = 0; j < h; ++j) {
-                    SDL_RenderDrawPoint(renderer, x + i, y + j);
-                }
-                renderTexture(renderer, texture, 3);
-            }
+            // Trace the outline clockwise
+            SegmentList list = {0};
+            if (pushBoxOutline(&list, x, y, w, h) == -1) return -1;
+            if (revealSegments(renderer, texture, &list) == -1) return -1;
         }
         else
         {
-            printf("Invalid animatedRectangle type: \"%s.\". Must be filled or empty.\n", type);
+            // Fill row by row, from top to bottom
+            SpanList spans = {0};
+            if (pushRotatedRectSpans(&spans, x + w / 2.0f, y + h / 2.0f, w, h, 0) == -1) return -1;
+            if (revealSpans(renderer, texture, &spans, color) == -1) return -1;
         }
         SDL_SetRenderTarget(renderer, NULL);
     }
@@ -517,7 +700,7 @@ int drawAnimatedRectangle(SDL_Renderer* renderer, SDL_Texture *texture, int x, i
  * @brief Draws an animated square on the SDL renderer.
  * 
  * This function draws either a filled or empty animated square on the specified renderer.
- * The animation is achieved by drawing the square point by point with a small delay between each point.
+ * The animation is achieved by revealing the square progressively over a fixed duration.
  * 
  * @param renderer The SDL renderer to draw on
  * @param texture The SDL texture to render to
@@ -525,79 +708,38 @@ int drawAnimatedRectangle(SDL_Renderer* renderer, SDL_Texture *texture, int x, i
  * @param y The y-coordinate of the top-left corner of the square
  * @param c The side length of the square in pixels
  * @param color The SDL_Color to use for drawing
- * @param type String specifying the type of square ("filled" or "empty")
+ * @param type Type of square (FORM_FILLED or FORM_EMPTY)
  * 
  * @return Returns 0 on success, -1 on error (invalid type or event handling failure)
  * 
- * @note For "empty" type, only the outline is drawn
- * @note For "filled" type, the entire square is filled
+ * @note For FORM_EMPTY, only the outline is drawn
+ * @note For FORM_FILLED, the entire square is filled
  * @note The animation can be interrupted by SDL events through handleEvents()
  */
-int drawAnimatedSquare(SDL_Renderer* renderer, SDL_Texture *texture, int x, int y, int c, SDL_Color color, char *type) {
+int drawAnimatedSquare(SDL_Renderer* renderer, SDL_Texture *texture, int x, int y, int c, SDL_Color color, FormType type) {
 
-    if ((strcmp(type, "filled") != 0) && (strcmp(type, "empty") != 0)){
-        printf("Invalid animatedSquare type: \"%s.\". Must be filled or empty.\n", type);
+    if (type != FORM_FILLED && type != FORM_EMPTY){
+        printf("Invalid animatedSquare type: %d. Must be filled or empty.\n", (int)type);
         return -1;
     }
     else
     {
         SDL_SetRenderTarget(renderer, texture);
+        setRenderColor(renderer, color);
 
-        if(strcmp(type, "empty") == 0)
-        {
-
-            setRenderColor(renderer, color);
-
-            // Draw the top edge of the rectangle.
-            for (int i = 0; i < c; ++i) {
-                if (handleEvents(renderer, texture) == -1) return -1;
-
-                SDL_RenderDrawPoint(renderer, x + i, y);
-                renderTexture(renderer, texture, 3);
-            }
-
-            // Draw the right edge.
-            for (int j = 0; j < c; ++j) {
-                if (handleEvents(renderer, texture) == -1) return -1;
-
-                SDL_RenderDrawPoint(renderer, x + c - 1, y + j);
-                renderTexture(renderer, texture, 3);
-            }
-
-            // Draw the bottom edge.
-            for (int i = c - 1; i >= 0; --i) {
-                if (handleEvents(renderer, texture) == -1) return -1;
-
-                SDL_RenderDrawPoint(renderer, x + i, y + c - 1);
-                renderTexture(renderer, texture, 3);
-            }
-
-            // Draw the left edge.
-            for (int j = c - 1; j >= 0; --j) {
-                if (handleEvents(renderer, texture) == -1) return -1;
-
-                SDL_RenderDrawPoint(renderer, x, y + j);
-                renderTexture(renderer, texture, 3);
-            }
-
-        }
-        else if(strcmp(type, "filled") == 0)
+        if(type == FORM_EMPTY)
         {
-            setRenderColor(renderer, color);
-
-            for (int i = 0; i < c; ++i) 
-            {
-                if (handleEvents(renderer, texture) == -1) return -1;
-
-                for (int j = 0; j < c; ++j) {
-                    SDL_RenderDrawPoint(renderer, x + i, y + j);
-                }
-                renderTexture(renderer, texture, 3);
-            }
+            // Trace the outline clockwise
+            SegmentList list = {0};
+            if (pushBoxOutline(&list, x, y, c, c) == -1) return -1;
+            if (revealSegments(renderer, texture, &list) == -1) return -1;
         }
         else
         {
-            printf("Invalid animatedRectangle type: \"%s.\". Must be filled or empty.\n", type);
+            // Fill row by row, from top to bottom
+            SpanList spans = {0};
+            if (pushRotatedRectSpans(&spans, x + c / 2.0f, y + c / 2.0f, c, c, 0) == -1) return -1;
+            if (revealSpans(renderer, texture, &spans, color) == -1) return -1;
         }
         SDL_SetRenderTarget(renderer, NULL);
     }
@@ -615,10 +757,10 @@ int drawAnimatedSquare(SDL_Renderer* renderer, SDL_Texture *texture, int x, int
  * @param ry Radius along the y-axis.
  * @return -1 if an event interrupts the drawing, 0 otherwise.
  */
-int drawAnimatedEllipse(SDL_Renderer* renderer, SDL_Texture *texture, int x, int y, int rx, int ry, SDL_Color color, char *type) {
+int drawAnimatedEllipse(SDL_Renderer* renderer, SDL_Texture *texture, int x, int y, int rx, int ry, SDL_Color color, FormType type) {
 
-    if ((strcmp(type, "filled") != 0) && (strcmp(type, "empty") != 0)){
-        printf("Invalid animatedEllipse type: \"%s.\". Must be filled or empty.\n", type);
+    if (type != FORM_FILLED && type != FORM_EMPTY){
+        printf("Invalid animatedEllipse type: %d. Must be filled or empty.\n", (int)type);
         return -1;
     }
     else
@@ -627,48 +769,32 @@ int drawAnimatedEllipse(SDL_Renderer* renderer, SDL_Texture *texture, int x, int
 
         setRenderColor(renderer, color);
 
-        if (strcmp(type, "empty") == 0) 
+        if (type == FORM_FILLED)
         {
-            // Number of steps to approximate the ellipse
-            const int steps = 360;  // More steps = More more precise, but more slow
-            for (int i = 0; i < steps; i++) 
-            {
-                if (handleEvents(renderer, texture) == -1) return -1;
+            // Fill row by row, from top to bottom
+            SpanList spans = {0};
+            if (pushEllipseSpans(&spans, x, y, rx, ry) == -1) return -1;
+            if (revealSpans(renderer, texture, &spans, color) == -1) return -1;
 
-                // Calculate the angle and point on the ellipse's boundary
-                float angle = (i * 2 * M_PI) / steps;
-                int dx = (int)(rx * cos(angle));
-                int dy = (int)(ry * sin(angle));
+            SDL_SetRenderTarget(renderer, NULL);
+            return 0;
+        }
 
-                SDL_RenderDrawPoint(renderer, x + dx, y + dy);
-                renderTexture(renderer, texture, 6);
-            }
-        } 
-        else if (strcmp(type, "filled") == 0) 
+        SegmentList list = {0};
+
+        // Number of steps to approximate the ellipse
+        const int steps = 360;  // More steps = More precise
+        for (int i = 0; i < steps; i++) 
         {
-            const int steps = 360;
-            for (int i = 0; i < steps; i++) 
-            {
-                if (handleEvents(renderer, texture) == -1) return -1;
-
-                float angle = (i * 2 * M_PI) / steps;
-                int dx = (int)(rx * cos(angle));
-                int dy = (int)(ry * sin(angle));
-                
-
-                // Fill the ellipse by drawing points inside its boundary
-                for (int xOffset = -dx; xOffset <= dx; xOffset++) {
-                    if (handleEvents(renderer, texture) == -1) return -1;
-
-                    for (int yOffset = -dy; yOffset <= dy; yOffset++){
-                        if ((xOffset * xOffset * ry * ry + yOffset * yOffset * rx * rx) <= (rx * rx * ry * ry)) {
-                            SDL_RenderDrawPoint(renderer, x + xOffset, y + yOffset);
-                        }
-                    }                
-                }
-                renderTexture(renderer, texture, 6);
-            }
+            // Calculate the angle and point on the ellipse's boundary
+            float angle = (i * 2 * M_PI) / steps;
+            int dx = (int)(rx * cos(angle));
+            int dy = (int)(ry * sin(angle));
+
+            if (pushSegment(&list, x + dx, y + dy, x + dx, y + dy) == -1) return -1;
         }
+
+        if (revealSegments(renderer, texture, &list) == -1) return -1;
         SDL_SetRenderTarget(renderer, NULL);  
     }
     return 0;
@@ -685,11 +811,11 @@ int drawAnimatedEllipse(SDL_Renderer* renderer, SDL_Texture *texture, int x, int
  * @param end_angle Ending angle in degrees.
  * @return -1 if an event interrupts the drawing, 0 otherwise.
  */
-int drawAnimatedArc(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, int radius, int start_angle, int end_angle, SDL_Color color, char *type) {
+int drawAnimatedArc(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y, int radius, int start_angle, int end_angle, SDL_Color color, FormType type) {
     
-    if ((strcmp(type, "filled") != 0) && (strcmp(type, "empty") != 0)){
-        printf("%sExecutionError: Invalid type for animated arc '%s'. Must be 'filled' or 'empty'.\n", 
-               RED_COLOR, type);
+    if (type != FORM_FILLED && type != FORM_EMPTY){
+        printf("%sExecutionError: Invalid type for animated arc %d. Must be 'filled' or 'empty'.\n", 
+               RED_COLOR, (int)type);
         return -1;
     }
     else
@@ -698,30 +824,29 @@ int drawAnimatedArc(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y,
 
         setRenderColor(renderer, color);
 
+        if (type == FORM_FILLED) {
+            // Fill the pie row by row, from top to bottom
+            SpanList spans = {0};
+            if (pushPieSpans(&spans, x, y, radius, start_angle, end_angle) == -1) return -1;
+            if (revealSpans(renderer, texture, &spans, color) == -1) return -1;
+
+            SDL_SetRenderTarget(renderer, NULL);
+            return 0;
+        }
+
         // Convert start and end angles to radians
         double startRad = start_angle * M_PI / 180.0;
         double endRad = end_angle * M_PI / 180.0;
 
-        if (strcmp(type, "empty") == 0) {
-            for (double theta = startRad; theta <= endRad; theta += 0.01) {
-                int px = (int)(radius * cos(theta));
-                int py = (int)(radius * sin(theta));
-                SDL_RenderDrawPoint(renderer, x + px, y - py);
-                renderTexture(renderer, texture, 5);
-                if (handleEvents(renderer, texture) == -1) return -1;
-            }
-        }
-        else if (strcmp(type, "filled") == 0) {
-            for (int currentRadius = 0; currentRadius <= radius; ++currentRadius) {
-                for (double angle = startRad; angle <= endRad; angle += 0.01) {
-                    int px = x + (int)(currentRadius * cos(angle));
-                    int py = y + (int)(currentRadius * sin(angle));
-                    SDL_RenderDrawLine(renderer, x, y, px, py);
-                }
-                renderTexture(renderer, texture, 5);
-                if (handleEvents(renderer, texture) == -1) return -1;
-            }
+        SegmentList list = {0};
+
+        for (double theta = startRad; theta <= endRad; theta += 0.01) {
+            int px = (int)(radius * cos(theta));
+            int py = (int)(radius * sin(theta));
+            if (pushSegment(&list, x + px, y - py, x + px, y - py) == -1) return -1;
         }
+
+        if (revealSegments(renderer, texture, &list) == -1) return -1;
         SDL_SetRenderTarget(renderer, NULL); 
     }
     return 0;
@@ -730,8 +855,8 @@ int drawAnimatedArc(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y,
 /**
  * @brief Draws an animated triangle on the renderer with specified parameters
  *
- * This function draws an animated triangle either filled or empty. The triangle is drawn
- * with animation effects by rendering points/lines progressively.
+ * This function draws an animated triangle either filled or empty. The triangle is
+ * revealed progressively over a fixed duration.
  *
  * @param renderer The SDL renderer to draw on
  * @param texture The SDL texture to draw on
@@ -739,7 +864,7 @@ int drawAnimatedArc(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y,
  * @param cy Y coordinate of the center of the triangle  
  * @param radius The radius of the circumscribed circle of the triangle
  * @param color The color to draw the triangle with
- * @param type String specifying whether triangle should be "filled" or "empty"
+ * @param type FORM_FILLED or FORM_EMPTY
  *
  * @return Returns 0 on success, -1 on error (invalid type)
  *
@@ -747,12 +872,12 @@ int drawAnimatedArc(SDL_Renderer *renderer, SDL_Texture *texture, int x, int y,
  * @note For empty triangles, the outline is drawn using Bresenham's line algorithm
  * @note For filled triangles, scan line algorithm is used for filling
  */
-int drawAnimatedTriangle(SDL_Renderer *renderer, SDL_Texture *texture, int cx, int cy, int radius, SDL_Color color, char *type) 
+int drawAnimatedTriangle(SDL_Renderer *renderer, SDL_Texture *texture, int cx, int cy, int radius, SDL_Color color, FormType type) 
 {
     
-    if ((strcmp(type, "filled") != 0) && (strcmp(type, "empty") != 0)) {
-        printf("%sExecutionError: Invalid type for animated polygon '%s'. Must be 'filled' or 'empty'.\n", 
-               RED_COLOR, type);
+    if (type != FORM_FILLED && type != FORM_EMPTY) {
+        printf("%sExecutionError: Invalid type for animated polygon %d. Must be 'filled' or 'empty'.\n", 
+               RED_COLOR, (int)type);
         return -1;
     } 
     
@@ -774,74 +899,14 @@ int drawAnimatedTriangle(SDL_Renderer *renderer, SDL_Texture *texture, int cx, i
 
         setRenderColor(renderer, color);
 
-        if (strcmp(type, "empty") == 0) {
-            // draw the contours of the polygon
-            for (int i = 0; i < sides; i++) 
-            {
-                int x1 = vx[i];
-                int y1 = vy[i];
-                int x2 = vx[(i + 1) % sides];
-                int y2 = vy[(i + 1) % sides];
-
-                int dx = abs(x2 - x1), sx = x1 < x2 ? 1 : -1;
-                int dy = -abs(y2 - y1), sy = y1 < y2 ? 1 : -1; 
-                int err = dx + dy, e2;
-
-                while (1) {
-                    if (handleEvents(renderer, texture) == -1) return -1;
-                    SDL_RenderDrawPoint(renderer, x1, y1);
-                    renderTexture(renderer, texture, 2);
-
-                    if (x1 == x2 && y1 == y2) break;
-                    e2 = 2 * err;
-                    if (e2 >= dy) { err += dy; x1 += sx; }
-                    if (e2 <= dx) { err += dx; y1 += sy; }
-                }
-            }
-        } 
-        else if (strcmp(type, "filled") == 0) {
-            // Fill in the polygon by drawing horizontal lines
-            int ymin = vy[0], ymax = vy[0];
-            for (int i = 1; i < sides; i++) {
-                if (vy[i] < ymin) ymin = vy[i];
-                if (vy[i] > ymax) ymax = vy[i];
-            }
-
-            for (int y = ymin; y <= ymax; y++) {
-                int intersections[12]; // Intersection points for a horizontal line
-                int count = 0;
-
-                // Calculate the points of intersection between the horizontal line and each edge
-                for (int i = 0; i < sides; i++) {
-                    int x1 = vx[i], y1 = vy[i];
-                    int x2 = vx[(i + 1) % sides], y2 = vy[(i + 1) % sides];
-
-                    if ((y1 <= y && y2 > y) || (y2 <= y && y1 > y)) { // Intersects the horizontal line
-                        int x = x1 + (y - y1) * (x2 - x1) / (y2 - y1);
-                        intersections[count++] = x;
-                    }
-                }
-
-                // Sort intersections in ascending order
-                for (int i = 0; i < count - 1; i++) {
-                    for (int j = i + 1; j < count; j++) {
-                        if (intersections[i] > intersections[j]) {
-                            int temp = intersections[i];
-                            intersections[i] = intersections[j];
-                            intersections[j] = temp;
-                        }
-                    }
-                }
-
-                // Draw lines between pairs of intersections
-                for (int i = 0; i < count; i += 2) {
-                    if (handleEvents(renderer, texture) == -1) return -1;
-                    for (int x = intersections[i]; x <= intersections[i + 1]; x++) {
-                        SDL_RenderDrawPoint(renderer, x, y);
-                    }
-                    renderTexture(renderer, texture, 4);
-                }
-            }
+        if (type == FORM_EMPTY) {
+            SegmentList list = {0};
+            if (pushPolygonOutline(&list, vx, vy, sides) == -1) return -1;
+            if (revealSegments(renderer, texture, &list) == -1) return -1;
+        } else {
+            SpanList spans = {0};
+            if (pushPolygonFill(&spans, vx, vy, sides) == -1) return -1;
+            if (revealSpans(renderer, texture, &spans, color) == -1) return -1;
         }
         SDL_SetRenderTarget(renderer, NULL); 
     } 
@@ -857,12 +922,12 @@ int drawAnimatedTriangle(SDL_Renderer *renderer, SDL_Texture *texture, int cx, i
  * @param sides Number of sides of the polygon (minimum 3).
  * @return -1 if an event interrupts the drawing, 0 otherwise.
  */
-int drawAnimatedCustomPolygon(SDL_Renderer *renderer, SDL_Texture *texture, int cx, int cy, int radius, int sides, SDL_Color color, char *type) 
+int drawAnimatedCustomPolygon(SDL_Renderer *renderer, SDL_Texture *texture, int cx, int cy, int radius, int sides, SDL_Color color, FormType type) 
 {
     
-    if ((strcmp(type, "filled") != 0) && (strcmp(type, "empty") != 0)) {
-        printf("%sExecutionError: Invalid type for animated polygon '%s'. Must be 'filled' or 'empty'.\n", 
-               RED_COLOR, type);
+    if (type != FORM_FILLED && type != FORM_EMPTY) {
+        printf("%sExecutionError: Invalid type for animated polygon %d. Must be 'filled' or 'empty'.\n", 
+               RED_COLOR, (int)type);
         return -1;
     } 
     else if (sides < 3 || sides > 12) {
@@ -887,74 +952,14 @@ int drawAnimatedCustomPolygon(SDL_Renderer *renderer, SDL_Texture *texture, int
 
         setRenderColor(renderer, color);
 
-        if (strcmp(type, "empty") == 0) {
-            // draw the contours of the polygon
-            for (int i = 0; i < sides; i++) 
-            {
-                int x1 = vx[i];
-                int y1 = vy[i];
-                int x2 = vx[(i + 1) % sides];
-                int y2 = vy[(i + 1) % sides];
-
-                int dx = abs(x2 - x1), sx = x1 < x2 ? 1 : -1;
-                int dy = -abs(y2 - y1), sy = y1 < y2 ? 1 : -1; 
-                int err = dx + dy, e2;
-
-                while (1) {
-                    if (handleEvents(renderer, texture) == -1) return -1;
-                    SDL_RenderDrawPoint(renderer, x1, y1);
-                    renderTexture(renderer, texture, 2);
-
-                    if (x1 == x2 && y1 == y2) break;
-                    e2 = 2 * err;
-                    if (e2 >= dy) { err += dy; x1 += sx; }
-                    if (e2 <= dx) { err += dx; y1 += sy; }
-                }
-            }
-        } 
-        else if (strcmp(type, "filled") == 0) {
-            // Fill in the polygon by drawing horizontal lines
-            int ymin = vy[0], ymax = vy[0];
-            for (int i = 1; i < sides; i++) {
-                if (vy[i] < ymin) ymin = vy[i];
-                if (vy[i] > ymax) ymax = vy[i];
-            }
-
-            for (int y = ymin; y <= ymax; y++) {
-                int intersections[12]; // Intersection points for a horizontal line
-                int count = 0;
-
-                // Calculate the points of intersection between the horizontal line and each edge
-                for (int i = 0; i < sides; i++) {
-                    int x1 = vx[i], y1 = vy[i];
-                    int x2 = vx[(i + 1) % sides], y2 = vy[(i + 1) % sides];
-
-                    if ((y1 <= y && y2 > y) || (y2 <= y && y1 > y)) { // Intersects the horizontal line
-                        int x = x1 + (y - y1) * (x2 - x1) / (y2 - y1);
-                        intersections[count++] = x;
-                    }
-                }
-
-                // Sort intersections in ascending order
-                for (int i = 0; i < count - 1; i++) {
-                    for (int j = i + 1; j < count; j++) {
-                        if (intersections[i] > intersections[j]) {
-                            int temp = intersections[i];
-                            intersections[i] = intersections[j];
-                            intersections[j] = temp;
-                        }
-                    }
-                }
-
-                // Draw lines between pairs of intersections
-                for (int i = 0; i < count; i += 2) {
-                    if (handleEvents(renderer, texture) == -1) return -1;
-                    for (int x = intersections[i]; x <= intersections[i + 1]; x++) {
-                        SDL_RenderDrawPoint(renderer, x, y);
-                    }
-                    renderTexture(renderer, texture, 4);
-                }
-            }
+        if (type == FORM_EMPTY) {
+            SegmentList list = {0};
+            if (pushPolygonOutline(&list, vx, vy, sides) == -1) return -1;
+            if (revealSegments(renderer, texture, &list) == -1) return -1;
+        } else {
+            SpanList spans = {0};
+            if (pushPolygonFill(&spans, vx, vy, sides) == -1) return -1;
+            if (revealSpans(renderer, texture, &spans, color) == -1) return -1;
         }
         SDL_SetRenderTarget(renderer, NULL); 
     } 
@@ -972,10 +977,10 @@ int drawAnimatedCustomPolygon(SDL_Renderer *renderer, SDL_Texture *texture, int
  * @param thickness Thickness of the line.
  * @return -1 if an event interrupts the drawing, 0 otherwise.
  */
-int drawAnimatedLine(SDL_Renderer *renderer, SDL_Texture *texture, int x1, int y1, int x2, int y2, int thickness, SDL_Color color, char *type) {
-    if ((strcmp(type, "filled") != 0) && (strcmp(type, "empty") != 0)) {
-        printf("%sExecutionError: Invalid type for line '%s'. Must be 'filled' or 'empty'.\n", 
-               RED_COLOR, type);
+int drawAnimatedLine(SDL_Renderer *renderer, SDL_Texture *texture, int x1, int y1, int x2, int y2, int thickness, SDL_Color color, FormType type) {
+    if (type != FORM_FILLED && type != FORM_EMPTY) {
+        printf("%sExecutionError: Invalid type for line %d. Must be 'filled' or 'empty'.\n", 
+               RED_COLOR, (int)type);
         return -1;
     }
 
@@ -993,44 +998,48 @@ int drawAnimatedLine(SDL_Renderer *renderer, SDL_Texture *texture, int x1, int y
     double angle = atan2(dy, dx);
     double perpendicular = angle + M_PI/2;
 
-    // Increase steps even more for perfect continuity
-    int steps = (int)(length * 5); // Triple the steps for perfect continuity
+    // One step per pixel of length: consecutive pieces share their end points, so the line stays continuous
+    int steps = (int)ceil(length);
     double stepX = dx / steps;
     double stepY = dy / steps;
 
-    double currentX = x1;
-    double currentY = y1;
-    double lastX = x1;
-    double lastY = y1;
+    if (type == FORM_FILLED) {
+        // One slice of the thick line per step: neighbours share an edge, so no pixel is filled twice
+        double offsetX = thickness / 2.0 * cos(perpendicular);
+        double offsetY = thickness / 2.0 * sin(perpendicular);
+        SpanList spans = {0};
+
+        for (int i = 0; i < steps; i++) {
+            double lastX = x1 + stepX * i;
+            double lastY = y1 + stepY * i;
+            double currentX = x1 + stepX * (i + 1);
+            double currentY = y1 + stepY * (i + 1);
+
+            SDL_FPoint slice[4] = {
+                {lastX - offsetX, lastY - offsetY}, {currentX - offsetX, currentY - offsetY},
+                {currentX + offsetX, currentY + offsetY}, {lastX + offsetX, lastY + offsetY}
+            };
+            if (pushConvexSpans(&spans, slice, 4) == -1) return -1;
+        }
 
-    for (int i = 0; i <= steps; i++) {
-        if (handleEvents(renderer, texture) == -1) return -1;
+        if (revealSpans(renderer, texture, &spans, color) == -1) return -1;
+        SDL_SetRenderTarget(renderer, NULL);
+        return 0;
+    }
 
-        if (strcmp(type, "filled") == 0) {
-            // Draw with increased density for thickness
-            for (int t = -thickness/2; t <= thickness/2; t++) {
-                double offsetX = t * cos(perpendicular);
-                double offsetY = t * sin(perpendicular);
-                
-                SDL_RenderDrawLine(renderer, 
-                    lastX + offsetX, lastY + offsetY,
-                    currentX + offsetX, currentY + offsetY
-                );
-                // Add extra points for perfect coverage
-                SDL_RenderDrawPoint(renderer, currentX + offsetX, currentY + offsetY);
-            }
-        } else {
-            SDL_RenderDrawLine(renderer, lastX, lastY, currentX, currentY);
-        }
+    SegmentList list = {0};
 
-        renderTexture(renderer, texture, 3);
+    for (int i = 0; i < steps; i++) {
+        double lastX = x1 + stepX * i;
+        double lastY = y1 + stepY * i;
+        double currentX = x1 + stepX * (i + 1);
+        double currentY = y1 + stepY * (i + 1);
 
-        lastX = currentX;
-        lastY = currentY;
-        currentX = x1 + stepX * (i + 1);
-        currentY = y1 + stepY * (i + 1);
+        if (pushSegment(&list, lastX, lastY, currentX, currentY) == -1) return -1;
     }
 
+    if (revealSegments(renderer, texture, &list) == -1) return -1;
+
     SDL_SetRenderTarget(renderer, NULL);
     return 0;
 }
@@ -1038,261 +1047,271 @@ int drawAnimatedLine(SDL_Renderer *renderer, SDL_Texture *texture, int x1, int y
 
 
 
+#define DRAW_SHAPES_CHUNK 64   // Shapes drawn before they are registered together
+
+// Names given to drawShape, indexed by ShapeType
+static const char *shapeNames[] = {"circle", "ellipse", "arc", "rectangle", "polygon", "triangle", "square", "line"};
+static const int shapeArgCounts[] = {3, 4, 5, 4, 4, 3, 3, 5};
+#define SHAPE_TYPE_COUNT (int)(sizeof(shapeNames) / sizeof(shapeNames[0]))
+
 /**
- * @brief Draws and registers a shape based on the specified parameters.
- *
- * @param shape String representing the type of shape to draw ("circle", "rectangle", "arc", etc.).
- * @param mode Drawing mode: "animated" for progressive drawing or any other value for instant drawing.
- * @param ... Variable arguments based on the shape:
- *      - "circle": int x, int y, int radius
- *      - "rectangle": int x, int y, int w, int h
- *      - "arc": int x, int y, int radius, int start_angle, int end_angle
- *      - "roundedRectangle": (animated) int x, int y, int w, int h, int radius 
- *                            (instant) Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Sint16 radius
- *      - "ellipse": int x, int y, int rx, int ry
- *      - "line": Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint8 thickness
- *      - "polygon": int cx, int cy, int radius, int sides
+ * @brief Checks a shape description before anything is drawn.
  *
- * @return void
- *
- * @details
- * This function handles the rendering and registration of different shapes.
- * It uses variadic arguments (`...`) to dynamically adapt to the parameters
- * required for each shape type. The function:
- * - Sets the target texture for rendering.
- * - Verifies the drawing mode ("animated" or instant).
- * - Calls the appropriate drawing function based on the shape type.
- * - Registers the drawn shape in a global shape list for further operations like transformation or selection.
- * - Restores the default rendering target after drawing.
- *
- * @note Each shape has specific constraints:
- * - The radius for "circle" and "arc" must be >= 5 to avoid rendering issues.
- * - Angles for "arc" must be within [0, 360].
- * - "polygon" must have a minimum of 3 sides and a reasonable number of sides for proper rendering.
- * - Ensure that "type" is either "filled" or "empty".
+ * @return 0 if the shape can be drawn, -1 (with an error printed) otherwise.
  */
-int drawShape(SDL_Renderer *renderer, SDL_Texture *texture, char *shape, char *mode, char *type, SDL_Color color, ...) {
-    Shape newShape;
-    newShape.selected = false;
-    newShape.color = color;
-    newShape.typeForm = type;
-    newShape.rotation = 0;
-    newShape.isAnimating = false;
-    newShape.zoom = 1.0f;
-    newShape.zoom_direction = 1.0f;
-    newShape.bounce_velocity = 0;
-    newShape.bounce_direction = 0;
-
-    newShape.animations[0] = ANIM_NONE;
-    newShape.animations[1] = ANIM_NONE;
-    newShape.animations[2] = ANIM_NONE;
-    newShape.num_animations = 0;
-    newShape.animation_parser = ANIM_NONE;
-
-    // Set shape type based on parameter
-    if (strcmp(shape, "circle") == 0) {
-        newShape.type = SHAPE_CIRCLE;
-    } else if (strcmp(shape, "rectangle") == 0) {
-        newShape.type = SHAPE_RECTANGLE;
-    } else if (strcmp(shape, "arc") == 0) {
-        newShape.type = SHAPE_ARC;
-    } else if (strcmp(shape, "ellipse") == 0) {
-        newShape.type = SHAPE_ELLIPSE;
-    } else if (strcmp(shape, "line") == 0) {
-        newShape.type = SHAPE_LINE;
-    } else if (strcmp(shape, "polygon") == 0) {
-        newShape.type = SHAPE_POLYGON;
-    } else if (strcmp(shape, "triangle") == 0) {
-        newShape.type = SHAPE_TRIANGLE;
-    } else if (strcmp(shape, "square") == 0) {
-        newShape.type = SHAPE_SQUARE;
+static int validateShapeDesc(const ShapeDesc *desc) {
+    if ((int)desc->shape < 0 || (int)desc->shape >= SHAPE_TYPE_COUNT) {
+        printf("%sExecutionError: Invalid shape type %d.\n", RED_COLOR, (int)desc->shape);
+        return -1;
+    }
+    if (desc->mode != DRAW_MODE_INSTANT && desc->mode != DRAW_MODE_ANIMATED) {
+        printf("%sExecutionError: Invalid %s mode %d.\n", RED_COLOR, shapeNames[desc->shape], (int)desc->mode);
+        return -1;
+    }
+    if (desc->type != FORM_FILLED && desc->type != FORM_EMPTY) {
+        printf("%sExecutionError: Invalid %s type %d. Must be filled or empty.\n", RED_COLOR, shapeNames[desc->shape], (int)desc->type);
+        return -1;
+    }
+    if (desc->shape == SHAPE_POLYGON && (desc->args[3] < 3 || desc->args[3] > POLYGON_MAX_SIDES)) {
+        printf("%sExecutionError: Invalid number of polygon sides %d. Must be between 3 and %d.\n",
+               RED_COLOR, desc->args[3], POLYGON_MAX_SIDES);
+        return -1;
+    }
+    if (desc->shape == SHAPE_ELLIPSE && desc->args[3] == 0) {
+        printf("%sExecutionError: Invalid ellipse vertical radius 0.\n", RED_COLOR);
+        return -1;
     }
+    return 0;
+}
 
-    va_list args;
-    va_start(args, color);// Initialize the variable argument list with the last named parameter
-    
-    // Set the texture as the rendering target.
-    SDL_SetRenderTarget(renderer, texture);
+/**
+ * @brief Builds the shape a description registers.
+ *
+ * Arc radii below 5 are raised to 5 and arc angles are clamped to [0, 360] and ordered,
+ * the drawn arc uses the same values.
+ */
+static void buildShape(const ShapeDesc *desc, Shape *shape) {
+    const int *a = desc->args;
+
+    *shape = (Shape){0};
+    shape->type = desc->shape;
+    shape->color = desc->color;
+    shape->typeForm = desc->type;
+    shape->zoom = 1.0f;
+    shape->zoom_direction = 1.0f;
+    shape->animations[0] = ANIM_NONE;
+    shape->animations[1] = ANIM_NONE;
+    shape->animations[2] = ANIM_NONE;
+    shape->animation_parser = ANIM_NONE;
+
+    switch (desc->shape) {
+        case SHAPE_CIRCLE:
+            shape->data.circle.x = a[0];
+            shape->data.circle.y = a[1];
+            shape->data.circle.radius = a[2];
+            break;
+        case SHAPE_RECTANGLE:
+            shape->data.rectangle.x = a[0];
+            shape->data.rectangle.y = a[1];
+            shape->data.rectangle.width = a[2];
+            shape->data.rectangle.height = a[3];
+            break;
+        case SHAPE_SQUARE:
+            shape->data.square.x = a[0];
+            shape->data.square.y = a[1];
+            shape->data.square.c = a[2];
+            break;
+        case SHAPE_ARC: {
+            int startAngle = fmax(0, fmin(360, a[3]));
+            int endAngle = fmax(0, fmin(360, a[4]));
+            shape->data.arc.x = a[0];
+            shape->data.arc.y = a[1];
+            shape->data.arc.radius = a[2] < 5 ? 5 : a[2];
+            shape->data.arc.start_angle = startAngle < endAngle ? startAngle : endAngle;
+            shape->data.arc.end_angle = startAngle < endAngle ? endAngle : startAngle;
+            break;
+        }
+        case SHAPE_ELLIPSE:
+            shape->data.ellipse.x = a[0];
+            shape->data.ellipse.y = a[1];
+            shape->data.ellipse.rx = a[2];
+            shape->data.ellipse.ry = a[3];
+            shape->data.ellipse.aspect_ratio = a[2] / a[3];
+            break;
+        case SHAPE_LINE:
+            shape->data.line.x1 = (Sint16)a[0];
+            shape->data.line.y1 = (Sint16)a[1];
+            shape->data.line.x2 = (Sint16)a[2];
+            shape->data.line.y2 = (Sint16)a[3];
+            shape->data.line.thickness = (Uint8)a[4];
+            break;
+        case SHAPE_POLYGON:
+            shape->data.polygon.cx = a[0];
+            shape->data.polygon.cy = a[1];
+            shape->data.polygon.radius = a[2];
+            shape->data.polygon.sides = a[3];
+            break;
+        case SHAPE_TRIANGLE:
+            shape->data.triangle.cx = a[0];
+            shape->data.triangle.cy = a[1];
+            shape->data.triangle.radius = a[2];
+            break;
+    }
+}
 
-    // Determine if the shape should be drawn with animation.
-    int isAnimated = (strcmp(mode, "animated") == 0);
+/**
+ * @brief Draws a built shape onto the texture, progressively if animated.
+ *
+ * @return 0 on success, -1 if the draw failed.
+ */
+static int rasterizeShape(SDL_Renderer *renderer, SDL_Texture *texture, const Shape *shape, bool animated) {
+    SDL_Color color = shape->color;
+    FormType type = shape->typeForm;
 
-    // Handle drawing for each shape type.
-    if (strcmp(shape, "circle") == 0) {
-        // Extract arguments specific
-        int x = va_arg(args, int);
-        int y = va_arg(args, int);
-        int radius = va_arg(args, int);
+    // The draw functions leave the default target behind them
+    SDL_SetRenderTarget(renderer, texture);
 
-        // Call the appropriate drawing function based on the mode.
-        if (isAnimated) {
-            if(drawAnimatedCircle(renderer, texture, x, y, radius, color, type) == -1) return -1;
-        } else {
-            if(drawCircle(renderer, texture, x, y, radius, color, type) == -1) return -1;
+    switch (shape->type) {
+        case SHAPE_CIRCLE: {
+            int x = shape->data.circle.x, y = shape->data.circle.y, radius = shape->data.circle.radius;
+            return animated ? drawAnimatedCircle(renderer, texture, x, y, radius, color, type)
+                            : drawCircle(renderer, texture, x, y, radius, color, type);
         }
-
-        // Register the circle shape in the shapes list.
-        newShape.data.circle.x = x;
-        newShape.data.circle.y = y;
-        newShape.data.circle.radius = radius;
-        
-        addShape(newShape);
-
-    } 
-    else if (strcmp(shape, "rectangle") == 0) {
-        int x = va_arg(args, int);
-        int y = va_arg(args, int);
-        int w = va_arg(args, int);
-        int h = va_arg(args, int);
-
-        if (isAnimated) {
-            if(drawAnimatedRectangle(renderer, texture, x, y, w, h, color, type) == -1) return -1;
-        } else {
-            if(drawRectangle(renderer, texture, x, y, w, h, color, type) == -1) return -1;
+        case SHAPE_RECTANGLE: {
+            int x = shape->data.rectangle.x, y = shape->data.rectangle.y;
+            int w = shape->data.rectangle.width, h = shape->data.rectangle.height;
+            return animated ? drawAnimatedRectangle(renderer, texture, x, y, w, h, color, type)
+                            : drawRectangle(renderer, texture, x, y, w, h, color, type);
         }
-
-        newShape.data.rectangle.x = x;
-        newShape.data.rectangle.y = y;
-        newShape.data.rectangle.width = w;
-        newShape.data.rectangle.height = h;
-
-        addShape(newShape);
-    } 
-    else if (strcmp(shape, "square") == 0) {
-        int x = va_arg(args, int);
-        int y = va_arg(args, int);
-        int c = va_arg(args, int);
-
-        if (isAnimated) {
-            if(drawAnimatedSquare(renderer, texture, x, y, c, color, type) == -1) return -1;
-        } else {
-            if(drawSquare(renderer, texture, x, y, c, color, type) == -1) return -1;
+        case SHAPE_SQUARE: {
+            int x = shape->data.square.x, y = shape->data.square.y, c = shape->data.square.c;
+            return animated ? drawAnimatedSquare(renderer, texture, x, y, c, color, type)
+                            : drawSquare(renderer, texture, x, y, c, color, type);
         }
-
-        newShape.data.square.x = x;
-        newShape.data.square.y = y;
-        newShape.data.square.c = c;
-
-        addShape(newShape);
-    }
-    else if (strcmp(shape, "arc") == 0) {
-        // Extract arc parameters.
-        int x = va_arg(args, int);
-        int y = va_arg(args, int);
-        int radius = va_arg(args, int);
-
-        // Ensure a minimum radius.
-        if (radius < 5) radius = 5;
-
-        // Handle the start and end angles.
-        int start_angle = va_arg(args, int);
-        start_angle = fmax(0, fmin(360, start_angle));
-        int end_angle = va_arg(args, int);
-        end_angle = fmax(0, fmin(360, end_angle));
-
-        // Swap angles if necessary.
-        if (start_angle > end_angle) {
-            int temp = start_angle;
-            start_angle = end_angle;
-            end_angle = temp;
+        case SHAPE_ARC: {
+            int x = shape->data.arc.x, y = shape->data.arc.y, radius = shape->data.arc.radius;
+            int start = shape->data.arc.start_angle, end = shape->data.arc.end_angle;
+            return animated ? drawAnimatedArc(renderer, texture, x, y, radius, start, end, color, type)
+                            : drawArc(renderer, texture, x, y, radius, start, end, color, type);
         }
-
-        if (isAnimated) {
-            if(drawAnimatedArc(renderer, texture, x, y, radius, start_angle, end_angle, color, type) == -1) return -1;
-        } else {
-            if(drawArc(renderer, texture, x, y, radius, start_angle, end_angle, color, type) == -1) return -1;
+        case SHAPE_ELLIPSE: {
+            int x = shape->data.ellipse.x, y = shape->data.ellipse.y;
+            int rx = shape->data.ellipse.rx, ry = shape->data.ellipse.ry;
+            return animated ? drawAnimatedEllipse(renderer, texture, x, y, rx, ry, color, type)
+                            : drawEllipse(renderer, texture, x, y, rx, ry, color, type);
         }
-
-        newShape.data.arc.x = x;
-        newShape.data.arc.y = y;
-        newShape.data.arc.radius = radius;
-        newShape.data.arc.start_angle = start_angle;
-        newShape.data.arc.end_angle = end_angle;
-
-        addShape(newShape);
-    } 
-    else if (strcmp(shape, "ellipse") == 0) {
-        int x = va_arg(args, int);
-        int y = va_arg(args, int);
-        int rx = va_arg(args, int);
-        int ry = va_arg(args, int);
-
-        if (isAnimated) {
-            if(drawAnimatedEllipse(renderer, texture, x, y, rx, ry, color, type) == -1) return -1;
-        } else {
-            if(drawEllipse(renderer, texture, x, y, rx, ry, color, type) == -1) return -1;
+        case SHAPE_LINE: {
+            Sint16 x1 = shape->data.line.x1, y1 = shape->data.line.y1;
+            Sint16 x2 = shape->data.line.x2, y2 = shape->data.line.y2;
+            Uint8 thick = shape->data.line.thickness;
+            return animated ? drawAnimatedLine(renderer, texture, x1, y1, x2, y2, thick, color, type)
+                            : drawLine(renderer, texture, x1, y1, x2, y2, thick, color, type);
         }
-
-        newShape.data.ellipse.x = x;
-        newShape.data.ellipse.y = y;
-        newShape.data.ellipse.rx = rx;
-        newShape.data.ellipse.ry = ry;
-        newShape.data.ellipse.aspect_ratio = rx/ry;
-
-        addShape(newShape);
-    } 
-    else if (strcmp(shape, "line") == 0) {
-        Sint16 x1 = va_arg(args, int);
-        Sint16 y1 = va_arg(args, int);
-        Sint16 x2 = va_arg(args, int);
-        Sint16 y2 = va_arg(args, int);
-        Uint8 thick = va_arg(args, int);
-
-        if (isAnimated) {
-            if(drawAnimatedLine(renderer, texture, x1, y1, x2, y2, thick, color, type) == -1) return -1;
-        } else {
-            if(drawLine(renderer, texture, x1, y1, x2, y2, thick, color, type) == -1) return -1;
+        case SHAPE_POLYGON: {
+            int cx = shape->data.polygon.cx, cy = shape->data.polygon.cy;
+            int radius = shape->data.polygon.radius, sides = shape->data.polygon.sides;
+            return animated ? drawAnimatedCustomPolygon(renderer, texture, cx, cy, radius, sides, color, type)
+                            : drawCustomPolygon(renderer, texture, cx, cy, radius, sides, color, type);
         }
-
-        newShape.data.line.x1 = x1;
-        newShape.data.line.y1 = y1;
-        newShape.data.line.x2 = x2;
-        newShape.data.line.y2 = y2;
-        newShape.data.line.thickness = thick;
-
-        addShape(newShape);
-    } 
-    else if (strcmp(shape, "polygon") == 0) {
-        int cx = va_arg(args, int);
-        int cy = va_arg(args, int);
-        int radius = va_arg(args, int);
-        int sides = va_arg(args, int);
-
-        if (isAnimated) {
-            if(drawAnimatedCustomPolygon(renderer, texture, cx, cy, radius, sides, color, type) == -1) return -1;
-        } else {
-            if(drawCustomPolygon(renderer, texture, cx, cy, radius, sides, color, type) == -1) return -1;
+        case SHAPE_TRIANGLE: {
+            int cx = shape->data.triangle.cx, cy = shape->data.triangle.cy, radius = shape->data.triangle.radius;
+            return animated ? drawAnimatedTriangle(renderer, texture, cx, cy, radius, color, type)
+                            : drawTriangle(renderer, texture, cx, cy, radius, color, type);
         }
+    }
+    return -1;
+}
 
-        newShape.data.polygon.cx = cx;
-        newShape.data.polygon.cy = cy;
-        newShape.data.polygon.radius = radius;
-        newShape.data.polygon.sides = sides;
+/**
+ * @brief Validates, draws and registers a run of shapes.
+ *
+ * @param renderer The SDL renderer used for drawing.
+ * @param texture The target texture for drawing.
+ * @param descs The shapes, drawn in order (each one on top of the previous ones).
+ * @param n The number of shapes.
+ * @param flags DRAW_SHAPES_DEFAULT, or DRAW_SHAPES_REGISTER_ONLY to skip the drawing.
+ *
+ * @return 0 on success, -1 if a shape is invalid (then none is drawn) or failed to draw
+ *         (then the shapes before it are drawn and registered).
+ *
+ * @details
+ * Every description is validated before the first draw. The shapes are then drawn in
+ * order and registered in chunks through addShapes, so the store grows once per chunk
+ * instead of once per shape. Animated and instant draws present as they would through
+ * drawShape, and a captured scene (see setDrawCapture) is only registered.
+ */
+int drawShapes(SDL_Renderer *renderer, SDL_Texture *texture, const ShapeDesc *descs, size_t n, Uint32 flags) {
+    for (size_t i = 0; i < n; i++) {
+        if (validateShapeDesc(&descs[i]) != 0) return -1;
+    }
 
-        addShape(newShape);
-    } 
-    else if (strcmp(shape, "triangle") == 0) {
-        int cx = va_arg(args, int);
-        int cy = va_arg(args, int);
-        int radius = va_arg(args, int);
+    // While the scene host captures a reloaded scene, shapes are only registered
+    bool isDrawn = !(flags & DRAW_SHAPES_REGISTER_ONLY) && !isDrawCaptured();
 
-        if (isAnimated) {
-            if(drawAnimatedTriangle(renderer, texture, cx, cy, radius, color, type) == -1) return -1;
-        } else {
-            if(drawTriangle(renderer, texture, cx, cy, radius, color, type) == -1) return -1;
-        }
+    Shape chunk[DRAW_SHAPES_CHUNK];
+    int pending = 0;
+    for (size_t i = 0; i < n; i++) {
+        buildShape(&descs[i], &chunk[pending]);
 
-        newShape.data.triangle.cx = cx;
-        newShape.data.triangle.cy = cy;
-        newShape.data.triangle.radius = radius;
+        if (isDrawn && rasterizeShape(renderer, texture, &chunk[pending], descs[i].mode == DRAW_MODE_ANIMATED) == -1) {
+            addShapes(chunk, pending);
+            printf("%sExecutionError: Failed to draw %s.\n", RED_COLOR, shapeNames[descs[i].shape]);
+            return -1;
+        }
 
-        addShape(newShape);
+        if (++pending == DRAW_SHAPES_CHUNK) {
+            if (addShapes(chunk, pending) != pending) return -1;
+            pending = 0;
+        }
     }
+    if (addShapes(chunk, pending) != pending) return -1;
 
     // Restore the default rendering target.
     SDL_SetRenderTarget(renderer, NULL);
+    return 0;
+}
+
+/**
+ * @brief Draws and registers a shape based on the specified parameters.
+ *
+ * @param shape Type of shape to draw (SHAPE_CIRCLE, SHAPE_RECTANGLE, SHAPE_ARC, etc.).
+ * @param mode Drawing mode: DRAW_MODE_ANIMATED for progressive drawing or DRAW_MODE_INSTANT.
+ * @param type FORM_FILLED or FORM_EMPTY.
+ * @param ... Variable int arguments based on the shape:
+ *      - SHAPE_CIRCLE: x, y, radius
+ *      - SHAPE_RECTANGLE: x, y, w, h
+ *      - SHAPE_ARC: x, y, radius, start_angle, end_angle
+ *      - SHAPE_ELLIPSE: x, y, rx, ry
+ *      - SHAPE_LINE: x1, y1, x2, y2, thickness
+ *      - SHAPE_POLYGON: cx, cy, radius, sides
+ *      - SHAPE_TRIANGLE and SHAPE_SQUARE: x, y, size
+ *
+ * @return void
+ *
+ * @details
+ * This function packs its variadic arguments (`...`) into a ShapeDesc
+ * and hands it to drawShapes, which validates, draws and registers it. Code drawing
+ * several shapes in a row should build the descriptions and call drawShapes once.
+ *
+ * @note Each shape has specific constraints:
+ * - The radius for "circle" and "arc" must be >= 5 to avoid rendering issues.
+ * - Angles for "arc" must be within [0, 360].
+ * - "polygon" must have a minimum of 3 sides and a reasonable number of sides for proper rendering.
+ */
+int drawShape(SDL_Renderer *renderer, SDL_Texture *texture, ShapeType shape, DrawMode mode, FormType type, SDL_Color color, ...) {
+    if ((int)shape < 0 || (int)shape >= SHAPE_TYPE_COUNT) {
+        printf("%sExecutionError: Invalid shape type %d.\n", RED_COLOR, (int)shape);
+        return -1;
+    }
+    ShapeDesc desc = {shape, mode, type, color, {0}};
 
-    // End the variable argument processing.
+    // Extract the arguments of the shape
+    va_list args;
+    va_start(args, color);
+    for (int i = 0; i < shapeArgCounts[shape]; i++) {
+        desc.args[i] = va_arg(args, int);
+    }
     va_end(args);
-    return 0;
+
+    return drawShapes(renderer, texture, &desc, 1, DRAW_SHAPES_DEFAULT);
 }
@@ -3,17 +3,70 @@
 #include "../files.h/formEvents.h"
 #include "../files.h/cursorEvents.h"
 #include "../files.h/colors.h"
+#include "../files.h/geometry.h"
+#include "../files.h/headless.h"
+#include "../files.h/animations.h"
+#include "../files.h/spatialGrid.h"
+#include "../files.h/sceneLayers.h"
 
 #include <math.h>
 #include <limits.h>
+#include <string.h>
 
 // ANSI escape codes for colors
 #define RED_COLOR "-#red "
 
-// Global table to storage the forms
-Shape shapes[MAX_SHAPES];
+// Global store of the forms: a dense array that grows on demand, plus a slot table
+// that maps stable handles to dense indices.
+Shape *shapes = NULL;
 int shapeCount = 0;
 
+// One slot per handle. A live slot points at its dense index and at its position
+// in the draw order, a free slot links to the next free one. Slot 0 is never
+// handed out so that {0, 0} stays invalid.
+typedef struct {
+    int dense;
+    int order;
+    int nextFree;
+    Uint32 generation;
+} ShapeSlot;
+
+static int shapeCapacity = 0;
+static Uint32 *denseToSlot = NULL;
+static Uint32 *drawOrder = NULL;    // Slots sorted by increasing zIndex, 0 where a shape was deleted
+static int orderCount = 0;          // Entries in drawOrder, deleted ones included
+static ShapeSlot *slots = NULL;
+static int slotCount = 0;
+static int slotCapacity = 0;
+static int freeSlot = -1;
+static int nextZIndex = 0;
+
+// Pick boxes of the stored shapes keyed by slot, see queryShapesAt
+static SpatialGrid pickGrid = {.cellSize = GRID_CELL_SIZE};
+static int *pickResults = NULL;
+static int pickCapacity = 0;
+
+// Hit-test data of a stored shape. Each lookup compares it with the geometry it was
+// built from, so it follows the shape however it is moved or resized.
+typedef struct {
+    bool valid;
+    ShapeType type;
+    unsigned char data[sizeof(((Shape *)0)->data)];  // Geometry the entry was built from
+    int minX, minY, maxX, maxY;     // Pick box, see getPickBounds
+    float *vertexX;                 // Polygon and triangle vertices
+    float *vertexY;
+    int vertexCount;
+    int vertexCapacity;
+    float arcStart, arcEnd;         // Arc limits as pseudo-angles, see getPseudoAngle
+} HitGeometry;
+
+static HitGeometry *hitGeometry = NULL;    // Indexed by store slot
+static int hitGeometryCapacity = 0;
+
+static int drawBatch = DRAW_BATCH_OFF;  // Instant draw present cadence, see setDrawBatch
+static int batchedDraws = 0;
+static bool drawCapture = false;        // drawShape only registers shapes, see setDrawCapture
+
 /**
  * @brief Sets the rendering color for the SDL renderer, optimizing redundant calls.
  *
@@ -82,8 +135,8 @@ int renderTexture(SDL_Renderer* renderer, SDL_Texture* texture, int time) {
         return -1;
     }
 
-    // Add optional delay
-    if (time != 0) SDL_Delay(time);
+    // Add optional delay, skipped when running offscreen
+    if (time != 0 && !headless.enabled) SDL_Delay(time);
 
     // Present the rendered content
     SDL_RenderPresent(renderer);
@@ -99,6 +152,119 @@ int renderTexture(SDL_Renderer* renderer, SDL_Texture* texture, int time) {
     return 0;
 }
 
+/**
+ * @brief Selects how instant draws reach the screen.
+ *
+ * @param cadence DRAW_BATCH_OFF to present every instant draw followed by its delay,
+ *                0 to present only at the end of the instructions (or at the next
+ *                animated draw), N > 0 to present every N instant draws without delay.
+ */
+void setDrawBatch(int cadence) {
+    drawBatch = cadence < 0 ? DRAW_BATCH_OFF : cadence;
+    batchedDraws = 0;
+}
+
+/**
+ * @brief Returns the current instant draw batching cadence (see setDrawBatch).
+ */
+int getDrawBatch(void) {
+    return drawBatch;
+}
+
+/**
+ * @brief Makes drawShape register shapes without rasterizing them.
+ *
+ * Used by the scene host to run a reloaded scene: the shapes go to the store, which
+ * the main loop renders, without replaying their drawing on the screen.
+ *
+ * @param capture true to only register shapes, false to draw them again.
+ */
+void setDrawCapture(bool capture) {
+    drawCapture = capture;
+}
+
+/**
+ * @brief Returns whether drawShape only registers shapes (see setDrawCapture).
+ */
+bool isDrawCaptured(void) {
+    return drawCapture;
+}
+
+/**
+ * @brief Reads the --batch N option from the program arguments.
+ *
+ * Overrides the cadence set by the "set batch(N)" directive. Other arguments are ignored.
+ *
+ * @return 0 on success, -1 if the value is missing or not a number >= 0.
+ */
+int parseDrawBatchArgs(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--batch") != 0) continue;
+
+        char *end = NULL;
+        long cadence = (i + 1 < argc) ? strtol(argv[i + 1], &end, 10) : -1;
+        if (!end || *end != '\0' || cadence < 0) {
+            printf("%sExecutionError: --batch expects a number >= 0\n", RED_COLOR);
+            return -1;
+        }
+        setDrawBatch((int)cadence);
+        i++;
+    }
+    return 0;
+}
+
+/**
+ * @brief Shows the result of an instant draw, following the batching cadence.
+ *
+ * Without batching this is renderTexture with the usual 750 ms delay. With batching the
+ * shape stays in the texture and the screen is only updated every N draws, with no delay.
+ *
+ * @param renderer Renderer used for drawing.
+ * @param texture Texture holding the drawing.
+ * @return int Returns 0 on success, -1 on failure
+ */
+int presentInstantDraw(SDL_Renderer* renderer, SDL_Texture* texture) {
+    if (drawBatch == DRAW_BATCH_OFF) {
+        return renderTexture(renderer, texture, 750);
+    }
+
+    batchedDraws++;
+    if (drawBatch > 0 && batchedDraws % drawBatch == 0) {
+        return renderTexture(renderer, texture, 0);
+    }
+    return 0;
+}
+
+/**
+ * @brief Fills or outlines a polygon with SDL2_gfx depending on the shape's typeForm.
+ */
+static void drawOutline(SDL_Renderer *renderer, const Shape *shape, const ShapeOutline *outline, SDL_Color color) {
+    if (shape->typeForm == FORM_FILLED) {
+        filledPolygonRGBA(renderer, outline->x, outline->y, outline->count, color.r, color.g, color.b, color.a);
+    } else {
+        polygonRGBA(renderer, outline->x, outline->y, outline->count, color.r, color.g, color.b, color.a);
+    }
+}
+
+/**
+ * @brief Renders a polygonal shape, and its highlight if selected, from its cached outline.
+ *
+ * Covers rectangles, squares, ellipses, polygons and triangles. The corners are only
+ * recomputed when the shape's geometry changes, see getShapeOutline.
+ *
+ * @param renderer The SDL renderer to use for drawing
+ * @param shape The shape to render
+ */
+static void renderShapeOutline(SDL_Renderer *renderer, Shape *shape) {
+    ShapeOutline outline;
+    if (getShapeOutline(shape, false, &outline) != 0) return;
+    drawOutline(renderer, shape, &outline, shape->color);
+
+    if (shape->selected && getShapeOutline(shape, true, &outline) == 0) {
+        drawOutline(renderer, shape, &outline, selectColor(shape->color));
+    }
+}
+
 /**
  * @brief Renders a shape on the screen based on its type and properties.
  * 
@@ -106,7 +272,7 @@ int renderTexture(SDL_Renderer* renderer, SDL_Texture* texture, int time) {
  * @param shape Pointer to the shape structure containing its type, dimensions, color, etc.
  */
 void renderShape(SDL_Renderer *renderer, Shape *shape) {
-    if (shape->typeForm == NULL || (strcmp(shape->typeForm, "filled") != 0 && strcmp(shape->typeForm, "empty") != 0)) {
+    if (shape->typeForm != FORM_FILLED && shape->typeForm != FORM_EMPTY) {
         return; // Skip rendering if the typeForm is invalid.
     }
 
@@ -116,10 +282,10 @@ void renderShape(SDL_Renderer *renderer, Shape *shape) {
             setRenderColor(renderer, shape->color);
 
             // Render the filled or empty circle based on typeForm
-            if (strcmp(shape->typeForm, "filled") == 0) {
+            if (shape->typeForm == FORM_FILLED) {
                 filledCircleRGBA(renderer, shape->data.circle.x, shape->data.circle.y, shape->data.circle.radius, 
                                 shape->color.r, shape->color.g, shape->color.b, shape->color.a);
-            } else if (strcmp(shape->typeForm, "empty") == 0) {
+            } else if (shape->typeForm == FORM_EMPTY) {
                 circleRGBA(renderer, shape->data.circle.x, shape->data.circle.y, shape->data.circle.radius, 
                           shape->color.r, shape->color.g, shape->color.b, shape->color.a);
             }
@@ -127,7 +293,7 @@ void renderShape(SDL_Renderer *renderer, Shape *shape) {
             // Highlight the circle if selected
             if (shape->selected) {
                 SDL_Color selectedColor = selectColor(shape->color);
-                if (strcmp(shape->typeForm, "filled") == 0) {
+                if (shape->typeForm == FORM_FILLED) {
                     filledCircleRGBA(renderer, shape->data.circle.x, shape->data.circle.y, shape->data.circle.radius + 5, 
                                    selectedColor.r, selectedColor.g, selectedColor.b, selectedColor.a);
                 } else {
@@ -148,210 +314,19 @@ void renderShape(SDL_Renderer *renderer, Shape *shape) {
             break;
         }
 
-        case SHAPE_RECTANGLE: {
-            setRenderColor(renderer, shape->color);
-
-            // Calculate the center of the rectangle
-            int cx = shape->data.rectangle.x + shape->data.rectangle.width / 2;
-            int cy = shape->data.rectangle.y + shape->data.rectangle.height / 2;
-            double angle = shape->rotation * M_PI / 180.0;
-
-            SDL_Point points[5];  // Array to store rotated rectangle vertices
-
-            // Calculate rotated rectangle vertices
-            points[0].x = cos(angle) * (shape->data.rectangle.x - cx) - sin(angle) * (shape->data.rectangle.y - cy) + cx;
-            points[0].y = sin(angle) * (shape->data.rectangle.x - cx) + cos(angle) * (shape->data.rectangle.y - cy) + cy;
-
-            points[1].x = cos(angle) * (shape->data.rectangle.x + shape->data.rectangle.width - cx) - sin(angle) * (shape->data.rectangle.y - cy) + cx;
-            points[1].y = sin(angle) * (shape->data.rectangle.x + shape->data.rectangle.width - cx) + cos(angle) * (shape->data.rectangle.y - cy) + cy;
-
-            points[2].x = cos(angle) * (shape->data.rectangle.x + shape->data.rectangle.width - cx) - sin(angle) * (shape->data.rectangle.y + shape->data.rectangle.height - cy) + cx;
-            points[2].y = sin(angle) * (shape->data.rectangle.x + shape->data.rectangle.width - cx) + cos(angle) * (shape->data.rectangle.y + shape->data.rectangle.height - cy) + cy;
-
-            points[3].x = cos(angle) * (shape->data.rectangle.x - cx) - sin(angle) * (shape->data.rectangle.y + shape->data.rectangle.height - cy) + cx;
-            points[3].y = sin(angle) * (shape->data.rectangle.x - cx) + cos(angle) * (shape->data.rectangle.y + shape->data.rectangle.height - cy) + cy;
-
-            points[4] = points[0];  // Close the rectangle by repeating the first point
-
-            // Render the rectangle
-            if (strcmp(shape->typeForm, "filled") == 0) {
-                filledPolygonRGBA(renderer, 
-                                (Sint16[]){points[0].x, points[1].x, points[2].x, points[3].x}, 
-                                (Sint16[]){points[0].y, points[1].y, points[2].y, points[3].y}, 
-                                4, shape->color.r, shape->color.g, shape->color.b, shape->color.a);
-            } else if (strcmp(shape->typeForm, "empty") == 0) {
-                SDL_RenderDrawLines(renderer, points, 5);
-            }
-
-            // Render selection highlight if selected
-            if (shape->selected) {
-                SDL_Color selectedColor = selectColor(shape->color);
-                // Calculate enlarged rectangle vertices (5 pixels larger)
-                int enlargement = 5;
-                SDL_Point enlargedPoints[5];
-                
-                enlargedPoints[0].x = cos(angle) * (shape->data.rectangle.x - enlargement - cx) - sin(angle) * (shape->data.rectangle.y - enlargement - cy) + cx;
-                enlargedPoints[0].y = sin(angle) * (shape->data.rectangle.x - enlargement - cx) + cos(angle) * (shape->data.rectangle.y - enlargement - cy) + cy;
-
-                enlargedPoints[1].x = cos(angle) * (shape->data.rectangle.x + shape->data.rectangle.width + enlargement - cx) - sin(angle) * (shape->data.rectangle.y - enlargement - cy) + cx;
-                enlargedPoints[1].y = sin(angle) * (shape->data.rectangle.x + shape->data.rectangle.width + enlargement - cx) + cos(angle) * (shape->data.rectangle.y - enlargement - cy) + cy;
-
-                enlargedPoints[2].x = cos(angle) * (shape->data.rectangle.x + shape->data.rectangle.width + enlargement - cx) - sin(angle) * (shape->data.rectangle.y + shape->data.rectangle.height + enlargement - cy) + cx;
-                enlargedPoints[2].y = sin(angle) * (shape->data.rectangle.x + shape->data.rectangle.width + enlargement - cx) + cos(angle) * (shape->data.rectangle.y + shape->data.rectangle.height + enlargement - cy) + cy;
-
-                enlargedPoints[3].x = cos(angle) * (shape->data.rectangle.x - enlargement - cx) - sin(angle) * (shape->data.rectangle.y + shape->data.rectangle.height + enlargement - cy) + cx;
-                enlargedPoints[3].y = sin(angle) * (shape->data.rectangle.x - enlargement - cx) + cos(angle) * (shape->data.rectangle.y + shape->data.rectangle.height + enlargement - cy) + cy;
-
-                enlargedPoints[4] = enlargedPoints[0];
-
-                if (strcmp(shape->typeForm, "filled") == 0) {
-                    filledPolygonRGBA(renderer, 
-                                    (Sint16[]){enlargedPoints[0].x, enlargedPoints[1].x, enlargedPoints[2].x, enlargedPoints[3].x}, 
-                                    (Sint16[]){enlargedPoints[0].y, enlargedPoints[1].y, enlargedPoints[2].y, enlargedPoints[3].y}, 
-                                    4, selectedColor.r, selectedColor.g, selectedColor.b, selectedColor.a);
-                } else {
-                    SDL_RenderDrawLines(renderer, enlargedPoints, 5);
-                }
-            }
-            break;
-        }
-
-        case SHAPE_SQUARE: {
-            setRenderColor(renderer, shape->color);
-
-            // Calculate the center of the rectangle
-            int cx = shape->data.square.x + shape->data.square.c / 2;
-            int cy = shape->data.square.y + shape->data.square.c / 2;
-            double angle = shape->rotation * M_PI / 180.0;
-
-            SDL_Point points[5];  // Array to store rotated rectangle vertices
-
-            // Calculate rotated rectangle vertices
-            points[0].x = cos(angle) * (shape->data.square.x - cx) - sin(angle) * (shape->data.square.y - cy) + cx;
-            points[0].y = sin(angle) * (shape->data.square.x - cx) + cos(angle) * (shape->data.square.y - cy) + cy;
-
-            points[1].x = cos(angle) * (shape->data.square.x + shape->data.square.c - cx) - sin(angle) * (shape->data.square.y - cy) + cx;
-            points[1].y = sin(angle) * (shape->data.square.x + shape->data.square.c - cx) + cos(angle) * (shape->data.square.y - cy) + cy;
-
-            points[2].x = cos(angle) * (shape->data.square.x + shape->data.square.c - cx) - sin(angle) * (shape->data.square.y + shape->data.square.c - cy) + cx;
-            points[2].y = sin(angle) * (shape->data.square.x + shape->data.square.c - cx) + cos(angle) * (shape->data.square.y + shape->data.square.c - cy) + cy;
-
-            points[3].x = cos(angle) * (shape->data.square.x - cx) - sin(angle) * (shape->data.square.y + shape->data.square.c - cy) + cx;
-            points[3].y = sin(angle) * (shape->data.square.x - cx) + cos(angle) * (shape->data.square.y + shape->data.square.c - cy) + cy;
-
-            points[4] = points[0];  // Close the rectangle by repeating the first point
-
-            // Render the rectangle
-            if (strcmp(shape->typeForm, "filled") == 0) {
-                filledPolygonRGBA(renderer, 
-                                (Sint16[]){points[0].x, points[1].x, points[2].x, points[3].x}, 
-                                (Sint16[]){points[0].y, points[1].y, points[2].y, points[3].y}, 
-                                4, shape->color.r, shape->color.g, shape->color.b, shape->color.a);
-            } else if (strcmp(shape->typeForm, "empty") == 0) {
-                SDL_RenderDrawLines(renderer, points, 5);
-            }
-
-            // Render selection highlight if selected
-            if (shape->selected) {
-                SDL_Color selectedColor = selectColor(shape->color);
-                // Calculate enlarged rectangle vertices (5 pixels larger)
-                int enlargement = 5;
-                SDL_Point enlargedPoints[5];
-                
-                enlargedPoints[0].x = cos(angle) * (shape->data.square.x - enlargement - cx) - sin(angle) * (shape->data.square.y - enlargement - cy) + cx;
-                enlargedPoints[0].y = sin(angle) * (shape->data.square.x - enlargement - cx) + cos(angle) * (shape->data.square.y - enlargement - cy) + cy;
-
-                enlargedPoints[1].x = cos(angle) * (shape->data.square.x + shape->data.square.c + enlargement - cx) - sin(angle) * (shape->data.square.y - enlargement - cy) + cx;
-                enlargedPoints[1].y = sin(angle) * (shape->data.square.x + shape->data.square.c + enlargement - cx) + cos(angle) * (shape->data.square.y - enlargement - cy) + cy;
-
-                enlargedPoints[2].x = cos(angle) * (shape->data.square.x + shape->data.square.c + enlargement - cx) - sin(angle) * (shape->data.square.y + shape->data.square.c + enlargement - cy) + cx;
-                enlargedPoints[2].y = sin(angle) * (shape->data.square.x + shape->data.square.c + enlargement - cx) + cos(angle) * (shape->data.square.y + shape->data.square.c + enlargement - cy) + cy;
-
-                enlargedPoints[3].x = cos(angle) * (shape->data.square.x - enlargement - cx) - sin(angle) * (shape->data.square.y + shape->data.square.c + enlargement - cy) + cx;
-                enlargedPoints[3].y = sin(angle) * (shape->data.square.x - enlargement - cx) + cos(angle) * (shape->data.square.y + shape->data.square.c + enlargement - cy) + cy;
-
-                enlargedPoints[4] = enlargedPoints[0];
-
-                if (strcmp(shape->typeForm, "filled") == 0) {
-                    filledPolygonRGBA(renderer, 
-                                    (Sint16[]){enlargedPoints[0].x, enlargedPoints[1].x, enlargedPoints[2].x, enlargedPoints[3].x}, 
-                                    (Sint16[]){enlargedPoints[0].y, enlargedPoints[1].y, enlargedPoints[2].y, enlargedPoints[3].y}, 
-                                    4, selectedColor.r, selectedColor.g, selectedColor.b, selectedColor.a);
-                } else {
-                    SDL_RenderDrawLines(renderer, enlargedPoints, 5);
-                }
-            }
-            break;
-        }
-
-        case SHAPE_ELLIPSE: {
-            setRenderColor(renderer, shape->color);
-
-            int cxE = shape->data.ellipse.x;
-            int cyE = shape->data.ellipse.y;
-            double angleE = shape->rotation * M_PI / 180.0; // Convert rotation to radians.
-
-            // Array to store the points for the rotated ellipse.
-            SDL_Point ellipsePoints[36]; 
-            int pointCount = 36; // Number of points to approximate the ellipse.
-
-            // Calculate the rotated ellipse points.
-            for (int i = 0; i < pointCount; i++) {
-                double theta = (2 * M_PI * i) / pointCount; // Divide the ellipse into equal angles.
-                double dx = shape->data.ellipse.rx * cos(theta);
-                double dy = shape->data.ellipse.ry * sin(theta);
-                ellipsePoints[i].x = cos(angleE) * dx - sin(angleE) * dy + cxE; // Rotate and translate.
-                ellipsePoints[i].y = sin(angleE) * dx + cos(angleE) * dy + cyE;
-            }
-
-            // Render the ellipse.
-            if (strcmp(shape->typeForm, "filled") == 0) {
-                Sint16 xCoords[36];
-                Sint16 yCoords[36];
-                for (int i = 0; i < pointCount; i++) {
-                    xCoords[i] = ellipsePoints[i].x;
-                    yCoords[i] = ellipsePoints[i].y;
-                }
-                filledPolygonRGBA(renderer, xCoords, yCoords, pointCount, shape->color.r, shape->color.g, shape->color.b, shape->color.a);
-            } else if (strcmp(shape->typeForm, "empty") == 0) {
-                SDL_RenderDrawLines(renderer, ellipsePoints, pointCount);
-                SDL_RenderDrawLine(renderer, ellipsePoints[pointCount - 1].x, ellipsePoints[pointCount - 1].y, ellipsePoints[0].x, ellipsePoints[0].y);
-            }
-
-            // Render selection if the shape is selected.
-            if (shape->selected) {
-                SDL_Color selectedColor = selectColor(shape->color);
-                SDL_Point selectionPoints[36];
-                for (int i = 0; i < pointCount; i++) {
-                    double theta = (2 * M_PI * i) / pointCount;
-                    double dx = (shape->data.ellipse.rx + 5) * cos(theta);
-                    double dy = (shape->data.ellipse.ry + 5) * sin(theta);
-                    selectionPoints[i].x = cos(angleE) * dx - sin(angleE) * dy + cxE;
-                    selectionPoints[i].y = sin(angleE) * dx + cos(angleE) * dy + cyE;
-                }
-                
-                if (strcmp(shape->typeForm, "filled") == 0) {
-                    Sint16 xCoords[36];
-                    Sint16 yCoords[36];
-                    for (int i = 0; i < pointCount; i++) {
-                        xCoords[i] = selectionPoints[i].x;
-                        yCoords[i] = selectionPoints[i].y;
-                    }
-                    filledPolygonRGBA(renderer, xCoords, yCoords, pointCount, selectedColor.r, selectedColor.g, selectedColor.b, selectedColor.a);
-                } else if (strcmp(shape->typeForm, "empty") == 0) {
-                    setRenderColor(renderer, selectedColor);
-                    SDL_RenderDrawLines(renderer, selectionPoints, pointCount);
-                    SDL_RenderDrawLine(renderer, selectionPoints[pointCount - 1].x, selectionPoints[pointCount - 1].y, selectionPoints[0].x, selectionPoints[0].y);
-                }
-            }
+        case SHAPE_RECTANGLE:
+        case SHAPE_SQUARE:
+        case SHAPE_ELLIPSE:
+        case SHAPE_POLYGON:
+        case SHAPE_TRIANGLE:
+            renderShapeOutline(renderer, shape);
             break;
-        }
 
         case SHAPE_LINE: {
             setRenderColor(renderer, shape->color);
             
             // Update the actual thickness in the shape structure
-            if (strcmp(shape->typeForm, "empty") == 0) {
+            if (shape->typeForm == FORM_EMPTY) {
                 shape->data.line.thickness = 1;
             }
             
@@ -401,134 +376,6 @@ void renderShape(SDL_Renderer *renderer, Shape *shape) {
             break;
         }
 
-        case SHAPE_POLYGON: {
-            setRenderColor(renderer, shape->color);
-
-            int sides = shape->data.polygon.sides;
-            if (sides < 3) return;
-
-            double angleStep = 2 * M_PI / sides;
-            SDL_Point pointsP[13];
-
-            // Calculate the vertices of the polygon with rotation applied
-            for (int i = 0; i < sides; i++) {
-                double angle = i * angleStep + (shape->rotation * M_PI / 180.0);
-                pointsP[i].x = shape->data.polygon.cx + cos(angle) * shape->data.polygon.radius;
-                pointsP[i].y = shape->data.polygon.cy + sin(angle) * shape->data.polygon.radius;
-            }
-            pointsP[sides] = pointsP[0];
-
-            // Render the polygon
-            Sint16 xCoords[sides];
-            Sint16 yCoords[sides];
-            for (int i = 0; i < sides; i++) {
-                xCoords[i] = pointsP[i].x;
-                yCoords[i] = pointsP[i].y;
-            }
-
-            if (strcmp(shape->typeForm, "filled") == 0) {
-                filledPolygonRGBA(renderer, xCoords, yCoords, sides, 
-                                shape->color.r, shape->color.g, shape->color.b, shape->color.a);
-            } else if (strcmp(shape->typeForm, "empty") == 0) {
-                polygonRGBA(renderer, xCoords, yCoords, sides,
-                        shape->color.r, shape->color.g, shape->color.b, shape->color.a);
-            }
-
-            // Add a selection highlight if the shape is selected
-            if (shape->selected) {
-                SDL_Color selectedColor = selectColor(shape->color);
-                SDL_Point enlargedPoints[13];
-                int enlargement = 5;
-
-                // Calculate enlarged polygon vertices
-                for (int i = 0; i < sides; i++) {
-                    double angle = i * angleStep + (shape->rotation * M_PI / 180.0);
-                    enlargedPoints[i].x = shape->data.polygon.cx + cos(angle) * (shape->data.polygon.radius + enlargement);
-                    enlargedPoints[i].y = shape->data.polygon.cy + sin(angle) * (shape->data.polygon.radius + enlargement);
-                }
-                enlargedPoints[sides] = enlargedPoints[0];
-
-                Sint16 enlargedX[sides];
-                Sint16 enlargedY[sides];
-                for (int i = 0; i < sides; i++) {
-                    enlargedX[i] = enlargedPoints[i].x;
-                    enlargedY[i] = enlargedPoints[i].y;
-                }
-
-                if (strcmp(shape->typeForm, "filled") == 0) {
-                    filledPolygonRGBA(renderer, enlargedX, enlargedY, sides,
-                                    selectedColor.r, selectedColor.g, selectedColor.b, selectedColor.a);
-                } else {
-                    polygonRGBA(renderer, enlargedX, enlargedY, sides,
-                            selectedColor.r, selectedColor.g, selectedColor.b, selectedColor.a);
-                }
-            }
-            break;
-        }
-
-        case SHAPE_TRIANGLE: {
-            setRenderColor(renderer, shape->color);
-
-            int sides = 3;
-            double angleStep = 2 * M_PI / sides;
-            SDL_Point pointsP[13];
-
-            // Calculate the vertices of the triangle with rotation applied
-            for (int i = 0; i < sides; i++) {
-                double angle = i * angleStep + (shape->rotation * M_PI / 180.0) + (30 * M_PI / 180.0);
-                pointsP[i].x = shape->data.triangle.cx + cos(angle) * shape->data.triangle.radius;
-                pointsP[i].y = shape->data.triangle.cy + sin(angle) * shape->data.triangle.radius;
-            }
-            pointsP[sides] = pointsP[0];
-
-            // Render the triangle
-            Sint16 xCoords[sides];
-            Sint16 yCoords[sides];
-            for (int i = 0; i < sides; i++) {
-                xCoords[i] = pointsP[i].x;
-                yCoords[i] = pointsP[i].y;
-            }
-
-            if (strcmp(shape->typeForm, "filled") == 0) {
-                filledPolygonRGBA(renderer, xCoords, yCoords, sides, 
-                                shape->color.r, shape->color.g, shape->color.b, shape->color.a);
-            } else if (strcmp(shape->typeForm, "empty") == 0) {
-                polygonRGBA(renderer, xCoords, yCoords, sides,
-                        shape->color.r, shape->color.g, shape->color.b, shape->color.a);
-            }
-
-            // Add a selection highlight if the shape is selected
-            if (shape->selected) {
-                SDL_Color selectedColor = selectColor(shape->color);
-                SDL_Point enlargedPoints[13];
-                int enlargement = 5;
-
-                // Calculate enlarged triangle vertices
-                for (int i = 0; i < sides; i++) {
-                    double angle = i * angleStep + (shape->rotation * M_PI / 180.0) + (30 * M_PI / 180.0);
-                    enlargedPoints[i].x = shape->data.triangle.cx + cos(angle) * (shape->data.triangle.radius + enlargement);
-                    enlargedPoints[i].y = shape->data.triangle.cy + sin(angle) * (shape->data.triangle.radius + enlargement);
-                }
-                enlargedPoints[sides] = enlargedPoints[0];
-
-                Sint16 enlargedX[sides];
-                Sint16 enlargedY[sides];
-                for (int i = 0; i < sides; i++) {
-                    enlargedX[i] = enlargedPoints[i].x;
-                    enlargedY[i] = enlargedPoints[i].y;
-                }
-
-                if (strcmp(shape->typeForm, "filled") == 0) {
-                    filledPolygonRGBA(renderer, enlargedX, enlargedY, sides,
-                                    selectedColor.r, selectedColor.g, selectedColor.b, selectedColor.a);
-                } else {
-                    polygonRGBA(renderer, enlargedX, enlargedY, sides,
-                            selectedColor.r, selectedColor.g, selectedColor.b, selectedColor.a);
-                }
-            }
-            break;
-        }
-
         case SHAPE_ARC: {
             setRenderColor(renderer, shape->color);
 
@@ -543,11 +390,11 @@ void renderShape(SDL_Renderer *renderer, Shape *shape) {
             endAngle = (endAngle + (int)shape->rotation) % 360;
 
             // Render the arc
-            if (strcmp(shape->typeForm, "empty") == 0) {
+            if (shape->typeForm == FORM_EMPTY) {
                 arcRGBA(renderer, centerX, centerY, shape->data.arc.radius, 
                         startAngle, endAngle, 
                         shape->color.r, shape->color.g, shape->color.b, shape->color.a);
-            } else if (strcmp(shape->typeForm, "filled") == 0) {
+            } else if (shape->typeForm == FORM_FILLED) {
                 filledPieRGBA(renderer, centerX, centerY, shape->data.arc.radius,
                             startAngle, endAngle,
                             shape->color.r, shape->color.g, shape->color.b, shape->color.a);
@@ -557,7 +404,7 @@ void renderShape(SDL_Renderer *renderer, Shape *shape) {
             if (shape->selected) {
                 SDL_Color selectedColor = selectColor(shape->color);
                 int enlargement = 5;
-                if (strcmp(shape->typeForm, "empty") == 0) {
+                if (shape->typeForm == FORM_EMPTY) {
                     arcRGBA(renderer, centerX, centerY, shape->data.arc.radius + enlargement,
                             startAngle, endAngle,
                             selectedColor.r, selectedColor.g, selectedColor.b, selectedColor.a);
@@ -574,106 +421,305 @@ void renderShape(SDL_Renderer *renderer, Shape *shape) {
 
 /**
  * @brief Renders all shapes in order of their z-index
+ *
+ * Uses the SDL2_gfx path, the batched geometry path or the software rasterizer, see setRenderPath.
  * 
  * @param renderer The SDL renderer to use for drawing
  */
 void renderAllShapes(SDL_Renderer *renderer) {
-    // Create a temporary array for sorting
-    Shape** sortedShapes = malloc(shapeCount * sizeof(Shape*));
-    if (!sortedShapes) {
-        printf("%sExecutionError: Failed to allocate memory for sorted shapes\n", RED_COLOR);
+    renderShapesInRect(renderer, NULL);
+}
+
+/**
+ * @brief Renders, in z-order, the shapes whose drawing overlaps an area
+ *
+ * Large scenes are drawn from cached layers of the shapes that do not move, see
+ * renderSceneLayers. Shapes are only skipped, not clipped: set a clip rect to keep
+ * the drawing inside the area.
+ *
+ * @param renderer The SDL renderer to use for drawing
+ * @param area The area in pixels, or NULL for every shape
+ */
+void renderShapesInRect(SDL_Renderer *renderer, const SDL_Rect *area) {
+    if (renderSceneLayers(renderer, area) == 0) return;
+    renderShapeRange(renderer, area, 0, shapeCount);
+}
+
+/**
+ * @brief Removes the entries of deleted shapes from the draw order.
+ *
+ * deleteShape only blanks the entry of the shape, so that deleting is O(1). The
+ * order is compacted in one pass the next time positions are read, which costs
+ * the same whether one or many shapes were deleted in between.
+ */
+static void compactDrawOrder(void) {
+    if (orderCount == shapeCount) return;
+
+    int count = 0;
+    for (int i = 0; i < orderCount; i++) {
+        if (drawOrder[i] == 0) continue;
+        drawOrder[count] = drawOrder[i];
+        slots[drawOrder[count]].order = count;
+        count++;
+    }
+    orderCount = count;
+}
+
+/**
+ * @brief Renders a range of the draw order, skipping the shapes outside an area
+ *
+ * @param renderer The SDL renderer to use for drawing
+ * @param area The area in pixels, or NULL for every shape
+ * @param first Position of the first shape in the draw order
+ * @param last Position one past the last shape
+ */
+void renderShapeRange(SDL_Renderer *renderer, const SDL_Rect *area, int first, int last) {
+    compactDrawOrder();
+    if (getRenderPath() != RENDER_GFX) {
+        renderShapesGeometry(renderer, area, first, last);
         return;
     }
 
-    // Copy pointers to shapes to temporary array
-    for (int i = 0; i < shapeCount; i++) {
-        sortedShapes[i] = &shapes[i];
+    // The draw order is kept sorted as shapes are added, deleted or moved between layers
+    int primitives = 0;
+    for (int i = first; i < last; i++) {
+        Shape *shape = &shapes[slots[drawOrder[i]].dense];
+        SDL_Rect bounds;
+        if (area && (!getShapeDrawBounds(shape, &bounds) || !SDL_HasIntersection(&bounds, area))) continue;
+        renderShape(renderer, shape);
+
+        // One primitive for the shape, one for its highlight, one for the circle's rotation indicator
+        primitives += 1 + (shape->selected ? 1 : 0) + (shape->type == SHAPE_CIRCLE ? 1 : 0);
     }
+    setRenderStats((RenderStats){0, primitives, 0, 0, 0});
+}
 
-    // Sort shapes by z-index
-    for (int i = 0; i < shapeCount - 1; i++) {
-        for (int j = 0; j < shapeCount - i - 1; j++) {
-            if (sortedShapes[j]->zIndex > sortedShapes[j + 1]->zIndex) {
-                Shape* temp = sortedShapes[j];
-                sortedShapes[j] = sortedShapes[j + 1];
-                sortedShapes[j + 1] = temp;
-            }
-        }
+/**
+ * @brief Returns the shape at a given position in the draw order.
+ *
+ * Position 0 is the bottom layer and position shapeCount - 1 the top one.
+ *
+ * @param position Position in the draw order.
+ * @return A pointer to the shape, or NULL if the position is out of range.
+ */
+Shape* getShapeInDrawOrder(int position) {
+    if (position < 0 || position >= shapeCount) return NULL;
+    compactDrawOrder();
+    return &shapes[slots[drawOrder[position]].dense];
+}
+
+/**
+ * @brief Makes sure the dense array can hold at least `needed` shapes.
+ *
+ * @param needed The number of shapes the store must be able to hold.
+ * @return 0 on success, -1 if the memory could not be allocated.
+ */
+static int reserveShapes(int needed) {
+    if (needed <= shapeCapacity) return 0;
+
+    int newCapacity = shapeCapacity ? shapeCapacity : 64;
+    while (newCapacity < needed) newCapacity *= 2;
+
+    Shape *newShapes = realloc(shapes, newCapacity * sizeof(Shape));
+    if (!newShapes) return -1;
+    shapes = newShapes;
+
+    Uint32 *newDenseToSlot = realloc(denseToSlot, newCapacity * sizeof(Uint32));
+    if (!newDenseToSlot) return -1;
+    denseToSlot = newDenseToSlot;
+
+    Uint32 *newDrawOrder = realloc(drawOrder, newCapacity * sizeof(Uint32));
+    if (!newDrawOrder) return -1;
+    drawOrder = newDrawOrder;
+
+    shapeCapacity = newCapacity;
+    return 0;
+}
+
+/**
+ * @brief Takes a slot from the free list, or appends a new one.
+ *
+ * @return The slot number, or -1 if the slot table could not grow.
+ */
+static int acquireSlot(void) {
+    if (freeSlot != -1) {
+        int slot = freeSlot;
+        freeSlot = slots[slot].nextFree;
+        return slot;
     }
 
-    // Render shapes in order
-    for (int i = 0; i < shapeCount; i++) {
-        renderShape(renderer, sortedShapes[i]);
+    // Slot 0 is reserved for NULL_SHAPE_HANDLE
+    if (slotCount == 0) slotCount = 1;
+
+    if (slotCount >= slotCapacity) {
+        int newCapacity = slotCapacity ? slotCapacity * 2 : 64;
+        ShapeSlot *newSlots = realloc(slots, newCapacity * sizeof(ShapeSlot));
+        if (!newSlots) return -1;
+        slots = newSlots;
+        slotCapacity = newCapacity;
     }
 
-    // Free temporary array
-    free(sortedShapes);
+    slots[slotCount].generation = 1;
+    return slotCount++;
 }
 
 /**
- * @brief Adds a new shape to the shape list.
- * 
- * @param shape The shape to be added.
+ * @brief Appends an entry to the dense array and binds it to a fresh slot.
+ *
+ * The entry goes on top of the draw order, which is right for addShape since it
+ * hands out increasing z-indices. Bulk loads re-sort afterwards. The capacity must
+ * have been reserved, the caller fills the entry then puts it in the pick grid.
+ *
+ * @param handle Receives the handle of the new entry.
+ * @return The entry to fill, or NULL if the slot table could not grow.
  */
-void addShape(Shape shape) {
-    // Check if the maximum number of shapes has been reached
-    if (shapeCount >= MAX_SHAPES) {
-        printf("%sExecutionError: Cannot add more shapes. Maximum limit of %d shapes reached.\n", 
-               RED_COLOR, MAX_SHAPES);
-        return;
+static Shape *appendShape(ShapeHandle *handle) {
+    int slot = acquireSlot();
+    if (slot == -1) {
+        printf("%sExecutionError: Failed to allocate memory for shape handles\n", RED_COLOR);
+        return NULL;
+    }
+
+    // drawOrder has the capacity of the dense array, deleted entries make room
+    if (orderCount == shapeCapacity) compactDrawOrder();
+
+    slots[slot].dense = shapeCount;
+    slots[slot].order = orderCount;
+    slots[slot].nextFree = -1;
+    drawOrder[orderCount++] = (Uint32)slot;
+    denseToSlot[shapeCount] = (Uint32)slot;
+    *handle = (ShapeHandle){(Uint32)slot, slots[slot].generation};
+    return &shapes[shapeCount++];
+}
+
+/**
+ * @brief Puts a shape in the dense array and binds it to a fresh slot.
+ *
+ * @param shape The shape to store, copied as is.
+ * @return The handle of the stored shape, or NULL_SHAPE_HANDLE on allocation failure.
+ */
+static ShapeHandle storeShape(const Shape *shape) {
+    if (reserveShapes(shapeCount + 1) != 0) {
+        printf("%sExecutionError: Failed to allocate memory for %d shapes\n", RED_COLOR, shapeCount + 1);
+        return NULL_SHAPE_HANDLE;
     }
 
-    // Set initial z-index to the current shape count (new shapes appear on top)
-    shape.zIndex = shapeCount;
+    ShapeHandle handle;
+    Shape *stored = appendShape(&handle);
+    if (!stored) return NULL_SHAPE_HANDLE;
+
+    *stored = *shape;
+    updateShapeInGrid(stored);
+    invalidateSceneLayers();
+
+    return handle;
+}
+
+/**
+ * @brief Sets the z-index, animation state and initial values of a new shape.
+ *
+ * @param shape The shape about to be stored.
+ */
+static void initNewShape(Shape *shape) {
+    // New shapes appear on top of everything added before them
+    shape->zIndex = nextZIndex++;
 
     // Initialize animation state
-    shape.isAnimating = false;
-    shape.zoom = 1.0f;  // Initialize zoom to 1.0 (normal size)
-    shape.zoom_direction = 1.0f;  // Start with growing direction
+    shape->geometryDirty = true;
+    shape->isAnimating = false;
+    shape->zoom = 1.0f;  // Initialize zoom to 1.0 (normal size)
+    shape->zoom_direction = 1.0f;  // Start with growing direction
+    shape->color_phase = 0.0f;
+    shape->bounce_remainder_x = 0.0f;
+    shape->bounce_remainder_y = 0.0f;
+    shape->animation_lag = 0.0f;
 
     // Store initial values
-    shape.initial_color = shape.color;
-    shape.initial_rotation = shape.rotation;
+    shape->initial_color = shape->color;
+    shape->initial_rotation = shape->rotation;
 
     // Store initial values based on shape type (excluding position)
-    switch (shape.type) {
+    switch (shape->type) {
         case SHAPE_CIRCLE:
-            shape.data.circle.initial_radius = shape.data.circle.radius;
+            shape->data.circle.initial_radius = shape->data.circle.radius;
             break;
         case SHAPE_RECTANGLE:
-            shape.data.rectangle.initial_width = shape.data.rectangle.width;
-            shape.data.rectangle.initial_height = shape.data.rectangle.height;
+            shape->data.rectangle.initial_width = shape->data.rectangle.width;
+            shape->data.rectangle.initial_height = shape->data.rectangle.height;
             break;
         case SHAPE_SQUARE:
-            shape.data.square.initial_c = shape.data.square.c;
+            shape->data.square.initial_c = shape->data.square.c;
             break;
         case SHAPE_ELLIPSE:
-            shape.data.ellipse.initial_rx = shape.data.ellipse.rx;
-            shape.data.ellipse.initial_ry = shape.data.ellipse.ry;
+            shape->data.ellipse.initial_rx = shape->data.ellipse.rx;
+            shape->data.ellipse.initial_ry = shape->data.ellipse.ry;
             break;
         case SHAPE_LINE:
-            shape.data.line.initial_thickness = shape.data.line.thickness;
+            shape->data.line.initial_thickness = shape->data.line.thickness;
             break;
         case SHAPE_POLYGON:
-            shape.data.polygon.initial_radius = shape.data.polygon.radius;
-            shape.data.polygon.initial_sides = shape.data.polygon.sides;
+            shape->data.polygon.initial_radius = shape->data.polygon.radius;
+            shape->data.polygon.initial_sides = shape->data.polygon.sides;
             break;
         case SHAPE_TRIANGLE:
-            shape.data.triangle.initial_radius = shape.data.triangle.radius;
+            shape->data.triangle.initial_radius = shape->data.triangle.radius;
             break;
         case SHAPE_ARC:
-            shape.data.arc.initial_radius = shape.data.arc.radius;
-            shape.data.arc.initial_start_angle = shape.data.arc.start_angle;
-            shape.data.arc.initial_end_angle = shape.data.arc.end_angle;
+            shape->data.arc.initial_radius = shape->data.arc.radius;
+            shape->data.arc.initial_start_angle = shape->data.arc.start_angle;
+            shape->data.arc.initial_end_angle = shape->data.arc.end_angle;
             break;
     }
+}
 
-    // Add the new shape to the array and increment the shape count
-    shapes[shapeCount++] = shape;
+/**
+ * @brief Adds a new shape to the shape list.
+ * 
+ * @param shape The shape to be added.
+ * @return A handle that stays valid until the shape is deleted.
+ */
+ShapeHandle addShape(Shape shape) {
+    initNewShape(&shape);
+    return storeShape(&shape);
+}
+
+/**
+ * @brief Adds new shapes to the shape list, in order, as addShape would one by one.
+ *
+ * The store grows once for all of them and the scene layers are invalidated once,
+ * each shape is initialized in place instead of being copied through addShape.
+ *
+ * @param source The shapes to add.
+ * @param count The number of shapes.
+ * @return The number of shapes added, less than count if the memory ran out.
+ */
+int addShapes(const Shape *source, int count) {
+    if (count <= 0) return 0;
+    if (reserveShapes(shapeCount + count) != 0) {
+        printf("%sExecutionError: Failed to allocate memory for %d shapes\n", RED_COLOR, shapeCount + count);
+        return 0;
+    }
+
+    int added = 0;
+    while (added < count) {
+        ShapeHandle handle;
+        Shape *stored = appendShape(&handle);
+        if (!stored) break;
+
+        *stored = source[added++];
+        initNewShape(stored);
+        updateShapeInGrid(stored);
+    }
+
+    invalidateSceneLayers();
+    return added;
 }
 
 /**
  * @brief Deletes a shape from the shape list at the specified index.
+ *
+ * The last shape is moved into the freed index, so the call is O(1) but the
+ * index of that last shape changes. Handles are not affected.
  * 
  * @param index The index of the shape to delete.
  */
@@ -681,13 +727,241 @@ void deleteShape(int index) {
     // Check if the index is valid
     if (index < 0 || index >= shapeCount) return;
 
-    // Shift all shapes after the specified index one position to the left
-    for (int i = index; i < shapeCount - 1; i++) {
-        shapes[i] = shapes[i + 1];
+    // Release the slot and invalidate every handle pointing to it
+    Uint32 slot = denseToSlot[index];
+
+    // Blank its entry in the draw order, see compactDrawOrder
+    drawOrder[slots[slot].order] = 0;
+
+    removeGridBox(&pickGrid, slot);
+    slots[slot].generation++;
+    if (slots[slot].generation == 0) slots[slot].generation = 1;
+    slots[slot].nextFree = freeSlot;
+    freeSlot = (int)slot;
+
+    // Fill the hole with the last shape
+    int last = shapeCount - 1;
+    if (index != last) {
+        shapes[index] = shapes[last];
+        denseToSlot[index] = denseToSlot[last];
+        slots[denseToSlot[index]].dense = index;
     }
 
     // Decrement the count of shapes
     shapeCount--;
+    invalidateSceneLayers();
+}
+
+/**
+ * @brief Resolves a handle to its current index in the shapes array.
+ *
+ * @param handle The handle returned by addShape.
+ * @return The dense index, or -1 if the shape has been deleted.
+ */
+int getShapeIndex(ShapeHandle handle) {
+    if (handle.slot == 0 || (int)handle.slot >= slotCount) return -1;
+    if (slots[handle.slot].generation != handle.generation) return -1;
+    return slots[handle.slot].dense;
+}
+
+/**
+ * @brief Resolves a handle to the shape it refers to.
+ *
+ * The pointer is only valid until the next add or delete.
+ *
+ * @param handle The handle returned by addShape.
+ * @return A pointer to the shape, or NULL if it has been deleted.
+ */
+Shape* getShape(ShapeHandle handle) {
+    int index = getShapeIndex(handle);
+    return index == -1 ? NULL : &shapes[index];
+}
+
+/**
+ * @brief Returns the handle of the shape currently stored at an index.
+ *
+ * @param index Index in the shapes array.
+ * @return The handle, or NULL_SHAPE_HANDLE if the index is out of range.
+ */
+ShapeHandle getShapeHandle(int index) {
+    if (index < 0 || index >= shapeCount) return NULL_SHAPE_HANDLE;
+    Uint32 slot = denseToSlot[index];
+    return (ShapeHandle){slot, slots[slot].generation};
+}
+
+/**
+ * @brief Deletes the shape a handle refers to.
+ *
+ * @param handle The handle returned by addShape.
+ * @return true if the shape was deleted, false if the handle was already stale.
+ */
+bool removeShape(ShapeHandle handle) {
+    int index = getShapeIndex(handle);
+    if (index == -1) return false;
+    deleteShape(index);
+    return true;
+}
+
+/**
+ * @brief Deletes the shapes a list of handles refers to.
+ *
+ * Each deletion is O(1) and the draw order is compacted once at the end, so
+ * removing many shapes costs one pass over the scene.
+ *
+ * @param handles The handles returned by addShape. Stale handles are skipped.
+ * @param count The number of handles.
+ * @return The number of shapes deleted.
+ */
+int removeShapes(const ShapeHandle *handles, int count) {
+    int removed = 0;
+    for (int i = 0; i < count; i++) {
+        int index = getShapeIndex(handles[i]);
+        if (index == -1) continue;
+        deleteShape(index);
+        removed++;
+    }
+    compactDrawOrder();
+    return removed;
+}
+
+/**
+ * @brief Deletes every shape in one pass.
+ *
+ * Every handle becomes stale and every slot goes back to the free list, lowest
+ * slot first. The memory is kept for reuse.
+ */
+static void clearShapes(void) {
+    // Invalidate the handles of the live slots, free ones were bumped when released
+    for (int i = 0; i < shapeCount; i++) {
+        Uint32 slot = denseToSlot[i];
+        slots[slot].generation++;
+        if (slots[slot].generation == 0) slots[slot].generation = 1;
+    }
+
+    freeSlot = -1;
+    for (int slot = slotCount - 1; slot > 0; slot--) {
+        slots[slot].nextFree = freeSlot;
+        freeSlot = slot;
+    }
+
+    clearSpatialGrid(&pickGrid);
+    shapeCount = 0;
+    orderCount = 0;
+    invalidateSceneLayers();
+}
+
+/**
+ * @brief Compares two slots by the zIndex of their shapes, for qsort.
+ */
+static int compareDrawOrder(const void *a, const void *b) {
+    int za = shapes[slots[*(const Uint32 *)a].dense].zIndex;
+    int zb = shapes[slots[*(const Uint32 *)b].dense].zIndex;
+    return (za > zb) - (za < zb);
+}
+
+/**
+ * @brief Replaces the whole scene with a copy of the given shapes.
+ *
+ * Shapes are copied as is (z-index and initial values included). Every handle
+ * obtained before the call becomes stale.
+ *
+ * @param source Shapes to copy into the store.
+ * @param count Number of shapes in `source`.
+ */
+void replaceShapes(const Shape *source, int count) {
+    clearShapes();
+
+    nextZIndex = 0;
+    for (int i = 0; i < count; i++) {
+        if (storeShape(&source[i]).slot == 0) return;
+        if (source[i].zIndex >= nextZIndex) nextZIndex = source[i].zIndex + 1;
+    }
+
+    invalidateAnimationLanes();
+
+    // The copied shapes keep their own z-indices, sort them once
+    qsort(drawOrder, shapeCount, sizeof(Uint32), compareDrawOrder);
+    for (int i = 0; i < shapeCount; i++) {
+        slots[drawOrder[i]].order = i;
+    }
+}
+
+/**
+ * @brief Puts the given shapes at the bottom of the draw order, in the given order.
+ *
+ * They get the z-indices 0, 1, 2... in list order and the shapes not listed keep
+ * their relative order above them. Renumbering from 0 leaves the z-index of a shape
+ * unchanged when the same list is given again. The draw order is rebuilt in one
+ * pass, without sorting.
+ *
+ * @param handles The shapes from bottom to top, each listed once. Stale handles are skipped.
+ * @param count The number of handles.
+ */
+void restackShapes(const ShapeHandle *handles, int count) {
+    compactDrawOrder();
+
+    // Mark the listed shapes, their order is rewritten below
+    int listed = 0;
+    for (int i = 0; i < count; i++) {
+        if (getShapeIndex(handles[i]) == -1) continue;
+        slots[handles[i].slot].order = -1;
+        listed++;
+    }
+
+    // Move the others to the top, walking down so that no entry is overwritten before it is read
+    int top = orderCount;
+    for (int i = orderCount - 1; i >= 0; i--) {
+        Uint32 slot = drawOrder[i];
+        if (slots[slot].order == -1) continue;
+        top--;
+        drawOrder[top] = slot;
+        slots[slot].order = top;
+        shapes[slots[slot].dense].zIndex = top;
+    }
+
+    int position = 0;
+    for (int i = 0; i < count && position < listed; i++) {
+        if (getShapeIndex(handles[i]) == -1) continue;
+        drawOrder[position] = handles[i].slot;
+        slots[handles[i].slot].order = position;
+        shapes[slots[handles[i].slot].dense].zIndex = position;
+        position++;
+    }
+
+    nextZIndex = orderCount;
+    invalidateSceneLayers();
+}
+
+/**
+ * @brief Releases the memory held by the shape store.
+ */
+void freeShapes(void) {
+    free(shapes);
+    free(denseToSlot);
+    free(drawOrder);
+    free(slots);
+    shapes = NULL;
+    denseToSlot = NULL;
+    drawOrder = NULL;
+    slots = NULL;
+    shapeCount = shapeCapacity = 0;
+    orderCount = 0;
+    slotCount = slotCapacity = 0;
+    freeSlot = -1;
+    nextZIndex = 0;
+
+    freeSpatialGrid(&pickGrid);
+    free(pickResults);
+    pickResults = NULL;
+    pickCapacity = 0;
+
+    for (int i = 0; i < hitGeometryCapacity; i++) {
+        free(hitGeometry[i].vertexX);
+        free(hitGeometry[i].vertexY);
+    }
+    free(hitGeometry);
+    hitGeometry = NULL;
+    hitGeometryCapacity = 0;
 }
 
 /**
@@ -697,6 +971,8 @@ void deleteShape(int index) {
  * @param zoomFactor The zoom multiplier (positive for zoom in, negative for zoom out).
  */
 void zoomShape(Shape *shape, float zoomFactor) {
+    shape->geometryDirty = true;
+
     switch (shape->type) {
         case SHAPE_RECTANGLE: {
             // Calculate the initial aspect ratio of the rectangle
@@ -870,6 +1146,7 @@ void zoomShape(Shape *shape, float zoomFactor) {
             break;
         }
     }
+    updateShapeInGrid(shape);
 }
 
 /**
@@ -884,6 +1161,8 @@ void rotateShape(Shape *shape, float angle) {
 
     // Update the rotation angle
     shape->rotation += angle;
+    shape->geometryDirty = true;
+    invalidateAnimationLanes();
 
     // Normalize the rotation to stay within [0, 360)
     while (shape->rotation >= 360.0f) {
@@ -907,6 +1186,8 @@ void moveShapesWithMouse(Shape *shapes, int shapeCount, SDL_Event *event, Cursor
     for (int i = 0; i < shapeCount; i++) {
         // Check if the current shape is selected
         if (shapes[i].selected) {
+            shapes[i].geometryDirty = true;
+
             // Handle shape movement based on its type
             switch (shapes[i].type) {
                 case SHAPE_RECTANGLE: {
@@ -1003,6 +1284,7 @@ void moveShapesWithMouse(Shape *shapes, int shapeCount, SDL_Event *event, Cursor
                     break;
                 }
             }
+            updateShapeInGrid(&shapes[i]);
         }
     }
 }
@@ -1020,6 +1302,8 @@ void moveSelectedShapes(Shape *shapes, int shapeCount, int dx, int dy) {
     for (int i = 0; i < shapeCount; i++) {
         // Check if the shape is selected
         if (shapes[i].selected) {
+            shapes[i].geometryDirty = true;
+
             // Move the shape based on its type
             switch (shapes[i].type) {
                 case SHAPE_RECTANGLE: {
@@ -1080,6 +1364,7 @@ void moveSelectedShapes(Shape *shapes, int shapeCount, int dx, int dy) {
                     break;
                 }
             }
+            updateShapeInGrid(&shapes[i]);
         }
     }
 }
@@ -1328,6 +1613,238 @@ int isPointInTriangle(int x, int y, int cx, int cy, int radius) {
 }
 
 
+/**
+ * @brief Computes a box containing everything renderShape draws for a shape.
+ *
+ * Covers any rotation, the selection highlight, the line thickness and the rounding
+ * of the gfx primitives, so it is larger than getShapeBounds.
+ *
+ * @param shape The shape.
+ * @param bounds Receives the box.
+ * @return false for shapes without a box (unknown types).
+ */
+bool getShapeDrawBounds(const Shape *shape, SDL_Rect *bounds) {
+    const int margin = 5 + 2;  // Selection highlight, then rounding
+    double cx, cy, reach;
+    switch (shape->type) {
+        case SHAPE_CIRCLE:
+            cx = shape->data.circle.x;
+            cy = shape->data.circle.y;
+            reach = shape->data.circle.radius;
+            break;
+        case SHAPE_RECTANGLE:
+            // Rotated about its integer center, the corners stay within the half diagonal
+            cx = shape->data.rectangle.x + shape->data.rectangle.width / 2;
+            cy = shape->data.rectangle.y + shape->data.rectangle.height / 2;
+            reach = hypot(abs(shape->data.rectangle.width) / 2 + 6.0, abs(shape->data.rectangle.height) / 2 + 6.0);
+            break;
+        case SHAPE_SQUARE:
+            cx = shape->data.square.x + shape->data.square.c / 2;
+            cy = shape->data.square.y + shape->data.square.c / 2;
+            reach = hypot(abs(shape->data.square.c) / 2 + 6.0, abs(shape->data.square.c) / 2 + 6.0);
+            break;
+        case SHAPE_ELLIPSE:
+            cx = shape->data.ellipse.x;
+            cy = shape->data.ellipse.y;
+            reach = fmax(abs(shape->data.ellipse.rx), abs(shape->data.ellipse.ry));
+            break;
+        case SHAPE_LINE:
+            // Rotated about its center, thick lines and the highlight spread half their width
+            cx = (shape->data.line.x1 + shape->data.line.x2) / 2;
+            cy = (shape->data.line.y1 + shape->data.line.y2) / 2;
+            reach = hypot(shape->data.line.x2 - shape->data.line.x1, shape->data.line.y2 - shape->data.line.y1) / 2 + 1
+                  + (shape->data.line.thickness + 4) / 2;
+            break;
+        case SHAPE_POLYGON:
+        case SHAPE_TRIANGLE:
+            cx = shape->data.polygon.cx;
+            cy = shape->data.polygon.cy;
+            reach = abs(shape->data.polygon.radius);
+            break;
+        case SHAPE_ARC:
+            cx = shape->data.arc.x;
+            cy = shape->data.arc.y;
+            reach = abs(shape->data.arc.radius);
+            break;
+        default:
+            return false;
+    }
+
+    int r = (int)ceil(reach) + margin;
+    bounds->x = (int)floor(cx) - r;
+    bounds->y = (int)floor(cy) - r;
+    bounds->w = bounds->h = 2 * r + 1;
+    return true;
+}
+
+/**
+ * @brief Computes the box a point must be in to hit a shape.
+ *
+ * Lines are hit within their tolerance around the segment rotated about its center,
+ * so their box covers every rotation. isPointInEllipse divides integers, which
+ * accepts points up to sqrt(2) radii away along an axis, so ellipses get a wider box.
+ */
+static void getPickBounds(const Shape *shape, int *minX, int *minY, int *maxX, int *maxY) {
+    if (shape->type == SHAPE_LINE) {
+        int dx = shape->data.line.x2 - shape->data.line.x1;
+        int dy = shape->data.line.y2 - shape->data.line.y1;
+        int centerX = (shape->data.line.x1 + shape->data.line.x2) / 2;
+        int centerY = (shape->data.line.y1 + shape->data.line.y2) / 2;
+
+        // Hit tests use a tolerance of thickness + 5, or 5 + 5 in isPointInShape
+        int tolerance = (int)fmax(shape->data.line.thickness, 5) + 5;
+        int reach = (int)ceil(sqrt((double)dx * dx + (double)dy * dy) / 2) + tolerance + 1;
+        *minX = centerX - reach; *maxX = centerX + reach;
+        *minY = centerY - reach; *maxY = centerY + reach;
+        return;
+    }
+
+    if (shape->type == SHAPE_ELLIPSE) {
+        int rx = shape->data.ellipse.rx * 3 / 2 + 1, ry = shape->data.ellipse.ry * 3 / 2 + 1;
+        *minX = shape->data.ellipse.x - rx; *maxX = shape->data.ellipse.x + rx;
+        *minY = shape->data.ellipse.y - ry; *maxY = shape->data.ellipse.y + ry;
+        return;
+    }
+
+    if (!getShapeBounds(shape, minX, minY, maxX, maxY)) {
+        // Unknown shapes can be hit anywhere
+        *minX = *minY = INT_MIN / 2;
+        *maxX = *maxY = INT_MAX / 2;
+    }
+}
+
+/**
+ * @brief Maps a direction to [0, 4), increasing with its angle over [0, 360) degrees.
+ *
+ * Compares like the atan2 angle, without trigonometry.
+ */
+static float getPseudoAngle(float dx, float dy) {
+    if (dx == 0 && dy == 0) return 0;  // atan2(0, 0) is 0
+    if (dy >= 0) return (dx >= 0) ? dy / (dx + dy) : 1 - dx / (dy - dx);
+    return (dx < 0) ? 2 - dy / (-dx - dy) : 3 + dx / (dx - dy);
+}
+
+/**
+ * @brief Converts an arc limit in degrees to a pseudo-angle.
+ *
+ * Limits outside [0, 360) are kept below or above every direction, as the angle
+ * comparisons of isPointInArc do.
+ */
+static float getArcLimit(int degrees) {
+    if (degrees < 0) return -1;
+    if (degrees >= 360) return 4;
+    double angle = degrees * M_PI / 180.0;
+    return getPseudoAngle(cos(angle), sin(angle));
+}
+
+/**
+ * @brief Rebuilds the hit-test data of a shape.
+ *
+ * The vertices are computed exactly as isPointInPolygon and isPointInTriangle do.
+ *
+ * @return 0 on success, -1 if the vertices could not be allocated.
+ */
+static int buildHitGeometry(HitGeometry *hit, const Shape *shape) {
+    int cx = 0, cy = 0, radius = 0, sides = 0;
+    if (shape->type == SHAPE_POLYGON) {
+        cx = shape->data.polygon.cx;
+        cy = shape->data.polygon.cy;
+        radius = shape->data.polygon.radius;
+        sides = shape->data.polygon.sides;
+    } else if (shape->type == SHAPE_TRIANGLE) {
+        cx = shape->data.triangle.cx;
+        cy = shape->data.triangle.cy;
+        radius = shape->data.triangle.radius;
+        sides = 3;
+    }
+    if (sides < 3) sides = 0;  // Not a polygon, never hit
+
+    hit->valid = false;
+    if (sides > hit->vertexCapacity) {
+        float *vertexX = realloc(hit->vertexX, sides * sizeof(float));
+        if (!vertexX) return -1;
+        hit->vertexX = vertexX;
+        float *vertexY = realloc(hit->vertexY, sides * sizeof(float));
+        if (!vertexY) return -1;
+        hit->vertexY = vertexY;
+        hit->vertexCapacity = sides;
+    }
+    for (int i = 0; i < sides; i++) {
+        float angle = (2 * M_PI * i) / sides;
+        hit->vertexX[i] = cx + radius * cos(angle);
+        hit->vertexY[i] = cy + radius * sin(angle);
+    }
+    hit->vertexCount = sides;
+
+    if (shape->type == SHAPE_ARC) {
+        hit->arcStart = getArcLimit(shape->data.arc.start_angle);
+        hit->arcEnd = getArcLimit(shape->data.arc.end_angle);
+    }
+
+    getPickBounds(shape, &hit->minX, &hit->minY, &hit->maxX, &hit->maxY);
+    hit->type = shape->type;
+    memcpy(hit->data, &shape->data, sizeof(hit->data));
+    hit->valid = true;
+    return 0;
+}
+
+/**
+ * @brief Returns the hit-test data of a stored shape, rebuilt if its geometry changed.
+ *
+ * @param shape The shape.
+ * @return The data, or NULL for shapes outside the store or if memory ran out.
+ */
+static HitGeometry* getHitGeometry(const Shape *shape) {
+    if (shape < shapes || shape >= shapes + shapeCount) return NULL;
+
+    Uint32 slot = denseToSlot[shape - shapes];
+    if ((int)slot >= hitGeometryCapacity) {
+        int capacity = hitGeometryCapacity ? hitGeometryCapacity : 64;
+        while (capacity <= (int)slot) capacity *= 2;
+        HitGeometry *newCache = realloc(hitGeometry, capacity * sizeof(HitGeometry));
+        if (!newCache) return NULL;
+        memset(newCache + hitGeometryCapacity, 0, (capacity - hitGeometryCapacity) * sizeof(HitGeometry));
+        hitGeometry = newCache;
+        hitGeometryCapacity = capacity;
+    }
+
+    HitGeometry *hit = &hitGeometry[slot];
+    if (hit->valid && hit->type == shape->type && memcmp(hit->data, &shape->data, sizeof(hit->data)) == 0) {
+        return hit;
+    }
+    return buildHitGeometry(hit, shape) == 0 ? hit : NULL;
+}
+
+/**
+ * @brief Ray-crossing test against precomputed vertices, same arithmetic as isPointInPolygon.
+ */
+static bool isPointInVertices(int x, int y, const float *vertexX, const float *vertexY, int count) {
+    bool inside = false;
+    for (int i = 0, j = count - 1; i < count; j = i++) {
+        float x1 = vertexX[i], y1 = vertexY[i];
+        float x2 = vertexX[j], y2 = vertexY[j];
+        if (((y1 > y) != (y2 > y)) && (x < (x2 - x1) * (y - y1) / (y2 - y1) + x1)) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+/**
+ * @brief isPointInArc with the limits already converted to pseudo-angles.
+ */
+static bool isPointInCachedArc(const Shape *shape, const HitGeometry *hit, int x, int y) {
+    int dx = x - shape->data.arc.x;
+    int dy = y - shape->data.arc.y;
+    if (dx * dx + dy * dy > shape->data.arc.radius * shape->data.arc.radius) return false;
+
+    float angle = getPseudoAngle(dx, dy);
+    if (shape->data.arc.start_angle <= shape->data.arc.end_angle) {
+        return angle >= hit->arcStart && angle <= hit->arcEnd;
+    }
+    return angle >= hit->arcStart || angle <= hit->arcEnd;
+}
+
 /**
  * @brief Checks if a point is inside a given shape.
  * 
@@ -1340,8 +1857,26 @@ int isPointInTriangle(int x, int y, int cx, int cy, int radius) {
  * @param x The x-coordinate of the point to check.
  * @param y The y-coordinate of the point to check.
  * @return bool Returns true if the point is inside the shape, false otherwise.
+ *
+ * Stored shapes are first rejected by their cached pick box, and polygons, triangles
+ * and arcs are then tested on cached data without trigonometry.
  */
 bool isPointInShape(Shape* shape, int x, int y) {
+    HitGeometry *hit = getHitGeometry(shape);
+    if (hit) {
+        if (x < hit->minX || x > hit->maxX || y < hit->minY || y > hit->maxY) return false;
+
+        switch (shape->type) {
+            case SHAPE_POLYGON:
+            case SHAPE_TRIANGLE:
+                return isPointInVertices(x, y, hit->vertexX, hit->vertexY, hit->vertexCount);
+            case SHAPE_ARC:
+                return isPointInCachedArc(shape, hit, x, y);
+            default:
+                break;  // The other tests are cheap enough as they are
+        }
+    }
+
     switch (shape->type) {
         case SHAPE_CIRCLE:
             return isPointInCircle(x, y, 
@@ -1404,29 +1939,141 @@ bool isPointInShape(Shape* shape, int x, int y) {
     }
 }
 
+/**
+ * @brief Computes the axis-aligned box of a shape, ignoring its rotation.
+ *
+ * @return false for shapes without a box (unknown types).
+ */
+bool getShapeBounds(const Shape *shape, int *minX, int *minY, int *maxX, int *maxY) {
+    switch (shape->type) {
+        case SHAPE_CIRCLE:
+            *minX = shape->data.circle.x - shape->data.circle.radius;
+            *minY = shape->data.circle.y - shape->data.circle.radius;
+            *maxX = shape->data.circle.x + shape->data.circle.radius;
+            *maxY = shape->data.circle.y + shape->data.circle.radius;
+            return true;
+        case SHAPE_RECTANGLE:
+            *minX = shape->data.rectangle.x;
+            *minY = shape->data.rectangle.y;
+            *maxX = shape->data.rectangle.x + shape->data.rectangle.width;
+            *maxY = shape->data.rectangle.y + shape->data.rectangle.height;
+            return true;
+        case SHAPE_SQUARE:
+            *minX = shape->data.square.x;
+            *minY = shape->data.square.y;
+            *maxX = shape->data.square.x + shape->data.square.c;
+            *maxY = shape->data.square.y + shape->data.square.c;
+            return true;
+        case SHAPE_ELLIPSE:
+            *minX = shape->data.ellipse.x - shape->data.ellipse.rx;
+            *minY = shape->data.ellipse.y - shape->data.ellipse.ry;
+            *maxX = shape->data.ellipse.x + shape->data.ellipse.rx;
+            *maxY = shape->data.ellipse.y + shape->data.ellipse.ry;
+            return true;
+        case SHAPE_LINE:
+            *minX = fmin(shape->data.line.x1, shape->data.line.x2);
+            *minY = fmin(shape->data.line.y1, shape->data.line.y2);
+            *maxX = fmax(shape->data.line.x1, shape->data.line.x2);
+            *maxY = fmax(shape->data.line.y1, shape->data.line.y2);
+            return true;
+        case SHAPE_POLYGON:
+        case SHAPE_TRIANGLE:
+            // Triangles share the polygon layout (cx, cy, radius)
+            *minX = shape->data.polygon.cx - shape->data.polygon.radius;
+            *minY = shape->data.polygon.cy - shape->data.polygon.radius;
+            *maxX = shape->data.polygon.cx + shape->data.polygon.radius;
+            *maxY = shape->data.polygon.cy + shape->data.polygon.radius;
+            return true;
+        case SHAPE_ARC:
+            *minX = shape->data.arc.x - shape->data.arc.radius;
+            *minY = shape->data.arc.y - shape->data.arc.radius;
+            *maxX = shape->data.arc.x + shape->data.arc.radius;
+            *maxY = shape->data.arc.y + shape->data.arc.radius;
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Refreshes the pick box of a stored shape after its position or size changed.
+ *
+ * Shapes that are not in the store (copies, game enemies) are ignored.
+ *
+ * @param shape The shape that changed.
+ */
+void updateShapeInGrid(Shape *shape) {
+    if (shape < shapes || shape >= shapes + shapeCount) return;
+
+    int minX, minY, maxX, maxY;
+    getPickBounds(shape, &minX, &minY, &maxX, &maxY);
+    updateGridBox(&pickGrid, denseToSlot[shape - shapes], minX, minY, maxX, maxY);
+}
+
+/**
+ * @brief Finds the shapes whose pick box contains a point.
+ *
+ * This is the broad phase of picking: only the grid cell of the point is looked at,
+ * the caller runs the exact isPointIn* test on the returned shapes.
+ *
+ * @param x,y The point in pixels.
+ * @param indices Receives the indices in the shapes array, valid until the next query,
+ *                add or delete.
+ * @return The number of shapes, in no particular order.
+ */
+int queryShapesAt(int x, int y, const int **indices) {
+    const Uint32 *keys;
+    int count = queryGridPoint(&pickGrid, x, y, &keys);
+
+    if (count > pickCapacity) {
+        int *results = realloc(pickResults, count * sizeof(int));
+        if (!results) {
+            printf("%sExecutionError: Memory allocation failed for the pick results\n", RED_COLOR);
+            count = pickCapacity;
+        } else {
+            pickResults = results;
+            pickCapacity = count;
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        pickResults[i] = slots[keys[i]].dense;
+    }
+    *indices = pickResults;
+    return count;
+}
+
+/**
+ * @brief Swaps two neighbouring entries of the draw order along with their z-indices.
+ *
+ * @param position Position of the lower shape in the draw order.
+ */
+static void swapDrawOrder(int position) {
+    Uint32 lower = drawOrder[position];
+    Uint32 upper = drawOrder[position + 1];
+
+    int temp = shapes[slots[lower].dense].zIndex;
+    shapes[slots[lower].dense].zIndex = shapes[slots[upper].dense].zIndex;
+    shapes[slots[upper].dense].zIndex = temp;
+
+    drawOrder[position] = upper;
+    drawOrder[position + 1] = lower;
+    slots[upper].order = position;
+    slots[lower].order = position + 1;
+    invalidateSceneLayers();
+}
+
 /**
  * @brief Moves a selected shape one layer up in the z-order
  */
 void moveShapeUp() {
+    compactDrawOrder();
     for (int i = 0; i < shapeCount; i++) {
         if (shapes[i].selected) {
-            // Find the shape with the next highest z-index
-            int currentZ = shapes[i].zIndex;
-            int swapIndex = -1;
-            int nextHighestZ = INT_MAX;
-            
-            for (int j = 0; j < shapeCount; j++) {
-                if (shapes[j].zIndex > currentZ && shapes[j].zIndex < nextHighestZ) {
-                    nextHighestZ = shapes[j].zIndex;
-                    swapIndex = j;
-                }
-            }
-            
-            // If we found a shape to swap with, swap their z-indices
-            if (swapIndex != -1) {
-                int temp = shapes[i].zIndex;
-                shapes[i].zIndex = shapes[swapIndex].zIndex;
-                shapes[swapIndex].zIndex = temp;
+            // Swap with the shape drawn right above it, if any
+            int position = slots[denseToSlot[i]].order;
+            if (position < shapeCount - 1) {
+                swapDrawOrder(position);
             }
             break;
         }
@@ -1437,25 +2084,13 @@ void moveShapeUp() {
  * @brief Moves a selected shape one layer down in the z-order
  */
 void moveShapeDown() {
+    compactDrawOrder();
     for (int i = 0; i < shapeCount; i++) {
         if (shapes[i].selected) {
-            // Find the shape with the next lowest z-index
-            int currentZ = shapes[i].zIndex;
-            int swapIndex = -1;
-            int nextLowestZ = -1;
-            
-            for (int j = 0; j < shapeCount; j++) {
-                if (shapes[j].zIndex < currentZ && shapes[j].zIndex > nextLowestZ) {
-                    nextLowestZ = shapes[j].zIndex;
-                    swapIndex = j;
-                }
-            }
-            
-            // If we found a shape to swap with, swap their z-indices
-            if (swapIndex != -1) {
-                int temp = shapes[i].zIndex;
-                shapes[i].zIndex = shapes[swapIndex].zIndex;
-                shapes[swapIndex].zIndex = temp;
+            // Swap with the shape drawn right below it, if any
+            int position = slots[denseToSlot[i]].order;
+            if (position > 0) {
+                swapDrawOrder(position - 1);
             }
             break;
         }
@@ -1482,6 +2117,7 @@ void toggleAnimation() {
         if (shapes[i].selected) {
             shapes[i].selected = false;
             shapes[i].isAnimating = !shapes[i].isAnimating;
+            invalidateAnimationLanes();
             break;
         }
     }
@@ -1501,6 +2137,13 @@ void resetShape(Shape *shape) {
     shape->zoom_direction = 1.0f;
     shape->color_phase = 0.0f;
     shape->bounce_velocity = 0.0f;
+    shape->bounce_direction = 0.0f;
+    shape->bounce_remainder_x = 0.0f;
+    shape->bounce_remainder_y = 0.0f;
+    shape->animation_lag = 0.0f;
+    shape->geometryDirty = true;
+    invalidateAnimationLanes();
+    invalidateSceneLayers();
 
     // Reset shape-specific properties (excluding position)
     switch (shape->type) {
@@ -1534,6 +2177,7 @@ void resetShape(Shape *shape) {
             shape->data.arc.end_angle = shape->data.arc.initial_end_angle;
             break;
     }
+    updateShapeInGrid(shape);
 }
 
 /**
@@ -1545,6 +2189,8 @@ void resetShape(Shape *shape) {
  */
 void moveShape(Shape *shape, int dx, int dy) {
     if (!shape) return;
+    shape->geometryDirty = true;
+    if (!shape->selected && !shape->isAnimating) invalidateSceneLayers();  // Moved by a game
 
     switch (shape->type) {
         case SHAPE_CIRCLE:
@@ -1582,4 +2228,5 @@ void moveShape(Shape *shape, int dx, int dy) {
             shape->data.arc.y += dy;
             break;
     }
+    updateShapeInGrid(shape);
 }
\ No newline at end of file
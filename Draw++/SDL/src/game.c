@@ -1,5 +1,11 @@
 #include "../files.h/game.h"
+#include "../files.h/text.h"
+#include "../files.h/sceneLayers.h"
 #include <math.h>
+#include <string.h>
+
+// ANSI escape codes for colors
+#define RED_COLOR "-#red "
 
 /**
  * @brief Get the name of the specified game type
@@ -37,10 +43,21 @@ void initGame(GameState* game) {
     game->spawnTimer = 2.0f;
     game->basesRemaining = 0;
     
-    // Save existing shapes
+    // Save existing shapes, growing the snapshot buffer if the scene got bigger
+    if (shapeCount > game->savedShapeCapacity) {
+        Shape* newSaved = realloc(game->savedShapes, shapeCount * sizeof(Shape));
+        if (!newSaved) {
+            printf("%sExecutionError: Failed to allocate memory for saved shapes\n", RED_COLOR);
+            game->savedShapeCount = 0;
+            game->hasShapes = false;
+            return;
+        }
+        game->savedShapes = newSaved;
+        game->savedShapeCapacity = shapeCount;
+    }
     game->savedShapeCount = shapeCount;
-    for (int i = 0; i < shapeCount; i++) {
-        game->savedShapes[i] = shapes[i];
+    if (shapeCount > 0) {
+        memcpy(game->savedShapes, shapes, shapeCount * sizeof(Shape));
     }
     
     game->hasShapes = (shapeCount > 0);
@@ -115,12 +132,11 @@ void updateGame(GameState* game, float deltaTime, int cursorX, int cursorY, SDL_
 /**
  * @brief Render the game UI elements
  * @param renderer SDL renderer pointer
- * @param font TTF font for text rendering
  * @param game Pointer to the current game state
  * 
  * Renders score, timer, game messages, and instructions based on the current game state.
  */
-void renderGameUI(SDL_Renderer* renderer, TTF_Font* font, GameState* game, int bgcolorR, int bgcolorG, int bgcolorB) {
+void renderGameUI(SDL_Renderer* renderer, GameState* game, int bgcolorR, int bgcolorG, int bgcolorB) {
     // Get the inverse color for the text
     SDL_Color textColor = getInverseColor(bgcolorR, bgcolorG, bgcolorB);
     
@@ -138,22 +154,10 @@ void renderGameUI(SDL_Renderer* renderer, TTF_Font* font, GameState* game, int b
                      game->score, game->timeLeft);
         }
         
-        // Use Blended rendering for better quality
-        SDL_Surface* surface = TTF_RenderText_Blended(font, scoreText, textColor);
-        if (!surface) return;
-
-        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-        SDL_FreeSurface(surface);
-        if (!texture) return;
-
-        SDL_Rect textRect = {0, 0, 0, 0};
-        SDL_QueryTexture(texture, NULL, NULL, &textRect.w, &textRect.h);
-        textRect.w = (int)(textRect.w * 1.5f);
-        textRect.h = (int)(textRect.h * 1.5f);
-        textRect.x = (windowWidth - textRect.w) / 2;
-        textRect.y = 20;
-        SDL_RenderCopy(renderer, texture, NULL, &textRect);
-        SDL_DestroyTexture(texture);
+        // Text 1.5x larger, centered at the top
+        int textW;
+        getTextSize(scoreText, 1.5f, 0, &textW, NULL);
+        renderText(renderer, scoreText, (windowWidth - textW) / 2, 20, textColor, 1.5f, 0);
         
         // Render defense game enemies if in defense mode
         if (game->currentGame == GAME_DEFENSE) {
@@ -170,24 +174,10 @@ void renderGameUI(SDL_Renderer* renderer, TTF_Font* font, GameState* game, int b
             snprintf(centerMessage, sizeof(centerMessage), "GAME OVER ! Final Score: %d", game->score);
         }
 
-        SDL_Surface* surface = TTF_RenderText_Blended(font, centerMessage, textColor);
-        if (surface) {
-            SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-            if (texture) {
-                SDL_Rect messageRect = {0, 0, 0, 0};
-                SDL_QueryTexture(texture, NULL, NULL, &messageRect.w, &messageRect.h);
-                // Make the text 2x larger
-                messageRect.w = (int)(messageRect.w * 2.0);
-                messageRect.h = (int)(messageRect.h * 2.0);
-                // Center the message
-                messageRect.x = (windowWidth - messageRect.w) / 2;
-                messageRect.y = (windowHeight - messageRect.h) / 2;
-                
-                SDL_RenderCopy(renderer, texture, NULL, &messageRect);
-                SDL_DestroyTexture(texture);
-            }
-            SDL_FreeSurface(surface);
-        }
+        // Make the text 2x larger and center it
+        int messageW, messageH;
+        getTextSize(centerMessage, 2.0f, 0, &messageW, &messageH);
+        renderText(renderer, centerMessage, (windowWidth - messageW) / 2, (windowHeight - messageH) / 2, textColor, 2.0f, 0);
     }
 
     // Message at bottom of screen (instructions)
@@ -206,23 +196,10 @@ void renderGameUI(SDL_Renderer* renderer, TTF_Font* font, GameState* game, int b
         }
     }
 
-    // Render bottom message
-    SDL_Surface* surface = TTF_RenderText_Blended(font, message, textColor);
-    if (!surface) return;
-
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
-    if (!texture) return;
-
-    SDL_Rect messageRect = {0, 0, 0, 0};
-    SDL_QueryTexture(texture, NULL, NULL, &messageRect.w, &messageRect.h);
-    messageRect.w = (int)(messageRect.w * 1.5);
-    messageRect.h = (int)(messageRect.h * 1.5);
-    messageRect.x = (windowWidth - messageRect.w) / 2;
-    messageRect.y = windowHeight - messageRect.h - 20;
-    
-    SDL_RenderCopy(renderer, texture, NULL, &messageRect);
-    SDL_DestroyTexture(texture);
+    // Render bottom message, 1.5x larger
+    int messageW, messageH;
+    getTextSize(message, 1.5f, 0, &messageW, &messageH);
+    renderText(renderer, message, (windowWidth - messageW) / 2, windowHeight - messageH - 20, textColor, 1.5f, 0);
 }
 
 /**
@@ -232,14 +209,23 @@ void renderGameUI(SDL_Renderer* renderer, TTF_Font* font, GameState* game, int b
  * Restores all shapes from the saved state, maintaining their original properties.
  */
 void restoreShapes(GameState* game) {
-    // Clear current shapes
-    shapeCount = 0;
-    
-    // Restore saved shapes to their original positions
-    for (int i = 0; i < game->savedShapeCount; i++) {
-        shapes[i] = game->savedShapes[i];
-    }
-    shapeCount = game->savedShapeCount;
+    // Replace current shapes with the saved ones, at their original positions
+    replaceShapes(game->savedShapes, game->savedShapeCount);
+}
+
+/**
+ * @brief Release the memory owned by a game state
+ * @param game Pointer to the game state to free
+ */
+void freeGame(GameState* game) {
+    free(game->savedShapes);
+    game->savedShapes = NULL;
+    game->savedShapeCount = 0;
+    game->savedShapeCapacity = 0;
+    freeSpatialGrid(&game->baseGrid);
+    free(game->baseHandles);
+    game->baseHandles = NULL;
+    game->baseHandleCapacity = 0;
 }
 
 /**
@@ -252,9 +238,6 @@ void restoreShapes(GameState* game) {
  * while maintaining their original properties and dimensions.
  */
 void resetShapes(GameState* game, SDL_Window* window, SDL_Renderer* renderer) {
-    // Clear current shapes
-    shapeCount = 0;
-    
     // Get window dimensions for random positioning
     int windowWidth, windowHeight;
     SDL_GetRendererOutputSize(renderer, &windowWidth, &windowHeight);
@@ -266,10 +249,7 @@ void resetShapes(GameState* game, SDL_Window* window, SDL_Renderer* renderer) {
     int spreadY = windowHeight / 4; // 25% of height on each side of center
     
     // Restore saved shapes with random positions
-    for (int i = 0; i < game->savedShapeCount; i++) {
-        shapes[i] = game->savedShapes[i];
-    }
-    shapeCount = game->savedShapeCount;
+    replaceShapes(game->savedShapes, game->savedShapeCount);
     
     // Reset game-specific variables
     if (game->currentGame == GAME_DEFENSE) {
@@ -292,6 +272,8 @@ void resetShapes(GameState* game, SDL_Window* window, SDL_Renderer* renderer) {
     
     // Randomize positions in center area
     for (int i = 0; i < shapeCount; i++) {
+        shapes[i].geometryDirty = true;
+
         // Calculate margins based on shape type
         int marginX = 0, marginY = 0;
         switch (shapes[i].type) {
@@ -349,7 +331,9 @@ void resetShapes(GameState* game, SDL_Window* window, SDL_Renderer* renderer) {
                 shapes[i].data.arc.y = centerY + (rand() % (2 * spreadY) - spreadY);
                 break;
         }
+        updateShapeInGrid(&shapes[i]);
     }
+    invalidateSceneLayers();
 }
 
 /**
@@ -374,9 +358,8 @@ void escapeRun(GameState* game, int cursorX, int cursorY) {
     SDL_GetRendererOutputSize(renderer, &windowWidth, &windowHeight);
     
     // Process each shape
+    // Walk backwards: deleting swaps the last shape into index i, which was already processed
     for (int i = shapeCount - 1; i >= 0; i--) {
-        if (i >= MAX_SHAPES) continue;  // Safety check
-        
         // Calculate shape center and check if caught
         int shapeX = 0, shapeY = 0;
         bool isCaught = false;
@@ -428,22 +411,13 @@ void escapeRun(GameState* game, int cursorX, int cursorY) {
                 if (shapes[i].data.triangle.radius <= 0) continue;  // Safety check
                 shapeX = shapes[i].data.triangle.cx;
                 shapeY = shapes[i].data.triangle.cy;
-                {
-                    isCaught = isPointInTriangle(cursorX, cursorY,
-                        shapes[i].data.triangle.cx, shapes[i].data.triangle.cy,
-                        shapes[i].data.triangle.radius);
-                }
+                isCaught = isPointInShape(&shapes[i], cursorX, cursorY);  // Cached vertices
                 break;
             case SHAPE_POLYGON:
                 if (shapes[i].data.polygon.radius <= 0) continue;  // Safety check
                 shapeX = shapes[i].data.polygon.cx;
                 shapeY = shapes[i].data.polygon.cy;
-                {
-                    isCaught = isPointInPolygon(cursorX, cursorY,
-                        shapes[i].data.polygon.cx, shapes[i].data.polygon.cy,
-                        shapes[i].data.polygon.radius,
-                        shapes[i].data.polygon.sides);
-                }
+                isCaught = isPointInShape(&shapes[i], cursorX, cursorY);  // Cached vertices
                 break;
             case SHAPE_LINE:
                 if (shapes[i].data.line.thickness <= 0) continue;  // Safety check
@@ -462,13 +436,7 @@ void escapeRun(GameState* game, int cursorX, int cursorY) {
                 if (shapes[i].data.arc.radius <= 0) continue;  // Safety check
                 shapeX = shapes[i].data.arc.x;
                 shapeY = shapes[i].data.arc.y;
-                {
-                    isCaught = isPointInArc(cursorX, cursorY,
-                        shapes[i].data.arc.x, shapes[i].data.arc.y,
-                        shapes[i].data.arc.radius,
-                        shapes[i].data.arc.start_angle,
-                        shapes[i].data.arc.end_angle);
-                }
+                isCaught = isPointInShape(&shapes[i], cursorX, cursorY);  // Cached arc limits
                 break;
             default:
                 continue;  // Skip unsupported shapes
@@ -571,6 +539,161 @@ void escapeRun(GameState* game, int cursorX, int cursorY) {
     }
 }
 
+/**
+ * @brief Narrow-phase collision test between an enemy and a base
+ * @param base The base shape
+ * @param enemyX X coordinate of the enemy center
+ * @param enemyY Y coordinate of the enemy center
+ * @param enemyRadius Radius of the enemy
+ * @return true if the enemy touches the base
+ */
+static bool collidesWithBase(const Shape* base, float enemyX, float enemyY, float enemyRadius) {
+    switch (base->type) {
+        case SHAPE_CIRCLE: {
+            float dx = enemyX - base->data.circle.x;
+            float dy = enemyY - base->data.circle.y;
+            float minDist = enemyRadius + base->data.circle.radius;
+            if (dx*dx + dy*dy < minDist*minDist) {
+                return true;
+            }
+            break;
+        }
+        case SHAPE_RECTANGLE: {
+            // Simple AABB collision
+            float shapeX = base->data.rectangle.x + base->data.rectangle.width/2;
+            float shapeY = base->data.rectangle.y + base->data.rectangle.height/2;
+            float dx = fabs(enemyX - shapeX);
+            float dy = fabs(enemyY - shapeY);
+            if (dx < base->data.rectangle.width/2 + enemyRadius &&
+                dy < base->data.rectangle.height/2 + enemyRadius) {
+                return true;
+            }
+            break;
+        }
+        case SHAPE_SQUARE: {
+            float shapeX = base->data.square.x + base->data.square.c/2;
+            float shapeY = base->data.square.y + base->data.square.c/2;
+            float dx = fabs(enemyX - shapeX);
+            float dy = fabs(enemyY - shapeY);
+            if (dx < base->data.square.c/2 + enemyRadius &&
+                dy < base->data.square.c/2 + enemyRadius) {
+                return true;
+            }
+            break;
+        }
+        case SHAPE_ELLIPSE: {
+            float dx = (enemyX - base->data.ellipse.x) / (float)(base->data.ellipse.rx + enemyRadius);
+            float dy = (enemyY - base->data.ellipse.y) / (float)(base->data.ellipse.ry + enemyRadius);
+            if (dx*dx + dy*dy <= 1.0f) {
+                return true;
+            }
+            break;
+        }
+        case SHAPE_TRIANGLE: {
+            float dx = enemyX - base->data.triangle.cx;
+            float dy = enemyY - base->data.triangle.cy;
+            float minDist = enemyRadius + base->data.triangle.radius;
+            if (dx*dx + dy*dy < minDist*minDist) {
+                return true;
+            }
+            break;
+        }
+        case SHAPE_POLYGON: {
+            float dx = enemyX - base->data.polygon.cx;
+            float dy = enemyY - base->data.polygon.cy;
+            float minDist = enemyRadius + base->data.polygon.radius;
+            if (dx*dx + dy*dy < minDist*minDist) {
+                return true;
+            }
+            break;
+        }
+        case SHAPE_ARC: {
+            float dx = enemyX - base->data.arc.x;
+            float dy = enemyY - base->data.arc.y;
+            float minDist = enemyRadius + base->data.arc.radius;
+            if (dx*dx + dy*dy < minDist*minDist) {
+                return true;
+            }
+            break;
+        }
+        case SHAPE_LINE: {
+            // Utiliser isPointInLine pour une détection précise
+            if (isPointInLine(enemyX, enemyY,
+                             base->data.line.x1, base->data.line.y1,
+                             base->data.line.x2, base->data.line.y2,
+                             base->data.line.thickness + enemyRadius,
+                             base->rotation)) {
+                return true;
+            }
+            break;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Box of a base for the broad phase, before the enemy radius is added
+ * @param base The base shape
+ * @param minX Receives the left edge
+ * @param minY Receives the top edge
+ * @param maxX Receives the right edge
+ * @param maxY Receives the bottom edge
+ * @return false for shapes enemies cannot collide with
+ *
+ * Matches the tests of collidesWithBase. isPointInLine accepts a rectangle around the
+ * segment, rotated about its center, so a line gets the circle through the corners of
+ * that rectangle. The enemy radius widens it on both axes, which queries must cover by
+ * padding with radius * sqrt(2).
+ */
+static bool getBaseBounds(const Shape* base, int* minX, int* minY, int* maxX, int* maxY) {
+    if (base->type == SHAPE_LINE) {
+        float lineX = (base->data.line.x1 + base->data.line.x2) / 2.0f;
+        float lineY = (base->data.line.y1 + base->data.line.y2) / 2.0f;
+        float dx = base->data.line.x2 - base->data.line.x1;
+        float dy = base->data.line.y2 - base->data.line.y1;
+        float tolerance = base->data.line.thickness + 5;
+        float extent = hypotf(sqrtf(dx*dx + dy*dy) / 2 + tolerance, tolerance);
+        *minX = (int)floorf(lineX - extent);
+        *minY = (int)floorf(lineY - extent);
+        *maxX = (int)ceilf(lineX + extent);
+        *maxY = (int)ceilf(lineY + extent);
+    } else if (!getShapeBounds(base, minX, minY, maxX, maxY)) {
+        return false;
+    }
+    // Margin for the rounding of the narrow phase
+    (*minX)--; (*minY)--;
+    (*maxX)++; (*maxY)++;
+    return true;
+}
+
+/**
+ * @brief Build the broad phase of the defense collisions
+ * @param game Pointer to the current game state
+ *
+ * Stores the box of every base in the grid, keyed by its index in baseHandles.
+ * Bases do not move during a round, so the grid is only built when it starts.
+ */
+static void buildBaseGrid(GameState* game) {
+    clearSpatialGrid(&game->baseGrid);
+    if (shapeCount > game->baseHandleCapacity) {
+        ShapeHandle* handles = realloc(game->baseHandles, shapeCount * sizeof(ShapeHandle));
+        if (!handles) {
+            printf("%sExecutionError: Failed to allocate memory for the defense bases\n", RED_COLOR);
+            return;
+        }
+        game->baseHandles = handles;
+        game->baseHandleCapacity = shapeCount;
+    }
+
+    for (int i = 0; i < shapeCount; i++) {
+        int minX, minY, maxX, maxY;
+        game->baseHandles[i] = getShapeHandle(i);
+        if (getBaseBounds(&shapes[i], &minX, &minY, &maxX, &maxY)) {
+            updateGridBox(&game->baseGrid, (Uint32)i, minX, minY, maxX, maxY);
+        }
+    }
+}
+
 /**
  * @brief Initialize the defense game mode
  * @param game Pointer to the current game state
@@ -587,6 +710,7 @@ void initDefenseMode(GameState* game) {
 
     // Normalize base shapes size for better gameplay
     for (int i = 0; i < shapeCount; i++) {
+        shapes[i].geometryDirty = true;
         switch (shapes[i].type) {
             case SHAPE_CIRCLE:
                 if (shapes[i].data.circle.radius > 50)
@@ -625,7 +749,10 @@ void initDefenseMode(GameState* game) {
                     shapes[i].data.arc.radius = 50;
                 break;
         }
+        updateShapeInGrid(&shapes[i]);
     }
+    invalidateSceneLayers();
+    buildBaseGrid(game);
 }
 
 /**
@@ -656,10 +783,7 @@ void spawnEnemy(GameState* game, SDL_Window* window, SDL_Renderer* renderer) {
     enemy->shape.bounce_velocity = 0;
     enemy->shape.bounce_direction = 0;
     enemy->shape.data.circle.radius = 15;  // Set radius before using it for spawn position
-    enemy->shape.typeForm = (char*)malloc(7);
-    if (enemy->shape.typeForm) {
-        strcpy(enemy->shape.typeForm, "filled");
-    }
+    enemy->shape.typeForm = FORM_FILLED;
     
     // Randomly choose spawn side (0: top, 1: right, 2: bottom, 3: left)
     int side = rand() % 4;
@@ -737,12 +861,6 @@ void updateDefenseGame(GameState* game, float deltaTime, int cursorX, int cursor
         game->won = (game->basesRemaining > 0 && game->timeLeft <= 0);  // Win if time ran out with bases remaining
         game->winMessageTimer = 0.0f;
         game->gameJustEnded = true;
-        // Clean up all enemies
-        for (int i = 0; i < game->enemyCount; i++) {
-            if (game->enemies[i].shape.typeForm) {
-                free(game->enemies[i].shape.typeForm);
-            }
-        }
         game->enemyCount = 0;  // Clear all enemies when game ends
         return;
     }
@@ -797,10 +915,6 @@ void updateDefenseGame(GameState* game, float deltaTime, int cursorX, int cursor
         }
 
         if (isExiting) {
-            // Free memory for typeForm
-            if (game->enemies[i].shape.typeForm) {
-                free(game->enemies[i].shape.typeForm);
-            }
             // Remove enemy by swapping with last active enemy and decrementing count
             if (i < game->enemyCount - 1) {
                 game->enemies[i] = game->enemies[game->enemyCount - 1];
@@ -816,10 +930,6 @@ void updateDefenseGame(GameState* game, float deltaTime, int cursorX, int cursor
         float enemyR = game->enemies[i].shape.data.circle.radius;
         if (dx*dx + dy*dy < enemyR * enemyR) {  // Using circle's radius for hit detection
             game->score += 1;
-            // Free memory for typeForm
-            if (game->enemies[i].shape.typeForm) {
-                free(game->enemies[i].shape.typeForm);
-            }
             // Remove enemy by swapping with last active enemy and decrementing count
             if (i < game->enemyCount - 1) {
                 game->enemies[i] = game->enemies[game->enemyCount - 1];
@@ -829,115 +939,43 @@ void updateDefenseGame(GameState* game, float deltaTime, int cursorX, int cursor
             continue;
         }
         
-        // Check collision with shapes (bases)
-        bool collided = false;
-        for (int j = 0; j < shapeCount && !collided; j++) {
-            float enemyX = game->enemies[i].shape.data.circle.x;
-            float enemyY = game->enemies[i].shape.data.circle.y;
-            float enemyRadius = game->enemies[i].shape.data.circle.radius;
-            
-            switch (shapes[j].type) {
-                case SHAPE_CIRCLE: {
-                    float dx = enemyX - shapes[j].data.circle.x;
-                    float dy = enemyY - shapes[j].data.circle.y;
-                    float minDist = enemyRadius + shapes[j].data.circle.radius;
-                    if (dx*dx + dy*dy < minDist*minDist) {
-                        collided = true;
-                    }
-                    break;
-                }
-                case SHAPE_RECTANGLE: {
-                    // Simple AABB collision
-                    float shapeX = shapes[j].data.rectangle.x + shapes[j].data.rectangle.width/2;
-                    float shapeY = shapes[j].data.rectangle.y + shapes[j].data.rectangle.height/2;
-                    float dx = fabs(enemyX - shapeX);
-                    float dy = fabs(enemyY - shapeY);
-                    if (dx < shapes[j].data.rectangle.width/2 + enemyRadius &&
-                        dy < shapes[j].data.rectangle.height/2 + enemyRadius) {
-                        collided = true;
-                    }
-                    break;
-                }
-                case SHAPE_SQUARE: {
-                    float shapeX = shapes[j].data.square.x + shapes[j].data.square.c/2;
-                    float shapeY = shapes[j].data.square.y + shapes[j].data.square.c/2;
-                    float dx = fabs(enemyX - shapeX);
-                    float dy = fabs(enemyY - shapeY);
-                    if (dx < shapes[j].data.square.c/2 + enemyRadius &&
-                        dy < shapes[j].data.square.c/2 + enemyRadius) {
-                        collided = true;
-                    }
-                    break;
-                }
-                case SHAPE_ELLIPSE: {
-                    float dx = (enemyX - shapes[j].data.ellipse.x) / (float)(shapes[j].data.ellipse.rx + enemyRadius);
-                    float dy = (enemyY - shapes[j].data.ellipse.y) / (float)(shapes[j].data.ellipse.ry + enemyRadius);
-                    if (dx*dx + dy*dy <= 1.0f) {
-                        collided = true;
-                    }
-                    break;
-                }
-                case SHAPE_TRIANGLE: {
-                    float dx = enemyX - shapes[j].data.triangle.cx;
-                    float dy = enemyY - shapes[j].data.triangle.cy;
-                    float minDist = enemyRadius + shapes[j].data.triangle.radius;
-                    if (dx*dx + dy*dy < minDist*minDist) {
-                        collided = true;
-                    }
-                    break;
-                }
-                case SHAPE_POLYGON: {
-                    float dx = enemyX - shapes[j].data.polygon.cx;
-                    float dy = enemyY - shapes[j].data.polygon.cy;
-                    float minDist = enemyRadius + shapes[j].data.polygon.radius;
-                    if (dx*dx + dy*dy < minDist*minDist) {
-                        collided = true;
-                    }
-                    break;
-                }
-                case SHAPE_ARC: {
-                    float dx = enemyX - shapes[j].data.arc.x;
-                    float dy = enemyY - shapes[j].data.arc.y;
-                    float minDist = enemyRadius + shapes[j].data.arc.radius;
-                    if (dx*dx + dy*dy < minDist*minDist) {
-                        collided = true;
-                    }
-                    break;
-                }
-                case SHAPE_LINE: {
-                    // Utiliser le centre de la ligne et sa longueur pour la collision
-                    float lineX = (shapes[j].data.line.x1 + shapes[j].data.line.x2) / 2;
-                    float lineY = (shapes[j].data.line.y1 + shapes[j].data.line.y2) / 2;
-                    
-                    // Utiliser isPointInLine pour une détection précise
-                    if (isPointInLine(enemyX, enemyY,
-                                     shapes[j].data.line.x1, shapes[j].data.line.y1,
-                                     shapes[j].data.line.x2, shapes[j].data.line.y2,
-                                     shapes[j].data.line.thickness + enemyRadius,
-                                     shapes[j].rotation)) {
-                        collided = true;
-                    }
-                    break;
-                }
+        // Check collision with shapes (bases): the grid gives the bases near the enemy
+        float enemyRadius = game->enemies[i].shape.data.circle.radius;
+        float reach = enemyRadius * (float)M_SQRT2;  // See getBaseBounds
+        const Uint32* candidates;
+        int candidateCount = queryGridBox(&game->baseGrid,
+                                          (int)floorf(enemyX - reach), (int)floorf(enemyY - reach),
+                                          (int)ceilf(enemyX + reach), (int)ceilf(enemyY + reach),
+                                          &candidates);
+
+        // The base that is first in the scene is hit, as when every shape was tested in order
+        int hit = -1;
+        Uint32 hitKey = 0;
+        for (int c = 0; c < candidateCount; c++) {
+            int j = getShapeIndex(game->baseHandles[candidates[c]]);
+            if (j == -1 || (hit != -1 && j > hit)) continue;  // Destroyed, or behind the current hit
+            if (collidesWithBase(&shapes[j], enemyX, enemyY, enemyRadius)) {
+                hit = j;
+                hitKey = candidates[c];
             }
-            
-            if (collided) {
-                // Destroy both the enemy and the base
-                deleteShape(j);
-                if (i < game->enemyCount - 1) {
-                    game->enemies[i] = game->enemies[game->enemyCount - 1];
-                }
-                game->enemyCount--;
-                i--;  // Recheck this index since we swapped in a new enemy
-                game->basesRemaining--;
-                if (game->basesRemaining <= 0) {
-                    game->isPlaying = false;
-                    game->won = false;
-                    game->winMessageTimer = 0.0f;
-                    game->gameJustEnded = true;
-                    game->enemyCount = 0;  // Clear all enemies when game ends
-                }
-                break;
+        }
+
+        if (hit != -1) {
+            // Destroy both the enemy and the base
+            removeGridBox(&game->baseGrid, hitKey);
+            deleteShape(hit);
+            if (i < game->enemyCount - 1) {
+                game->enemies[i] = game->enemies[game->enemyCount - 1];
+            }
+            game->enemyCount--;
+            i--;  // Recheck this index since we swapped in a new enemy
+            game->basesRemaining--;
+            if (game->basesRemaining <= 0) {
+                game->isPlaying = false;
+                game->won = false;
+                game->winMessageTimer = 0.0f;
+                game->gameJustEnded = true;
+                game->enemyCount = 0;  // Clear all enemies when game ends
             }
         }
     }
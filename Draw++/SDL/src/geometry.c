@@ -0,0 +1,763 @@
+#include <SDL2/SDL.h>
+#include "../files.h/geometry.h"
+#include "../files.h/formEvents.h"
+#include "../files.h/colors.h"
+#include "../files.h/softRaster.h"
+
+#include <math.h>
+
+// ANSI escape codes for colors
+#define RED_COLOR "-#red "
+
+// Upper bound on the outline points generated for a single shape
+#define GEOMETRY_MAX_POINTS 256
+
+// Points of the outlines the gfx path draws: 36 for an ellipse, 12 sides at most for a polygon
+#define OUTLINE_MAX_POINTS 36
+
+// Growable vertex/index buffer
+typedef struct {
+    SDL_Vertex *vertices;
+    int vertexCount;
+    int vertexCapacity;
+    int *indices;
+    int indexCount;
+    int indexCapacity;
+} GeometryBatch;
+
+// Tessellation of one shape, kept until its geometry changes. The vertices are laid
+// out as [shape | selection highlight | rotation indicator] so that colors can be
+// re-applied per range and the highlight can be skipped without re-tessellating.
+//
+// The gfx path keeps the integer outline of polygonal shapes (and of their highlight)
+// in the same entry. Both parts are invalidated together and rebuilt by their own path.
+typedef struct {
+    GeometryBatch mesh;
+    Uint32 generation;      // Generation of the store slot the cache was built for
+    bool hasMesh;           // Whether the mesh is up to date
+    bool hasSelection;      // Whether the highlight range was tessellated
+    int selectionVertex;    // First vertex of the highlight range
+    int indicatorVertex;    // First vertex of the indicator range
+    int selectionIndex;     // First index of the highlight range
+    int indicatorIndex;     // First index of the indicator range
+    bool hasOutline[2];     // Whether the outline, and the highlight one, are up to date
+    int outlineCount;
+    Sint16 outlineX[2][OUTLINE_MAX_POINTS];
+    Sint16 outlineY[2][OUTLINE_MAX_POINTS];
+} ShapeGeometry;
+
+static GeometryBatch batch = {0};
+static RasterShape *rasterShapes = NULL;       // Triangles of each shape in the batch, for the software path
+static int rasterShapeCount = 0;
+static int rasterShapeCapacity = 0;
+static ShapeGeometry *shapeGeometry = NULL;    // Indexed by store slot
+static ShapeGeometry unstoredGeometry = {0};   // Outlines of shapes drawn from outside the store
+static int shapeGeometryCapacity = 0;
+static RenderPath renderPath = RENDER_GFX;
+static RenderStats renderStats = {0};
+
+/**
+ * @brief Selects the back-end used by renderAllShapes.
+ *
+ * Falls back to the SDL2_gfx path when SDL is too old to provide SDL_RenderGeometry.
+ *
+ * @param path The back-end to use from the next frame on.
+ */
+void setRenderPath(RenderPath path) {
+#if !SDL_VERSION_ATLEAST(2, 0, 18)
+    if (path == RENDER_GEOMETRY) {
+        printf("%sExecutionError: SDL_RenderGeometry requires SDL 2.0.18 or newer, keeping the gfx renderer\n", RED_COLOR);
+        return;
+    }
+#endif
+    renderPath = path;
+}
+
+/**
+ * @brief Returns the back-end currently used by renderAllShapes.
+ */
+RenderPath getRenderPath(void) {
+    return renderPath;
+}
+
+/**
+ * @brief Returns a short printable name for a render path.
+ */
+const char* getRenderPathName(RenderPath path) {
+    switch (path) {
+        case RENDER_GFX:
+            return "gfx";
+        case RENDER_GEOMETRY:
+            return "geometry";
+        case RENDER_SOFTWARE:
+            return "software";
+        default:
+            return "unknown";
+    }
+}
+
+/**
+ * @brief Finds the render path with a given name, see getRenderPathName.
+ *
+ * @param name The name to look up.
+ * @param path Receives the render path.
+ * @return 0 on success, -1 if no render path has that name.
+ */
+int parseRenderPath(const char *name, RenderPath *path) {
+    for (int i = 0; i < RENDER_PATH_COUNT; i++) {
+        if (strcmp(name, getRenderPathName((RenderPath)i)) == 0) {
+            *path = (RenderPath)i;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Stores the counters of the frame that was just drawn.
+ */
+void setRenderStats(RenderStats stats) {
+    renderStats = stats;
+}
+
+/**
+ * @brief Returns the counters of the last frame drawn by renderAllShapes.
+ */
+RenderStats getRenderStats(void) {
+    return renderStats;
+}
+
+/**
+ * @brief Makes room for more vertices and indices in a batch.
+ *
+ * @param out The batch to grow.
+ * @param vertices Number of vertices about to be added.
+ * @param indices Number of indices about to be added.
+ * @return 0 on success, -1 if the memory could not be allocated.
+ */
+static int reserveBatch(GeometryBatch *out, int vertices, int indices) {
+    if (out->vertexCount + vertices > out->vertexCapacity) {
+        int capacity = out->vertexCapacity ? out->vertexCapacity : 64;
+        while (capacity < out->vertexCount + vertices) capacity *= 2;
+        SDL_Vertex *newVertices = realloc(out->vertices, capacity * sizeof(SDL_Vertex));
+        if (!newVertices) return -1;
+        out->vertices = newVertices;
+        out->vertexCapacity = capacity;
+    }
+    if (out->indexCount + indices > out->indexCapacity) {
+        int capacity = out->indexCapacity ? out->indexCapacity : 192;
+        while (capacity < out->indexCount + indices) capacity *= 2;
+        int *newIndices = realloc(out->indices, capacity * sizeof(int));
+        if (!newIndices) return -1;
+        out->indices = newIndices;
+        out->indexCapacity = capacity;
+    }
+    return 0;
+}
+
+/**
+ * @brief Appends a vertex to the batch. Space must have been reserved.
+ *
+ * @return The index of the new vertex.
+ */
+static int pushVertex(GeometryBatch *out, float x, float y, SDL_Color color) {
+    SDL_Vertex *vertex = &out->vertices[out->vertexCount];
+    vertex->position.x = x;
+    vertex->position.y = y;
+    vertex->color = color;
+    vertex->tex_coord.x = 0.0f;
+    vertex->tex_coord.y = 0.0f;
+    return out->vertexCount++;
+}
+
+/**
+ * @brief Appends a triangle made of three existing vertices.
+ */
+static void pushTriangle(GeometryBatch *out, int a, int b, int c) {
+    out->indices[out->indexCount++] = a;
+    out->indices[out->indexCount++] = b;
+    out->indices[out->indexCount++] = c;
+}
+
+/**
+ * @brief Fills a convex outline as a triangle fan around its first point.
+ *
+ * @param points Outline of the shape, in order.
+ * @param count Number of points (at least 3).
+ * @param color Fill color.
+ */
+static void fillConvex(GeometryBatch *out, const SDL_FPoint *points, int count, SDL_Color color) {
+    if (count < 3 || reserveBatch(out, count, (count - 2) * 3) != 0) return;
+
+    int first = pushVertex(out, points[0].x, points[0].y, color);
+    for (int i = 1; i < count; i++) {
+        pushVertex(out, points[i].x, points[i].y, color);
+    }
+    for (int i = 1; i < count - 1; i++) {
+        pushTriangle(out, first, first + i, first + i + 1);
+    }
+}
+
+/**
+ * @brief Fills the area between a center point and an open outline (pie slice).
+ *
+ * @param cx X coordinate of the center.
+ * @param cy Y coordinate of the center.
+ * @param points Outline, in order.
+ * @param count Number of points in the outline.
+ * @param color Fill color.
+ */
+static void fillFan(GeometryBatch *out, float cx, float cy, const SDL_FPoint *points, int count, SDL_Color color) {
+    if (count < 2 || reserveBatch(out, count + 1, (count - 1) * 3) != 0) return;
+
+    int center = pushVertex(out, cx, cy, color);
+    for (int i = 0; i < count; i++) {
+        pushVertex(out, points[i].x, points[i].y, color);
+    }
+    for (int i = 1; i < count; i++) {
+        pushTriangle(out, center, center + i, center + i + 1);
+    }
+}
+
+/**
+ * @brief Draws a segment as a quad of the given width.
+ */
+static void strokeSegment(GeometryBatch *out, SDL_FPoint p0, SDL_FPoint p1, float width, SDL_Color color) {
+    float dx = p1.x - p0.x;
+    float dy = p1.y - p0.y;
+    float length = sqrtf(dx * dx + dy * dy);
+    if (length < 0.0001f || reserveBatch(out, 4, 6) != 0) return;
+
+    // Half-width normal to the segment
+    float nx = -dy / length * width * 0.5f;
+    float ny = dx / length * width * 0.5f;
+
+    int a = pushVertex(out, p0.x + nx, p0.y + ny, color);
+    int b = pushVertex(out, p1.x + nx, p1.y + ny, color);
+    int c = pushVertex(out, p1.x - nx, p1.y - ny, color);
+    int d = pushVertex(out, p0.x - nx, p0.y - ny, color);
+    pushTriangle(out, a, b, c);
+    pushTriangle(out, a, c, d);
+}
+
+/**
+ * @brief Draws an outline as a chain of quads.
+ *
+ * @param points Points of the outline, in order.
+ * @param count Number of points.
+ * @param closed Whether the last point connects back to the first.
+ * @param width Line width in pixels.
+ * @param color Line color.
+ */
+static void strokePath(GeometryBatch *out, const SDL_FPoint *points, int count, bool closed, float width, SDL_Color color) {
+    for (int i = 0; i < count - 1; i++) {
+        strokeSegment(out, points[i], points[i + 1], width, color);
+    }
+    if (closed && count > 2) {
+        strokeSegment(out, points[count - 1], points[0], width, color);
+    }
+}
+
+/**
+ * @brief Fills or outlines a shape depending on its typeForm.
+ */
+static void emitOutline(GeometryBatch *out, const SDL_FPoint *points, int count, bool filled, SDL_Color color) {
+    if (filled) {
+        fillConvex(out, points, count, color);
+    } else {
+        strokePath(out, points, count, true, 1.0f, color);
+    }
+}
+
+/**
+ * @brief Computes the corners of a rotated box, rotating around its center like renderShape.
+ *
+ * @param x Left edge before rotation.
+ * @param y Top edge before rotation.
+ * @param w Width.
+ * @param h Height.
+ * @param rotation Rotation in degrees.
+ * @param enlargement Pixels added on every side (selection highlight).
+ * @param out Receives the 4 corners.
+ */
+static void boxPoints(int x, int y, int w, int h, double rotation, int enlargement, SDL_FPoint *out) {
+    int cx = x + w / 2;
+    int cy = y + h / 2;
+    double angle = rotation * M_PI / 180.0;
+    double c = cos(angle);
+    double s = sin(angle);
+    double xs[4] = {x - enlargement, x + w + enlargement, x + w + enlargement, x - enlargement};
+    double ys[4] = {y - enlargement, y - enlargement, y + h + enlargement, y + h + enlargement};
+
+    for (int i = 0; i < 4; i++) {
+        out[i].x = (float)(c * (xs[i] - cx) - s * (ys[i] - cy) + cx);
+        out[i].y = (float)(s * (xs[i] - cx) + c * (ys[i] - cy) + cy);
+    }
+}
+
+/**
+ * @brief Computes the points of a rotated ellipse.
+ *
+ * @return The number of points written to `out`.
+ */
+static int ellipsePoints(int cx, int cy, int rx, int ry, double rotation, SDL_FPoint *out) {
+    int count = 36;
+    double angle = rotation * M_PI / 180.0;
+    double c = cos(angle);
+    double s = sin(angle);
+
+    for (int i = 0; i < count; i++) {
+        double theta = (2 * M_PI * i) / count;
+        double dx = rx * cos(theta);
+        double dy = ry * sin(theta);
+        out[i].x = (float)(c * dx - s * dy + cx);
+        out[i].y = (float)(s * dx + c * dy + cy);
+    }
+    return count;
+}
+
+/**
+ * @brief Computes the vertices of a regular polygon.
+ *
+ * @param offset Angle of the first vertex, in radians.
+ * @return The number of points written to `out`.
+ */
+static int regularPoints(int cx, int cy, int radius, int sides, double offset, SDL_FPoint *out) {
+    if (sides > GEOMETRY_MAX_POINTS) sides = GEOMETRY_MAX_POINTS;
+    double step = 2 * M_PI / sides;
+
+    for (int i = 0; i < sides; i++) {
+        double angle = i * step + offset;
+        out[i].x = (float)(cx + cos(angle) * radius);
+        out[i].y = (float)(cy + sin(angle) * radius);
+    }
+    return sides;
+}
+
+/**
+ * @brief Picks a segment count for a circle so that edges stay a few pixels long.
+ */
+static int circleSegments(int radius) {
+    int segments = 12 + radius / 2;
+    return segments > GEOMETRY_MAX_POINTS ? GEOMETRY_MAX_POINTS : segments;
+}
+
+/**
+ * @brief Computes the points along an arc, going clockwise on screen like arcRGBA.
+ *
+ * @param start Start angle in degrees, in [0, 360).
+ * @param end End angle in degrees, in [0, 360).
+ * @return The number of points written to `out`.
+ */
+static int arcPoints(int cx, int cy, int radius, int start, int end, SDL_FPoint *out) {
+    if (end <= start) end += 360;
+
+    int count = (circleSegments(radius) * (end - start)) / 360 + 2;
+    if (count > GEOMETRY_MAX_POINTS) count = GEOMETRY_MAX_POINTS;
+
+    for (int i = 0; i < count; i++) {
+        double angle = (start + (end - start) * (double)i / (count - 1)) * M_PI / 180.0;
+        out[i].x = (float)(cx + cos(angle) * radius);
+        out[i].y = (float)(cy + sin(angle) * radius);
+    }
+    return count;
+}
+
+/**
+ * @brief Tessellates the outline of a shape, or its selection highlight.
+ *
+ * Mirrors what renderShape draws with SDL2_gfx, so both paths give the same picture.
+ * Colors are placeholders: they are applied per range when the cache is submitted.
+ *
+ * @param out The mesh to append to.
+ * @param shape The shape to tessellate.
+ * @param enlargement 0 for the shape itself, 5 for its selection highlight.
+ */
+static void tessellateOutline(GeometryBatch *out, Shape *shape, int enlargement) {
+    bool filled = shape->typeForm == FORM_FILLED;
+    SDL_Color color = shape->color;
+    SDL_FPoint points[GEOMETRY_MAX_POINTS];
+    int count;
+
+    switch (shape->type) {
+        case SHAPE_CIRCLE: {
+            int segments = circleSegments(shape->data.circle.radius);
+            count = regularPoints(shape->data.circle.x, shape->data.circle.y, shape->data.circle.radius + enlargement,
+                                  segments, 0.0, points);
+            emitOutline(out, points, count, filled, color);
+            break;
+        }
+
+        case SHAPE_RECTANGLE:
+            boxPoints(shape->data.rectangle.x, shape->data.rectangle.y, shape->data.rectangle.width, shape->data.rectangle.height,
+                      shape->rotation, enlargement, points);
+            emitOutline(out, points, 4, filled, color);
+            break;
+
+        case SHAPE_SQUARE:
+            boxPoints(shape->data.square.x, shape->data.square.y, shape->data.square.c, shape->data.square.c,
+                      shape->rotation, enlargement, points);
+            emitOutline(out, points, 4, filled, color);
+            break;
+
+        case SHAPE_ELLIPSE:
+            count = ellipsePoints(shape->data.ellipse.x, shape->data.ellipse.y,
+                                  shape->data.ellipse.rx + enlargement, shape->data.ellipse.ry + enlargement,
+                                  shape->rotation, points);
+            emitOutline(out, points, count, filled, color);
+            break;
+
+        case SHAPE_LINE: {
+            int x1 = shape->data.line.x1;
+            int y1 = shape->data.line.y1;
+            int x2 = shape->data.line.x2;
+            int y2 = shape->data.line.y2;
+
+            if (shape->rotation != 0) {
+                // Rotate both ends around the middle of the line
+                int cx = (x1 + x2) / 2;
+                int cy = (y1 + y2) / 2;
+                double angle = shape->rotation * M_PI / 180.0;
+                double c = cos(angle);
+                double s = sin(angle);
+
+                int rx1 = cx + (int)((x1 - cx) * c - (y1 - cy) * s);
+                int ry1 = cy + (int)((x1 - cx) * s + (y1 - cy) * c);
+                int rx2 = cx + (int)((x2 - cx) * c - (y2 - cy) * s);
+                int ry2 = cy + (int)((x2 - cx) * s + (y2 - cy) * c);
+                x1 = rx1;
+                y1 = ry1;
+                x2 = rx2;
+                y2 = ry2;
+            }
+
+            // The highlight is a line 4 pixels thicker drawn over the original one
+            float width = enlargement ? shape->data.line.thickness + 4 :
+                          (shape->data.line.thickness > 1 ? shape->data.line.thickness : 1.0f);
+            strokeSegment(out, (SDL_FPoint){(float)x1, (float)y1}, (SDL_FPoint){(float)x2, (float)y2}, width, color);
+            break;
+        }
+
+        case SHAPE_POLYGON:
+            if (shape->data.polygon.sides < 3) return;
+            count = regularPoints(shape->data.polygon.cx, shape->data.polygon.cy, shape->data.polygon.radius + enlargement,
+                                  shape->data.polygon.sides, shape->rotation * M_PI / 180.0, points);
+            emitOutline(out, points, count, filled, color);
+            break;
+
+        case SHAPE_TRIANGLE:
+            // Triangles point up: first vertex at 30 degrees like renderShape
+            count = regularPoints(shape->data.triangle.cx, shape->data.triangle.cy, shape->data.triangle.radius + enlargement,
+                                  3, (shape->rotation + 30) * M_PI / 180.0, points);
+            emitOutline(out, points, count, filled, color);
+            break;
+
+        case SHAPE_ARC: {
+            int startAngle = shape->data.arc.start_angle % 360;
+            int endAngle = shape->data.arc.end_angle % 360;
+            if (startAngle < 0) startAngle += 360;
+            if (endAngle < 0) endAngle += 360;
+            startAngle = (startAngle + (int)shape->rotation) % 360;
+            endAngle = (endAngle + (int)shape->rotation) % 360;
+
+            count = arcPoints(shape->data.arc.x, shape->data.arc.y, shape->data.arc.radius + enlargement, startAngle, endAngle, points);
+            if (filled) {
+                fillFan(out, shape->data.arc.x, shape->data.arc.y, points, count, color);
+            } else {
+                strokePath(out, points, count, false, 1.0f, color);
+            }
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Rebuilds the cached mesh of a shape.
+ *
+ * @param cache The cache entry to fill.
+ * @param shape The shape to tessellate.
+ */
+static void tessellateShape(ShapeGeometry *cache, Shape *shape) {
+    GeometryBatch *mesh = &cache->mesh;
+    mesh->vertexCount = 0;
+    mesh->indexCount = 0;
+
+    // Same side effect as renderShape: empty lines are always 1 pixel thick
+    if (shape->type == SHAPE_LINE && shape->typeForm == FORM_EMPTY) {
+        shape->data.line.thickness = 1;
+    }
+
+    tessellateOutline(mesh, shape, 0);
+
+    // The highlight is only built once the shape gets selected
+    cache->selectionVertex = mesh->vertexCount;
+    cache->selectionIndex = mesh->indexCount;
+    cache->hasSelection = shape->selected;
+    if (shape->selected) {
+        tessellateOutline(mesh, shape, 5);
+    }
+
+    cache->indicatorVertex = mesh->vertexCount;
+    cache->indicatorIndex = mesh->indexCount;
+    if (shape->type == SHAPE_CIRCLE) {
+        // Indicator line for rotation
+        double angle = shape->rotation * M_PI / 180.0;
+        SDL_FPoint center = {(float)shape->data.circle.x, (float)shape->data.circle.y};
+        SDL_FPoint end = {(float)(int)(shape->data.circle.x + cos(angle) * shape->data.circle.radius),
+                          (float)(int)(shape->data.circle.y + sin(angle) * shape->data.circle.radius)};
+        strokeSegment(mesh, center, end, 1.0f, blue);
+    }
+
+    cache->hasMesh = true;
+}
+
+/**
+ * @brief Returns the cache entry of a store slot, growing the table if needed.
+ *
+ * @param slot The store slot of the shape.
+ * @return The entry, or NULL if the table could not grow.
+ */
+static ShapeGeometry* getShapeGeometry(Uint32 slot) {
+    if ((int)slot >= shapeGeometryCapacity) {
+        int capacity = shapeGeometryCapacity ? shapeGeometryCapacity : 64;
+        while (capacity <= (int)slot) capacity *= 2;
+        ShapeGeometry *newCache = realloc(shapeGeometry, capacity * sizeof(ShapeGeometry));
+        if (!newCache) return NULL;
+        memset(newCache + shapeGeometryCapacity, 0, (capacity - shapeGeometryCapacity) * sizeof(ShapeGeometry));
+        shapeGeometry = newCache;
+        shapeGeometryCapacity = capacity;
+    }
+    return &shapeGeometry[slot];
+}
+
+/**
+ * @brief Returns the cache entry of a shape, invalidated if its geometry changed.
+ *
+ * @param shape The shape, stored in the shapes array.
+ * @return The entry, or NULL if the table could not grow.
+ */
+static ShapeGeometry* getValidShapeGeometry(Shape *shape) {
+    ShapeHandle handle = getShapeHandle((int)(shape - shapes));
+    ShapeGeometry *cache = getShapeGeometry(handle.slot);
+    if (!cache) {
+        printf("%sExecutionError: Failed to allocate memory for the geometry cache\n", RED_COLOR);
+        return NULL;
+    }
+
+    if (shape->geometryDirty || cache->generation != handle.generation) {
+        cache->hasMesh = false;
+        cache->hasOutline[0] = cache->hasOutline[1] = false;
+        cache->generation = handle.generation;
+        shape->geometryDirty = false;
+    }
+    return cache;
+}
+
+/**
+ * @brief Returns the outline of a polygonal shape as the gfx path draws it.
+ *
+ * The points are computed once and kept until the shape's geometry changes, so
+ * static scenes do not redo the trigonometry every frame.
+ *
+ * @param shape A rectangle, square, ellipse, polygon or triangle.
+ * @param selection false for the shape itself, true for its selection highlight.
+ * @param outline Receives the points, valid until the next call.
+ * @return 0 on success, -1 for other shapes or if the cache could not grow.
+ */
+int getShapeOutline(Shape *shape, bool selection, ShapeOutline *outline) {
+    if (shape->type != SHAPE_RECTANGLE && shape->type != SHAPE_SQUARE && shape->type != SHAPE_ELLIPSE &&
+        shape->type != SHAPE_POLYGON && shape->type != SHAPE_TRIANGLE) {
+        return -1;
+    }
+    if (shape->type == SHAPE_POLYGON && (shape->data.polygon.sides < 3 || shape->data.polygon.sides > OUTLINE_MAX_POINTS)) {
+        return -1;
+    }
+
+    ShapeGeometry *cache = &unstoredGeometry;
+    if (shape >= shapes && shape < shapes + shapeCount) {
+        cache = getValidShapeGeometry(shape);
+        if (!cache) return -1;
+    } else {
+        // Not in the store (e.g. game enemies), there is no slot to keep it for
+        cache->hasOutline[0] = cache->hasOutline[1] = false;
+    }
+
+    if (!cache->hasOutline[selection]) {
+        int enlargement = selection ? 5 : 0;
+        SDL_FPoint points[OUTLINE_MAX_POINTS];
+        int count = 4;
+
+        switch (shape->type) {
+            case SHAPE_RECTANGLE:
+                boxPoints(shape->data.rectangle.x, shape->data.rectangle.y, shape->data.rectangle.width, shape->data.rectangle.height,
+                          shape->rotation, enlargement, points);
+                break;
+            case SHAPE_SQUARE:
+                boxPoints(shape->data.square.x, shape->data.square.y, shape->data.square.c, shape->data.square.c,
+                          shape->rotation, enlargement, points);
+                break;
+            case SHAPE_ELLIPSE:
+                count = ellipsePoints(shape->data.ellipse.x, shape->data.ellipse.y,
+                                      shape->data.ellipse.rx + enlargement, shape->data.ellipse.ry + enlargement,
+                                      shape->rotation, points);
+                break;
+            case SHAPE_POLYGON:
+                count = regularPoints(shape->data.polygon.cx, shape->data.polygon.cy, shape->data.polygon.radius + enlargement,
+                                      shape->data.polygon.sides, shape->rotation * M_PI / 180.0, points);
+                break;
+            default:
+                // Triangles point up: first vertex at 30 degrees
+                count = regularPoints(shape->data.triangle.cx, shape->data.triangle.cy, shape->data.triangle.radius + enlargement,
+                                      3, (shape->rotation + 30) * M_PI / 180.0, points);
+                break;
+        }
+
+        for (int i = 0; i < count; i++) {
+            cache->outlineX[selection][i] = (Sint16)points[i].x;
+            cache->outlineY[selection][i] = (Sint16)points[i].y;
+        }
+        cache->outlineCount = count;
+        cache->hasOutline[selection] = true;
+    }
+
+    outline->x = cache->outlineX[selection];
+    outline->y = cache->outlineY[selection];
+    outline->count = cache->outlineCount;
+    return 0;
+}
+
+/**
+ * @brief Copies a range of a cached mesh into the frame batch.
+ *
+ * @param cache The cached mesh.
+ * @param firstVertex First vertex of the range.
+ * @param lastVertex One past the last vertex of the range.
+ * @param firstIndex First index of the range.
+ * @param lastIndex One past the last index of the range.
+ * @param color Color applied to every vertex of the range.
+ */
+static void appendRange(const ShapeGeometry *cache, int firstVertex, int lastVertex,
+                        int firstIndex, int lastIndex, SDL_Color color) {
+    int vertices = lastVertex - firstVertex;
+    int indices = lastIndex - firstIndex;
+    if (indices <= 0 || reserveBatch(&batch, vertices, indices) != 0) return;
+
+    int offset = batch.vertexCount - firstVertex;
+    for (int i = firstVertex; i < lastVertex; i++) {
+        SDL_Vertex *vertex = &batch.vertices[batch.vertexCount++];
+        *vertex = cache->mesh.vertices[i];
+        vertex->color = color;
+    }
+    for (int i = firstIndex; i < lastIndex; i++) {
+        batch.indices[batch.indexCount++] = cache->mesh.indices[i] + offset;
+    }
+}
+
+/**
+ * @brief Records the range of the batch holding the triangles of one shape.
+ *
+ * @return 0 on success, -1 if the list could not grow.
+ */
+static int pushRasterShape(int firstIndex, int lastIndex) {
+    if (rasterShapeCount == rasterShapeCapacity) {
+        int capacity = rasterShapeCapacity ? rasterShapeCapacity * 2 : 64;
+        RasterShape *newShapes = realloc(rasterShapes, capacity * sizeof(RasterShape));
+        if (!newShapes) return -1;
+        rasterShapes = newShapes;
+        rasterShapeCapacity = capacity;
+    }
+    rasterShapes[rasterShapeCount++] = (RasterShape){firstIndex, lastIndex};
+    return 0;
+}
+
+/**
+ * @brief Draws a range of shapes in z-order with a single SDL_RenderGeometry submission.
+ *
+ * Each shape keeps its tessellation between frames and is only re-tessellated when
+ * its geometry is marked dirty, its slot is reused, or it gets selected. Colors are
+ * applied while copying, so color animations do not invalidate the cache either.
+ * On the software path the same triangles are handed to rasterizeShapes instead.
+ *
+ * @param renderer The SDL renderer to draw with.
+ * @param area Only the shapes overlapping this area are drawn, NULL for all of them.
+ * @param first Position of the first shape in the draw order.
+ * @param last Position one past the last shape.
+ */
+void renderShapesGeometry(SDL_Renderer *renderer, const SDL_Rect *area, int first, int last) {
+    batch.vertexCount = 0;
+    batch.indexCount = 0;
+    rasterShapeCount = 0;
+    bool software = getRenderPath() == RENDER_SOFTWARE;
+    int rebuilt = 0;
+
+    for (int i = first; i < last; i++) {
+        Shape *shape = getShapeInDrawOrder(i);
+        if (shape->typeForm != FORM_FILLED && shape->typeForm != FORM_EMPTY) {
+            continue; // Skip rendering if the typeForm is invalid.
+        }
+
+        SDL_Rect bounds;
+        if (area && (!getShapeDrawBounds(shape, &bounds) || !SDL_HasIntersection(&bounds, area))) {
+            continue; // Outside the area being redrawn
+        }
+
+        ShapeGeometry *cache = getValidShapeGeometry(shape);
+        if (!cache) return;
+
+        if (!cache->hasMesh || (shape->selected && !cache->hasSelection)) {
+            tessellateShape(cache, shape);
+            rebuilt++;
+        }
+
+        int firstIndex = batch.indexCount;
+        appendRange(cache, 0, cache->selectionVertex, 0, cache->selectionIndex, shape->color);
+        if (shape->selected) {
+            appendRange(cache, cache->selectionVertex, cache->indicatorVertex,
+                        cache->selectionIndex, cache->indicatorIndex, selectColor(shape->color));
+        }
+        appendRange(cache, cache->indicatorVertex, cache->mesh.vertexCount,
+                    cache->indicatorIndex, cache->mesh.indexCount, blue);
+
+        if (software && pushRasterShape(firstIndex, batch.indexCount) != 0) {
+            printf("%sExecutionError: Failed to allocate memory for the software rasterizer\n", RED_COLOR);
+            return;
+        }
+    }
+
+    RenderStats stats = {0, 0, batch.vertexCount, batch.indexCount / 3, rebuilt};
+    if (batch.indexCount > 0 && software) {
+        rasterizeShapes(renderer, area, batch.vertices, batch.indices, rasterShapes, rasterShapeCount);
+        stats.drawCalls = 1;
+    } else if (batch.indexCount > 0) {
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+        if (SDL_RenderGeometry(renderer, NULL, batch.vertices, batch.vertexCount, batch.indices, batch.indexCount) != 0) {
+            printf("%sExecutionError: Failed to render shape geometry: %s\n", RED_COLOR, SDL_GetError());
+        }
+        stats.drawCalls = 1;
+#else
+        (void)renderer;
+#endif
+    }
+    setRenderStats(stats);
+}
+
+/**
+ * @brief Releases the buffers used by the geometry renderer.
+ */
+void freeGeometry(void) {
+    for (int i = 0; i < shapeGeometryCapacity; i++) {
+        free(shapeGeometry[i].mesh.vertices);
+        free(shapeGeometry[i].mesh.indices);
+    }
+    free(shapeGeometry);
+    shapeGeometry = NULL;
+    shapeGeometryCapacity = 0;
+
+    free(batch.vertices);
+    free(batch.indices);
+    batch = (GeometryBatch){0};
+
+    free(rasterShapes);
+    rasterShapes = NULL;
+    rasterShapeCount = rasterShapeCapacity = 0;
+}
@@ -0,0 +1,168 @@
+#include <SDL2/SDL.h>
+#include "../files.h/headless.h"
+#include "../files.h/formEvents.h"
+#include "../files.h/animations.h"
+#include "../files.h/geometry.h"
+#include "../files.h/softRaster.h"
+#include "../files.h/spanFill.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ANSI escape codes for colors
+#define RED_COLOR "-#red "
+
+HeadlessConfig headless = {false, HEADLESS_DEFAULT_FRAMES, "headless.bmp", "headless_timings.csv"};
+
+static SDL_Surface *framebuffer = NULL;     // Render target of the software renderer
+
+/**
+ * @brief Reads the headless options from the program arguments.
+ *
+ * Recognized options: --headless, --frames N, --seconds S (converted to frames at
+ * HEADLESS_FPS), --output FILE, --timings FILE and --render gfx|geometry|software
+ * (also applies to windowed runs). Unknown arguments are ignored.
+ * Selects SDL's dummy video driver when --headless is given, so it must be called
+ * before SDL_Init.
+ *
+ * @return 0 on success, -1 if an option is missing its value or the value is invalid.
+ */
+int parseHeadlessArgs(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (strcmp(arg, "--headless") == 0) {
+            headless.enabled = true;
+        } else if (strcmp(arg, "--frames") == 0 || strcmp(arg, "--seconds") == 0 ||
+                   strcmp(arg, "--output") == 0 || strcmp(arg, "--timings") == 0 ||
+                   strcmp(arg, "--render") == 0) {
+            if (!hasValue) {
+                printf("%sExecutionError: Missing value for %s\n", RED_COLOR, arg);
+                return -1;
+            }
+            const char *value = argv[++i];
+
+            if (strcmp(arg, "--render") == 0) {
+                RenderPath path;
+                if (parseRenderPath(value, &path) != 0) {
+                    printf("%sExecutionError: Unknown renderer \"%s\" (gfx, geometry or software)\n", RED_COLOR, value);
+                    return -1;
+                }
+                setRenderPath(path);
+            } else if (strcmp(arg, "--output") == 0) {
+                headless.imagePath = value;
+            } else if (strcmp(arg, "--timings") == 0) {
+                headless.timingsPath = value;
+            } else {
+                headless.frames = (strcmp(arg, "--frames") == 0) ? atoi(value)
+                                                                 : (int)(atof(value) * HEADLESS_FPS + 0.5);
+                if (headless.frames <= 0) {
+                    printf("%sExecutionError: Invalid value for %s: \"%s\"\n", RED_COLOR, arg, value);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    if (headless.enabled) {
+        SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+    }
+    return 0;
+}
+
+/**
+ * @brief Creates a software renderer drawing into an in-memory framebuffer.
+ *
+ * @param width Framebuffer width in pixels.
+ * @param height Framebuffer height in pixels.
+ * @param renderer Receives the renderer.
+ * @return 0 on success, -1 on failure.
+ */
+int createHeadlessRenderer(int width, int height, SDL_Renderer **renderer) {
+    framebuffer = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!framebuffer) {
+        printf("%sExecutionError: Failed to create offscreen framebuffer: %s\n", RED_COLOR, SDL_GetError());
+        return -1;
+    }
+
+    *renderer = SDL_CreateSoftwareRenderer(framebuffer);
+    if (!*renderer) {
+        printf("%sExecutionError: Failed to create software renderer: %s\n", RED_COLOR, SDL_GetError());
+        SDL_FreeSurface(framebuffer);
+        framebuffer = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Runs the scene for a fixed number of frames without a window, then writes
+ *        the final framebuffer and the per-frame timings to disk.
+ *
+ * Each frame mirrors the drawing and animation steps of mainLoop, without input
+ * handling, HUD, or frame rate cap. Animations advance by 1 / HEADLESS_FPS per frame.
+ *
+ * @param renderer Renderer created by createHeadlessRenderer.
+ * @return 0 on success, -1 if an output file could not be written.
+ */
+int runHeadless(SDL_Renderer *renderer, int bgcolorR, int bgcolorG, int bgcolorB) {
+    double *frameMs = malloc(headless.frames * sizeof(double));
+    if (!frameMs) {
+        printf("%sExecutionError: Memory allocation failed for frame timings\n", RED_COLOR);
+        return -1;
+    }
+
+    int width, height;
+    SDL_GetRendererOutputSize(renderer, &width, &height);
+    double frequency = (double)SDL_GetPerformanceFrequency();
+    double totalMs = 0;
+
+    for (int frame = 0; frame < headless.frames; frame++) {
+        Uint64 start = SDL_GetPerformanceCounter();
+
+        SDL_SetRenderDrawColor(renderer, bgcolorR, bgcolorG, bgcolorB, 255);
+        SDL_RenderClear(renderer);
+        renderAllShapes(renderer);
+        updateAnimationLanes(width, height, 1.0f / HEADLESS_FPS);
+        SDL_RenderPresent(renderer);
+
+        frameMs[frame] = (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+        totalMs += frameMs[frame];
+    }
+
+    int result = 0;
+    if (SDL_SaveBMP(framebuffer, headless.imagePath) != 0) {
+        printf("%sExecutionError: Failed to write %s: %s\n", RED_COLOR, headless.imagePath, SDL_GetError());
+        result = -1;
+    }
+
+    FILE *timings = fopen(headless.timingsPath, "w");
+    if (timings) {
+        fprintf(timings, "frame,ms\n");
+        for (int frame = 0; frame < headless.frames; frame++) {
+            fprintf(timings, "%d,%.3f\n", frame, frameMs[frame]);
+        }
+        fclose(timings);
+    } else {
+        printf("%sExecutionError: Failed to write %s\n", RED_COLOR, headless.timingsPath);
+        result = -1;
+    }
+
+    printf("Headless: %d frames, %d shapes, %.3f ms/frame -> %s, %s\n",
+           headless.frames, shapeCount, totalMs / headless.frames, headless.imagePath, headless.timingsPath);
+
+    free(frameMs);
+    freeSoftRaster();
+    freeSpanFill();
+    return result;
+}
+
+/**
+ * @brief Releases the offscreen framebuffer. Call after the renderer is destroyed.
+ */
+void freeHeadless(void) {
+    if (framebuffer) SDL_FreeSurface(framebuffer);
+    framebuffer = NULL;
+}
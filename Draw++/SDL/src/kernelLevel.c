@@ -0,0 +1,46 @@
+#include "../files.h/kernelLevel.h"
+
+/**
+ * @brief Returns the fastest kernel level the CPU running the program supports.
+ */
+KernelLevel getSupportedKernelLevel(void) {
+#ifdef KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return KERNEL_AVX2;
+    if (__builtin_cpu_supports("sse2")) return KERNEL_SSE2;
+#endif
+    return KERNEL_SCALAR;
+}
+
+const char* getKernelLevelName(KernelLevel level) {
+    switch (level) {
+        case KERNEL_SSE2: return "SSE2";
+        case KERNEL_AVX2: return "AVX2";
+        default: return "scalar";
+    }
+}
+
+/**
+ * @brief Selects the level used by a family of kernels.
+ *
+ * The level is lowered to the fastest one supported by the CPU, so asking for
+ * KERNEL_AVX2 picks the best available kernels.
+ *
+ * @param selection The selection of the kernel family.
+ * @param level The requested instruction set.
+ * @return The level actually selected.
+ */
+KernelLevel selectKernelLevel(KernelSelection *selection, KernelLevel level) {
+    KernelLevel supported = getSupportedKernelLevel();
+    selection->level = (level > supported) ? supported : level;
+    selection->selected = true;
+    return selection->level;
+}
+
+/**
+ * @brief Returns the level of a family of kernels, selecting the fastest one on first use.
+ */
+KernelLevel getSelectedKernelLevel(KernelSelection *selection) {
+    if (!selection->selected) selectKernelLevel(selection, KERNEL_AVX2);
+    return selection->level;
+}
@@ -0,0 +1,349 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dlfcn.h>
+#include <sys/stat.h>
+#include "../files.h/sceneHost.h"
+
+// ANSI escape codes for colors
+#define RED_COLOR "-#red "
+
+#define FNV_OFFSET 2166136261u
+#define FNV_PRIME 16777619u
+
+// A definition of the previous load, sorted by hash to find the matches of the next one
+typedef struct {
+    Uint32 hash;
+    int index;
+} SceneMatch;
+
+/**
+ * @brief Describes what drawShape created for a shape, see SceneDefinition.
+ *
+ * Only the values given to drawShape are kept, so a shape that was moved, animated
+ * or selected since it was drawn still has the definition it was drawn with.
+ */
+static void getDefinition(const Shape *shape, SceneDefinition *definition) {
+    int *values = definition->values;
+    memset(definition, 0, sizeof(*definition));
+
+    values[0] = shape->type;
+    values[1] = shape->typeForm == FORM_FILLED;
+    values[2] = (int)(((Uint32)shape->color.r << 24) | ((Uint32)shape->color.g << 16) |
+                      ((Uint32)shape->color.b << 8) | shape->color.a);
+
+    switch (shape->type) {
+        case SHAPE_CIRCLE:
+            values[3] = shape->data.circle.x;
+            values[4] = shape->data.circle.y;
+            values[5] = shape->data.circle.radius;
+            break;
+        case SHAPE_ELLIPSE:
+            values[3] = shape->data.ellipse.x;
+            values[4] = shape->data.ellipse.y;
+            values[5] = shape->data.ellipse.rx;
+            values[6] = shape->data.ellipse.ry;
+            break;
+        case SHAPE_ARC:
+            values[3] = shape->data.arc.x;
+            values[4] = shape->data.arc.y;
+            values[5] = shape->data.arc.radius;
+            values[6] = shape->data.arc.start_angle;
+            values[7] = shape->data.arc.end_angle;
+            break;
+        case SHAPE_RECTANGLE:
+            values[3] = shape->data.rectangle.x;
+            values[4] = shape->data.rectangle.y;
+            values[5] = shape->data.rectangle.width;
+            values[6] = shape->data.rectangle.height;
+            break;
+        case SHAPE_POLYGON:
+            values[3] = shape->data.polygon.cx;
+            values[4] = shape->data.polygon.cy;
+            values[5] = shape->data.polygon.radius;
+            values[6] = shape->data.polygon.sides;
+            break;
+        case SHAPE_TRIANGLE:
+            values[3] = shape->data.triangle.cx;
+            values[4] = shape->data.triangle.cy;
+            values[5] = shape->data.triangle.radius;
+            break;
+        case SHAPE_SQUARE:
+            values[3] = shape->data.square.x;
+            values[4] = shape->data.square.y;
+            values[5] = shape->data.square.c;
+            break;
+        case SHAPE_LINE:
+            values[3] = shape->data.line.x1;
+            values[4] = shape->data.line.y1;
+            values[5] = shape->data.line.x2;
+            values[6] = shape->data.line.y2;
+            values[7] = shape->data.line.thickness;
+            break;
+    }
+
+    // 32-bit FNV-1a of the values
+    Uint32 hash = FNV_OFFSET;
+    const Uint8 *bytes = (const Uint8 *)values;
+    for (size_t i = 0; i < sizeof(definition->values); i++) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    definition->hash = hash;
+}
+
+/**
+ * @brief Compares two matches by hash, then by drawing order, for qsort.
+ */
+static int compareMatches(const void *a, const void *b) {
+    const SceneMatch *first = a;
+    const SceneMatch *second = b;
+    if (first->hash != second->hash) return first->hash < second->hash ? -1 : 1;
+    return (first->index > second->index) - (first->index < second->index);
+}
+
+/**
+ * @brief Reads what identifies a build of the module file.
+ *
+ * Builds replace the file, so its inode changes even within the same second.
+ *
+ * @return 0 on success, -1 if the file does not exist (e.g. while it is replaced).
+ */
+static int readFileId(const char *path, Uint64 *id, Sint64 *time, Sint64 *size) {
+    struct stat info;
+    if (stat(path, &info) != 0) return -1;
+    *id = ((Uint64)info.st_dev << 32) ^ (Uint64)info.st_ino;
+    *time = (Sint64)info.st_mtime;
+    *size = (Sint64)info.st_size;
+    return 0;
+}
+
+/**
+ * @brief Opens the scene module and reads its configuration.
+ *
+ * @param host The host, for the module path.
+ * @param config Filled with the exported configuration, its scene function is only
+ *               valid until the returned library is closed.
+ * @param title Receives a copy of the title, config->title points to it.
+ * @param titleSize Size of the title buffer.
+ * @return The library to close with dlclose, or NULL on error.
+ */
+static void* openModule(const SceneHost *host, SceneModule *config, char *title, size_t titleSize) {
+    void *library = dlopen(host->path, RTLD_NOW | RTLD_LOCAL);
+    if (!library) {
+        printf("%sExecutionError: Failed to load scene module %s: %s\n", RED_COLOR, host->path, dlerror());
+        return NULL;
+    }
+
+    const SceneModule *exported = dlsym(library, SCENE_MODULE_SYMBOL);
+    if (!exported || !exported->scene || exported->windowW <= 0 || exported->windowH <= 0) {
+        printf("%sExecutionError: %s is not a scene module.\n", RED_COLOR, host->path);
+        dlclose(library);
+        return NULL;
+    }
+    *config = *exported;
+    snprintf(title, titleSize, "%s", exported->title ? exported->title : "");
+    config->title = title;
+    return library;
+}
+
+/**
+ * @brief Keeps the configuration of a loaded module once it is closed.
+ */
+static void storeConfig(SceneHost *host, const SceneModule *config) {
+    host->config = *config;
+    snprintf(host->titleBuffer, sizeof(host->titleBuffer), "%s", config->title);
+    host->config.title = host->titleBuffer;
+    host->config.scene = NULL;
+}
+
+/**
+ * @brief Reads the window configuration of the scene module without running it.
+ *
+ * @param host The host, with its module path set.
+ * @return 0 on success, -1 if the module cannot be loaded.
+ */
+int loadSceneConfig(SceneHost *host) {
+    SceneModule config;
+    char title[sizeof(host->titleBuffer)];
+    void *library = openModule(host, &config, title, sizeof(title));
+    if (!library) return -1;
+    storeConfig(host, &config);
+    dlclose(library);
+    return 0;
+}
+
+/**
+ * @brief Matches the shapes a load just drew against the ones of the previous load.
+ *
+ * A new shape with the same definition as a previous one that is still in the store
+ * is dropped in favour of the previous one, which keeps its position, animations,
+ * selection and slot, so the damage tracker does not redraw it. Previous shapes that
+ * were not drawn again are deleted along with the dropped ones, in one batch. The
+ * kept and new shapes are then stacked in the order the load drew them, so an edited
+ * shape does not end up over unchanged ones.
+ *
+ * @param host The host holding the definitions of the previous load.
+ * @param first Index in the store of the first shape of the new load.
+ * @param report Prints how many shapes were kept, added and removed.
+ * @return 0 on success, -1 if out of memory (the new shapes are deleted).
+ */
+static int matchScene(SceneHost *host, int first, bool report) {
+    int count = shapeCount - first;
+    SceneDefinition *definitions = malloc((count > 0 ? count : 1) * sizeof(SceneDefinition));
+    ShapeHandle *handles = malloc((count > 0 ? count : 1) * sizeof(ShapeHandle));
+    SceneMatch *previous = malloc((host->count > 0 ? host->count : 1) * sizeof(SceneMatch));
+    bool *used = calloc(host->count > 0 ? host->count : 1, sizeof(bool));
+    ShapeHandle *dropped = malloc((count + host->count > 0 ? count + host->count : 1) * sizeof(ShapeHandle));
+    if (!definitions || !handles || !previous || !used || !dropped) {
+        printf("%sExecutionError: Failed to allocate memory for the scene.\n", RED_COLOR);
+        free(definitions);
+        free(handles);
+        free(previous);
+        free(used);
+        free(dropped);
+        while (shapeCount > first) deleteShape(shapeCount - 1);
+        return -1;
+    }
+
+    // Read the new shapes before deleting any, deletions move them in the store
+    for (int i = 0; i < count; i++) {
+        getDefinition(&shapes[first + i], &definitions[i]);
+        handles[i] = getShapeHandle(first + i);
+    }
+
+    for (int j = 0; j < host->count; j++) {
+        previous[j] = (SceneMatch){host->definitions[j].hash, j};
+    }
+    qsort(previous, host->count, sizeof(SceneMatch), compareMatches);
+
+    int kept = 0;
+    for (int i = 0; i < count; i++) {
+        // First previous definition with the same hash
+        int low = 0, high = host->count;
+        while (low < high) {
+            int middle = (low + high) / 2;
+            if (previous[middle].hash < definitions[i].hash) low = middle + 1;
+            else high = middle;
+        }
+
+        for (int k = low; k < host->count && previous[k].hash == definitions[i].hash; k++) {
+            int j = previous[k].index;
+            if (used[j] || memcmp(host->definitions[j].values, definitions[i].values, sizeof(definitions[i].values)) != 0) continue;
+            if (getShapeIndex(host->handles[j]) == -1) continue;  // Deleted in the window, draw it again
+
+            used[j] = true;
+            dropped[kept++] = handles[i];
+            handles[i] = host->handles[j];
+            break;
+        }
+    }
+
+    // The duplicates and the previous shapes not drawn again go in one batch, the
+    // duplicates come first and are all live
+    int droppedCount = kept;
+    for (int j = 0; j < host->count; j++) {
+        if (!used[j]) dropped[droppedCount++] = host->handles[j];
+    }
+    int removed = removeShapes(dropped, droppedCount) - kept;
+    restackShapes(handles, count);
+
+    if (report) {
+        printf("-#blue Scene reloaded: %d kept, %d new, %d removed\n", kept, count - kept, removed);
+    }
+
+    free(previous);
+    free(used);
+    free(dropped);
+    free(host->definitions);
+    free(host->handles);
+    host->definitions = definitions;
+    host->handles = handles;
+    host->count = count;
+    return 0;
+}
+
+/**
+ * @brief Loads the scene module and runs its scene.
+ *
+ * The shapes it draws are matched against those of the previous load (see matchScene),
+ * and the module is closed again: nothing in the store points into it afterwards.
+ *
+ * @param host The host, with its module path and texture set.
+ * @param window The window of the host.
+ * @param renderer The renderer of the host.
+ * @param capture true to only register the shapes (see setDrawCapture), false to
+ *                draw them like a compiled program does.
+ * @return 0 on success, -1 if the module cannot be loaded or its scene failed, in
+ *         which case the previous scene is left as it is.
+ */
+int loadScene(SceneHost *host, SDL_Window *window, SDL_Renderer *renderer, bool capture) {
+    // Recorded first, a broken build is not loaded again until it is rebuilt
+    if (readFileId(host->path, &host->fileId, &host->fileTime, &host->fileSize) != 0) {
+        printf("%sExecutionError: Scene module %s not found.\n", RED_COLOR, host->path);
+        return -1;
+    }
+
+    SceneModule config;
+    char title[sizeof(host->titleBuffer)];
+    void *library = openModule(host, &config, title, sizeof(title));
+    if (!library) return -1;
+
+    int first = shapeCount;
+    setDrawCapture(capture);
+    int result = config.scene(window, renderer, host->texture);
+    setDrawCapture(false);
+    dlclose(library);
+
+    if (result != 0) {
+        while (shapeCount > first) deleteShape(shapeCount - 1);
+        return -1;
+    }
+    if (matchScene(host, first, capture) != 0) return -1;
+    storeConfig(host, &config);
+    return 0;
+}
+
+/**
+ * @brief Frame hook of the host (see setFrameHook): reloads the scene once the module is rebuilt.
+ *
+ * The window follows the new size and title, the background the new color.
+ *
+ * @param userdata The SceneHost.
+ */
+void reloadSceneIfChanged(SDL_Window *window, SDL_Renderer *renderer, SDL_Color *background, void *userdata) {
+    SceneHost *host = userdata;
+    Uint32 now = SDL_GetTicks();
+    if (now - host->lastPoll < SCENE_MODULE_POLL) return;
+    host->lastPoll = now;
+
+    Uint64 id;
+    Sint64 time, size;
+    if (readFileId(host->path, &id, &time, &size) != 0) return;
+    if (id == host->fileId && time == host->fileTime && size == host->fileSize) return;
+
+    int previousW = host->config.windowW;
+    int previousH = host->config.windowH;
+    if (loadScene(host, window, renderer, true) != 0) return;
+
+    if (window) {
+        if (host->config.windowW != previousW || host->config.windowH != previousH) {
+            SDL_SetWindowSize(window, host->config.windowW, host->config.windowH);
+        }
+        SDL_SetWindowTitle(window, host->config.title);
+    }
+    background->r = (Uint8)host->config.bgcolorR;
+    background->g = (Uint8)host->config.bgcolorG;
+    background->b = (Uint8)host->config.bgcolorB;
+}
+
+/**
+ * @brief Releases the definitions kept by the host.
+ */
+void freeSceneHost(SceneHost *host) {
+    free(host->definitions);
+    free(host->handles);
+    host->definitions = NULL;
+    host->handles = NULL;
+    host->count = 0;
+}
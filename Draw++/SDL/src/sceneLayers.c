@@ -0,0 +1,261 @@
+#include "../files.h/sceneLayers.h"
+#include "../files.h/formEvents.h"
+#include "../files.h/geometry.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+// ANSI escape codes for colors
+#define RED_COLOR "-#red "
+
+// Growable list of shapes, in draw order
+typedef struct {
+    ShapeHandle *handles;
+    int count;
+    int capacity;
+} HandleList;
+
+static SDL_Texture *belowLayer = NULL;   // Static shapes under the lowest dynamic shape
+static SDL_Texture *aboveLayer = NULL;   // Static shapes over the highest dynamic shape
+static int layerWidth = 0;
+static int layerHeight = 0;
+static RenderPath layerPath;             // Back-end the layers were drawn with
+static bool layersValid = false;         // The layers match the static shapes
+static bool noLayers = false;            // The renderer cannot hold the layers, do not retry
+
+// Between the two layers, the band of shapes drawn every frame
+static int bandFirst = 0;
+static int bandLast = 0;                 // One past the highest dynamic shape
+
+static HandleList layerDynamic;          // Dynamic shapes when the layers were drawn
+static HandleList currentDynamic;        // Dynamic shapes now
+
+/**
+ * @brief Redraws the static layers before they are used next.
+ *
+ * Must be called whenever a shape that is neither selected nor animating changes:
+ * it is added, deleted, moved between layers, reset, or moved by a game.
+ * Shapes getting selected, deselected or animated are detected on their own.
+ */
+void invalidateSceneLayers(void) {
+    layersValid = false;
+}
+
+/**
+ * @brief Whether a shape may change from one frame to the next.
+ */
+static bool isShapeDynamic(const Shape *shape) {
+    return shape->selected || shape->isAnimating;
+}
+
+/**
+ * @brief Lists the dynamic shapes in draw order and finds the band they span.
+ *
+ * The layers are invalidated if the list differs from the one they were drawn with,
+ * e.g. when a shape is deselected and becomes static again.
+ *
+ * @return 0 on success, -1 if the list could not grow.
+ */
+static int findDynamicShapes(void) {
+    currentDynamic.count = 0;
+    bandFirst = bandLast = shapeCount;
+
+    for (int i = 0; i < shapeCount; i++) {
+        Shape *shape = getShapeInDrawOrder(i);
+        if (!isShapeDynamic(shape)) continue;
+
+        if (currentDynamic.count == currentDynamic.capacity) {
+            int capacity = currentDynamic.capacity ? currentDynamic.capacity * 2 : 64;
+            ShapeHandle *newHandles = realloc(currentDynamic.handles, capacity * sizeof(ShapeHandle));
+            if (!newHandles) return -1;
+            currentDynamic.handles = newHandles;
+            currentDynamic.capacity = capacity;
+        }
+        currentDynamic.handles[currentDynamic.count++] = getShapeHandle((int)(shape - shapes));
+
+        if (bandFirst == shapeCount) bandFirst = i;
+        bandLast = i + 1;
+    }
+
+    bool same = currentDynamic.count == layerDynamic.count;
+    for (int i = 0; same && i < currentDynamic.count; i++) {
+        same = currentDynamic.handles[i].slot == layerDynamic.handles[i].slot &&
+               currentDynamic.handles[i].generation == layerDynamic.handles[i].generation;
+    }
+    if (!same) {
+        HandleList swap = layerDynamic;
+        layerDynamic = currentDynamic;
+        currentDynamic = swap;
+        layersValid = false;
+    }
+    return 0;
+}
+
+/**
+ * @brief Destroys the layers so that they are created again on next use.
+ */
+static void destroyLayers(void) {
+    if (belowLayer) SDL_DestroyTexture(belowLayer);
+    if (aboveLayer) SDL_DestroyTexture(aboveLayer);
+    belowLayer = aboveLayer = NULL;
+    layerWidth = layerHeight = 0;
+    layersValid = false;
+}
+
+/**
+ * @brief Creates a transparent layer, composited as premultiplied alpha.
+ *
+ * Shapes blended onto transparent black leave premultiplied colors in the texture,
+ * so copying it with the usual blend mode would darken the translucent ones.
+ */
+static SDL_Texture* createLayer(SDL_Renderer *renderer, int width, int height) {
+#if SDL_VERSION_ATLEAST(2, 0, 6)
+    SDL_Texture *layer = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    if (!layer) return NULL;
+
+    SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+    if (SDL_SetTextureBlendMode(layer, premultiplied) != 0) {
+        SDL_DestroyTexture(layer);
+        return NULL;
+    }
+    return layer;
+#else
+    (void)renderer; (void)width; (void)height;
+    SDL_SetError("Custom blend modes need SDL 2.0.6");
+    return NULL;
+#endif
+}
+
+/**
+ * @brief Creates both layers at the size of the output.
+ *
+ * @return 0 on success, -1 if the renderer cannot draw into such textures.
+ */
+static int createLayers(SDL_Renderer *renderer, int width, int height) {
+    destroyLayers();
+
+    if (SDL_RenderTargetSupported(renderer)) {
+        belowLayer = createLayer(renderer, width, height);
+        aboveLayer = belowLayer ? createLayer(renderer, width, height) : NULL;
+    }
+    if (!belowLayer || !aboveLayer) {
+        printf("%sExecutionError: No static layers, drawing every shape each frame: %s\n", RED_COLOR, SDL_GetError());
+        destroyLayers();
+        noLayers = true;
+        return -1;
+    }
+
+    layerWidth = width;
+    layerHeight = height;
+    return 0;
+}
+
+/**
+ * @brief Clears a layer and draws a range of the draw order into it.
+ *
+ * @return 0 on success, -1 if the renderer could not draw into the layer.
+ */
+static int drawLayer(SDL_Renderer *renderer, SDL_Texture *layer, int first, int last) {
+    if (SDL_SetRenderTarget(renderer, layer) != 0) {
+        printf("%sExecutionError: Failed to draw into a static layer: %s\n", RED_COLOR, SDL_GetError());
+        return -1;
+    }
+    SDL_RenderSetClipRect(renderer, NULL);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    if (first < last) renderShapeRange(renderer, NULL, first, last);
+    return 0;
+}
+
+/**
+ * @brief Draws the static shapes under and over the band into their layers.
+ *
+ * The render target, clip rect and blend mode of the caller are restored, so this
+ * can run in the middle of a frame drawn into another texture.
+ *
+ * @return 0 on success, -1 if a layer could not be drawn.
+ */
+static int drawLayers(SDL_Renderer *renderer) {
+    SDL_Texture *target = SDL_GetRenderTarget(renderer);
+    SDL_Rect clip;
+    SDL_RenderGetClipRect(renderer, &clip);
+    bool clipped = SDL_RenderIsClipEnabled(renderer);
+    SDL_BlendMode blendMode;
+    SDL_GetRenderDrawBlendMode(renderer, &blendMode);
+
+    int result = drawLayer(renderer, belowLayer, 0, bandFirst);
+    if (result == 0 && bandLast < shapeCount) {
+        result = drawLayer(renderer, aboveLayer, bandLast, shapeCount);
+    }
+
+    SDL_SetRenderTarget(renderer, target);
+    SDL_RenderSetClipRect(renderer, clipped ? &clip : NULL);
+    SDL_SetRenderDrawBlendMode(renderer, blendMode);
+
+    layersValid = result == 0;
+    layerPath = getRenderPath();
+    return result;
+}
+
+/**
+ * @brief Draws the scene from cached layers plus the shapes that may change.
+ *
+ * Static shapes (neither selected nor animating) are drawn once into a layer under
+ * the lowest dynamic shape and a layer over the highest one, then copied each frame.
+ * Only the band between them is drawn shape by shape, so a frame costs two copies
+ * plus the moving shapes and the static ones interleaved with them in z-order.
+ *
+ * @param renderer The SDL renderer to use for drawing.
+ * @param area Only this area is drawn, NULL for the whole output.
+ * @return 0 on success, -1 if the scene is too small for layers or the renderer
+ *         cannot hold them: the caller then draws every shape itself.
+ */
+int renderSceneLayers(SDL_Renderer *renderer, const SDL_Rect *area) {
+    if (noLayers || shapeCount < SCENE_LAYERS_MIN_SHAPES) return -1;
+
+    int width, height;
+    SDL_GetRendererOutputSize(renderer, &width, &height);
+    if (!belowLayer || width != layerWidth || height != layerHeight) {
+        if (createLayers(renderer, width, height) != 0) return -1;
+    }
+    if (findDynamicShapes() != 0) return -1;
+    if (!layersValid || layerPath != getRenderPath()) {
+        if (drawLayers(renderer) != 0) return -1;
+    }
+
+    SDL_Rect output = {0, 0, layerWidth, layerHeight};
+    SDL_Rect copy = output;
+    if (area && !SDL_IntersectRect(area, &output, &copy)) return 0;
+
+    RenderStats stats = {0, 0, 0, 0, 0};
+    SDL_RenderCopy(renderer, belowLayer, &copy, &copy);
+    if (bandFirst < bandLast) {
+        renderShapeRange(renderer, area, bandFirst, bandLast);
+        stats = getRenderStats();
+    }
+    if (bandLast < shapeCount) {
+        SDL_RenderCopy(renderer, aboveLayer, &copy, &copy);
+        stats.drawCalls++;
+    }
+    stats.drawCalls++;
+    setRenderStats(stats);
+    return 0;
+}
+
+/**
+ * @brief Releases the layers and the shape lists.
+ *
+ * Must be called before the renderer is destroyed.
+ */
+void freeSceneLayers(void) {
+    destroyLayers();
+    free(layerDynamic.handles);
+    free(currentDynamic.handles);
+    layerDynamic = currentDynamic = (HandleList){NULL, 0, 0};
+    noLayers = false;
+}
@@ -0,0 +1,327 @@
+#include "../files.h/snapshot.h"
+#include "../files.h/formEvents.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ANSI escape codes for colors
+#define RED_COLOR "-#red "
+
+#define SNAPSHOT_MAGIC "DPPS"
+#define FNV_OFFSET 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+// File header, followed by shapeCount records
+typedef struct {
+    char magic[4];
+    Uint32 version;
+    Uint32 recordSize;      // sizeof(SnapshotShape) of the program that wrote the file
+    Uint32 shapeCount;
+    Uint64 programHash;     // See SnapshotConfig
+    Uint64 checksum;        // FNV-1a of the records
+} SnapshotHeader;
+
+// One shape, without pointers and with every field at a fixed offset
+typedef struct {
+    Uint8 type;             // ShapeType
+    Uint8 form;             // FormType
+    Uint8 selected;
+    Uint8 isAnimating;
+    SDL_Color color;
+    SDL_Color initialColor;
+    Uint8 animations[3];    // AnimationType
+    Uint8 animationCount;
+    Uint8 animationParser;
+    Uint8 padding[3];
+    Sint32 zIndex;
+    double rotation;
+    double initialRotation;
+    float zoom, zoomDirection, colorPhase;
+    float bounceVelocity, bounceDirection, bounceRemainderX, bounceRemainderY;
+    float animationLag;
+    Uint8 data[sizeof(((Shape *)0)->data)];   // Geometry union, plain integers and floats
+} SnapshotShape;
+
+SDL_COMPILE_TIME_ASSERT(snapshotHeader, sizeof(SnapshotHeader) == 32);
+SDL_COMPILE_TIME_ASSERT(snapshotShape, offsetof(SnapshotShape, data) == 72 &&
+                                       sizeof(SnapshotShape) == 72 + sizeof(((Shape *)0)->data));
+
+// Read-only view of a whole file
+typedef struct {
+    const Uint8 *bytes;
+    size_t size;
+} MappedFile;
+
+SnapshotConfig snapshot = {false, SNAPSHOT_DEFAULT_PATH, 0};
+
+/**
+ * @brief Reads the snapshot option from the program arguments.
+ *
+ * Recognized option: --snapshot FILE. Unknown arguments are ignored.
+ *
+ * @return 0 on success, -1 if the option is missing its value.
+ */
+int parseSnapshotArgs(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--snapshot") != 0) continue;
+        if (i + 1 >= argc) {
+            printf("%sExecutionError: Missing value for --snapshot\n", RED_COLOR);
+            return -1;
+        }
+        snapshot.enabled = true;
+        snapshot.path = argv[++i];
+    }
+    return 0;
+}
+
+/**
+ * @brief 64-bit FNV-1a hash of a block of memory.
+ */
+static Uint64 hashBytes(const void *data, size_t size) {
+    const Uint8 *bytes = data;
+    Uint64 hash = FNV_OFFSET;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * @brief Converts a shape to its snapshot record.
+ */
+static void packShape(const Shape *shape, SnapshotShape *record) {
+    memset(record, 0, sizeof(*record));
+    record->type = (Uint8)shape->type;
+    record->form = (Uint8)shape->typeForm;
+    record->selected = shape->selected;
+    record->isAnimating = shape->isAnimating;
+    record->color = shape->color;
+    record->initialColor = shape->initial_color;
+    for (int i = 0; i < 3; i++) {
+        record->animations[i] = (Uint8)shape->animations[i];
+    }
+    record->animationCount = (Uint8)shape->num_animations;
+    record->animationParser = (Uint8)shape->animation_parser;
+    record->zIndex = shape->zIndex;
+    record->rotation = shape->rotation;
+    record->initialRotation = shape->initial_rotation;
+    record->zoom = shape->zoom;
+    record->zoomDirection = shape->zoom_direction;
+    record->colorPhase = shape->color_phase;
+    record->bounceVelocity = shape->bounce_velocity;
+    record->bounceDirection = shape->bounce_direction;
+    record->bounceRemainderX = shape->bounce_remainder_x;
+    record->bounceRemainderY = shape->bounce_remainder_y;
+    record->animationLag = shape->animation_lag;
+    memcpy(record->data, &shape->data, sizeof(record->data));
+}
+
+/**
+ * @brief Converts a snapshot record back to a shape.
+ *
+ * @return false if the record holds values no shape can have.
+ */
+static bool unpackShape(const SnapshotShape *record, Shape *shape) {
+    if (record->type > SHAPE_LINE || record->form > FORM_FILLED || record->animationCount > 3 ||
+        record->animationParser > ANIM_BOUNCE) {
+        return false;
+    }
+
+    memset(shape, 0, sizeof(*shape));
+    shape->type = (ShapeType)record->type;
+    shape->typeForm = (FormType)record->form;
+    shape->selected = record->selected;
+    shape->isAnimating = record->isAnimating;
+    shape->color = record->color;
+    shape->initial_color = record->initialColor;
+    for (int i = 0; i < 3; i++) {
+        if (record->animations[i] > ANIM_BOUNCE) return false;
+        shape->animations[i] = (AnimationType)record->animations[i];
+    }
+    shape->num_animations = record->animationCount;
+    shape->animation_parser = (AnimationType)record->animationParser;
+    shape->zIndex = record->zIndex;
+    shape->geometryDirty = true;
+    shape->rotation = record->rotation;
+    shape->initial_rotation = record->initialRotation;
+    shape->zoom = record->zoom;
+    shape->zoom_direction = record->zoomDirection;
+    shape->color_phase = record->colorPhase;
+    shape->bounce_velocity = record->bounceVelocity;
+    shape->bounce_direction = record->bounceDirection;
+    shape->bounce_remainder_x = record->bounceRemainderX;
+    shape->bounce_remainder_y = record->bounceRemainderY;
+    shape->animation_lag = record->animationLag;
+    memcpy(&shape->data, record->data, sizeof(record->data));
+    return true;
+}
+
+/**
+ * @brief Saves shapes to a snapshot file.
+ *
+ * The file is written next to the target and renamed over it once complete, so
+ * an interrupted save never leaves a truncated snapshot behind.
+ *
+ * @param path File to write.
+ * @param source Shapes to save, z-indices and animation state included.
+ * @param count Number of shapes in `source`.
+ * @return 0 on success, -1 if the file could not be written.
+ */
+int saveSnapshot(const char *path, const Shape *source, int count) {
+    SnapshotShape *records = malloc((count > 0 ? count : 1) * sizeof(SnapshotShape));
+    size_t tempLength = strlen(path) + 5;
+    char *tempPath = malloc(tempLength);
+    if (!records || !tempPath) {
+        printf("%sExecutionError: Memory allocation failed for the scene snapshot\n", RED_COLOR);
+        free(records);
+        free(tempPath);
+        return -1;
+    }
+    snprintf(tempPath, tempLength, "%s.tmp", path);
+
+    for (int i = 0; i < count; i++) {
+        packShape(&source[i], &records[i]);
+    }
+
+    SnapshotHeader header = {0};
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.recordSize = sizeof(SnapshotShape);
+    header.shapeCount = (Uint32)count;
+    header.programHash = snapshot.programHash;
+    header.checksum = hashBytes(records, (size_t)count * sizeof(SnapshotShape));
+
+    FILE *file = fopen(tempPath, "wb");
+    bool written = file && fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   fwrite(records, sizeof(SnapshotShape), count, file) == (size_t)count;
+    if (file && fclose(file) != 0) written = false;
+
+#ifdef _WIN32
+    if (written) remove(path);  // rename does not replace an existing file on Windows
+#endif
+    if (!written || rename(tempPath, path) != 0) {
+        printf("%sExecutionError: Failed to write the scene snapshot %s\n", RED_COLOR, path);
+        remove(tempPath);
+        free(records);
+        free(tempPath);
+        return -1;
+    }
+
+    free(records);
+    free(tempPath);
+    return 0;
+}
+
+/**
+ * @brief Maps a whole file in memory, read-only.
+ *
+ * @return 0 on success, -1 if the file cannot be opened or mapped.
+ */
+static int mapFile(const char *path, MappedFile *file) {
+    *file = (MappedFile){0};
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (handle == INVALID_HANDLE_VALUE) return -1;
+
+    LARGE_INTEGER size;
+    HANDLE mapping = NULL;
+    if (GetFileSizeEx(handle, &size) && size.QuadPart > 0) {
+        mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    }
+    CloseHandle(handle);
+    if (!mapping) return -1;
+
+    // The view keeps the mapping alive once its handle is closed
+    file->bytes = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!file->bytes) return -1;
+    file->size = (size_t)size.QuadPart;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) return -1;
+
+    struct stat info;
+    void *bytes = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        bytes = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (bytes == MAP_FAILED) return -1;
+
+    file->bytes = bytes;
+    file->size = (size_t)info.st_size;
+#endif
+    return 0;
+}
+
+static void unmapFile(MappedFile *file) {
+    if (!file->bytes) return;
+#ifdef _WIN32
+    UnmapViewOfFile(file->bytes);
+#else
+    munmap((void *)file->bytes, file->size);
+#endif
+    *file = (MappedFile){0};
+}
+
+/**
+ * @brief Replaces the scene with the one saved in a snapshot file.
+ *
+ * The file is mapped in memory and its records are converted in place, without
+ * copying it first. A file written by another version of the format or by another
+ * program, or whose checksum does not match, is left alone and the scene is kept.
+ *
+ * @param path File to read.
+ * @return 0 if the scene was restored, -1 if the file is missing, stale or corrupt.
+ */
+int loadSnapshot(const char *path) {
+    MappedFile file;
+    if (mapFile(path, &file) != 0) return -1;  // No snapshot yet
+
+    const SnapshotHeader *header = (const SnapshotHeader *)file.bytes;
+    const char *problem = NULL;
+    if (file.size < sizeof(SnapshotHeader) || memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0) {
+        problem = "is not a scene snapshot";
+    } else if (header->version != SNAPSHOT_VERSION || header->recordSize != sizeof(SnapshotShape)) {
+        problem = "was written by another version of Draw++";
+    } else if (header->programHash != snapshot.programHash) {
+        problem = "was saved by another program";
+    } else if (file.size != sizeof(SnapshotHeader) + (Uint64)header->shapeCount * sizeof(SnapshotShape)) {
+        problem = "is truncated";
+    }
+
+    const SnapshotShape *records = (const SnapshotShape *)(file.bytes + sizeof(SnapshotHeader));
+    int count = problem ? 0 : (int)header->shapeCount;
+    if (!problem && hashBytes(records, (size_t)count * sizeof(SnapshotShape)) != header->checksum) {
+        problem = "is corrupt (checksum mismatch)";
+    }
+
+    Shape *restored = problem ? NULL : malloc((count > 0 ? count : 1) * sizeof(Shape));
+    if (!problem && !restored) problem = "cannot be loaded (out of memory)";
+    for (int i = 0; !problem && i < count; i++) {
+        if (!unpackShape(&records[i], &restored[i])) problem = "is corrupt (invalid shape)";
+    }
+
+    if (problem) {
+        printf("Snapshot %s %s, running the program instead\n", path, problem);
+        free(restored);
+        unmapFile(&file);
+        return -1;
+    }
+
+    replaceShapes(restored, count);
+    free(restored);
+    unmapFile(&file);
+    return 0;
+}
@@ -0,0 +1,462 @@
+#include "../files.h/softRaster.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+// ANSI escape codes for colors
+#define RED_COLOR "-#red "
+
+// Vertex positions are snapped to 1/256 of a pixel before rasterizing
+#define SUBPIXEL_BITS 8
+#define SUBPIXEL_ONE (1 << SUBPIXEL_BITS)
+
+// Growable list of the shapes overlapping a tile, in draw order
+typedef struct {
+    int *shapes;
+    int count;
+    int capacity;
+} TileBin;
+
+// What the threads share while rasterizing one batch
+typedef struct {
+    const SDL_Vertex *vertices;
+    const int *indices;
+    const RasterShape *shapes;
+    SDL_Rect region;            // Part of the buffer being redrawn
+    int *tiles;                 // Tiles with at least one shape
+    int tileCount;
+} RasterJob;
+
+static Uint32 *pixels = NULL;   // RGBA8888, straight alpha, transparent where no shape is drawn
+static int rasterWidth = 0;
+static int rasterHeight = 0;
+static SDL_Texture *texture = NULL;
+
+static TileBin *bins = NULL;
+static int tilesX = 0;
+static int tilesY = 0;
+static int *activeTiles = NULL;
+static RasterJob job;
+static SDL_atomic_t nextTile;
+
+// Worker pool. The main thread rasterizes tiles too, so it holds threadCount - 1 workers.
+static int requestedThreads = 0;    // 0: one per CPU core
+static SDL_Thread *workers[RASTER_MAX_THREADS];
+static int workerCount = 0;
+static SDL_mutex *poolLock = NULL;
+static SDL_cond *workReady = NULL;
+static SDL_cond *workDone = NULL;
+static int poolFrame = 0;           // Bumped for every batch handed to the workers
+static int poolBusy = 0;            // Workers still rasterizing the current batch
+static bool poolQuit = false;
+static bool noPool = false;         // Creating the pool failed, rasterize on the main thread
+
+/**
+ * @brief Blends a color over a pixel, keeping the buffer in straight alpha.
+ *
+ * Copying the buffer with SDL_BLENDMODE_BLEND then gives the same result as
+ * blending every shape onto the target one after the other.
+ */
+static void blendPixel(Uint32 *pixel, SDL_Color color) {
+    Uint32 dst = *pixel;
+    int da = dst & 0xFF;
+    if (color.a == 255 || da == 0) {
+        *pixel = ((Uint32)color.r << 24) | ((Uint32)color.g << 16) | ((Uint32)color.b << 8) | color.a;
+        return;
+    }
+
+    int kept = da * (255 - color.a) / 255;  // Weight of the pixel under the color
+    int outA = color.a + kept;
+    int r = (color.r * color.a + (int)(dst >> 24) * kept) / outA;
+    int g = (color.g * color.a + (int)((dst >> 16) & 0xFF) * kept) / outA;
+    int b = (color.b * color.a + (int)((dst >> 8) & 0xFF) * kept) / outA;
+    *pixel = ((Uint32)r << 24) | ((Uint32)g << 16) | ((Uint32)b << 8) | (Uint32)outA;
+}
+
+/**
+ * @brief Whether pixels exactly on an edge belong to the triangle (top-left rule).
+ *
+ * Two triangles sharing an edge then never both cover a pixel, so translucent
+ * fans and strips do not show their seams.
+ */
+static bool isTopLeft(Sint64 x0, Sint64 y0, Sint64 x1, Sint64 y1) {
+    return y1 < y0 || (y1 == y0 && x1 > x0);
+}
+
+/**
+ * @brief Fills the pixels of a triangle whose centers fall inside it.
+ *
+ * @param clip Only the pixels in this rectangle are written.
+ * @param a, b, c The vertices; the color of the first one is used.
+ */
+static void fillTriangle(const SDL_Rect *clip, const SDL_Vertex *a, const SDL_Vertex *b, const SDL_Vertex *c) {
+    SDL_Color color = a->color;
+    if (color.a == 0) return;
+
+    Sint64 ax = lroundf(a->position.x * SUBPIXEL_ONE), ay = lroundf(a->position.y * SUBPIXEL_ONE);
+    Sint64 bx = lroundf(b->position.x * SUBPIXEL_ONE), by = lroundf(b->position.y * SUBPIXEL_ONE);
+    Sint64 cx = lroundf(c->position.x * SUBPIXEL_ONE), cy = lroundf(c->position.y * SUBPIXEL_ONE);
+
+    Sint64 area = (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+    if (area == 0) return;
+    if (area < 0) {
+        Sint64 swap = bx; bx = cx; cx = swap;
+        swap = by; by = cy; cy = swap;
+    }
+
+    // Pixels whose centers may be inside, limited to the clip rect
+    Sint64 minFx = SDL_min(ax, SDL_min(bx, cx)), maxFx = SDL_max(ax, SDL_max(bx, cx));
+    Sint64 minFy = SDL_min(ay, SDL_min(by, cy)), maxFy = SDL_max(ay, SDL_max(by, cy));
+    int minX = (int)SDL_max((Sint64)clip->x, (minFx >> SUBPIXEL_BITS) - 1);
+    int maxX = (int)SDL_min((Sint64)clip->x + clip->w - 1, (maxFx >> SUBPIXEL_BITS) + 1);
+    int minY = (int)SDL_max((Sint64)clip->y, (minFy >> SUBPIXEL_BITS) - 1);
+    int maxY = (int)SDL_min((Sint64)clip->y + clip->h - 1, (maxFy >> SUBPIXEL_BITS) + 1);
+    if (minX > maxX || minY > maxY) return;
+
+    // Edge functions at the center of the first pixel, and their change per pixel
+    Sint64 px = ((Sint64)minX << SUBPIXEL_BITS) + SUBPIXEL_ONE / 2;
+    Sint64 py = ((Sint64)minY << SUBPIXEL_BITS) + SUBPIXEL_ONE / 2;
+    Sint64 rows[3] = {
+        (cx - bx) * (py - by) - (cy - by) * (px - bx) - (isTopLeft(bx, by, cx, cy) ? 0 : 1),
+        (ax - cx) * (py - cy) - (ay - cy) * (px - cx) - (isTopLeft(cx, cy, ax, ay) ? 0 : 1),
+        (bx - ax) * (py - ay) - (by - ay) * (px - ax) - (isTopLeft(ax, ay, bx, by) ? 0 : 1)
+    };
+    const Sint64 stepsX[3] = {(by - cy) * SUBPIXEL_ONE, (cy - ay) * SUBPIXEL_ONE, (ay - by) * SUBPIXEL_ONE};
+    const Sint64 stepsY[3] = {(cx - bx) * SUBPIXEL_ONE, (ax - cx) * SUBPIXEL_ONE, (bx - ax) * SUBPIXEL_ONE};
+    int columns = maxX - minX;
+
+    for (int y = minY; y <= maxY; y++) {
+        // Solve each edge function for the span of the row it keeps inside
+        int first = 0, last = columns;
+        for (int e = 0; e < 3; e++) {
+            Sint64 w = rows[e], step = stepsX[e];
+            if (step > 0) {
+                if (w < 0) first = (int)SDL_max((Sint64)first, (-w + step - 1) / step);
+            } else if (step < 0) {
+                last = w < 0 ? -1 : (int)SDL_min((Sint64)last, w / -step);
+            } else if (w < 0) {
+                last = -1;
+            }
+            rows[e] += stepsY[e];
+        }
+
+        Uint32 *line = pixels + (size_t)y * rasterWidth + minX;
+        if (color.a == 255) {
+            Uint32 packed = ((Uint32)color.r << 24) | ((Uint32)color.g << 16) | ((Uint32)color.b << 8) | 0xFF;
+            for (int x = first; x <= last; x++) line[x] = packed;
+        } else {
+            for (int x = first; x <= last; x++) blendPixel(&line[x], color);
+        }
+    }
+}
+
+/**
+ * @brief Draws, in order, the shapes binned in a tile.
+ */
+static void rasterizeTile(int tile) {
+    SDL_Rect bounds = {(tile % tilesX) * RASTER_TILE_SIZE, (tile / tilesX) * RASTER_TILE_SIZE,
+                       RASTER_TILE_SIZE, RASTER_TILE_SIZE};
+    SDL_Rect clip;
+    if (!SDL_IntersectRect(&bounds, &job.region, &clip)) return;
+
+    const TileBin *bin = &bins[tile];
+    for (int i = 0; i < bin->count; i++) {
+        const RasterShape *shape = &job.shapes[bin->shapes[i]];
+        for (int j = shape->firstIndex; j + 2 < shape->lastIndex; j += 3) {
+            fillTriangle(&clip, &job.vertices[job.indices[j]], &job.vertices[job.indices[j + 1]],
+                         &job.vertices[job.indices[j + 2]]);
+        }
+    }
+}
+
+/**
+ * @brief Takes tiles of the current job until none is left. Run by every thread.
+ */
+static void rasterizeTiles(void) {
+    int tile;
+    while ((tile = SDL_AtomicAdd(&nextTile, 1)) < job.tileCount) {
+        rasterizeTile(job.tiles[tile]);
+    }
+}
+
+/**
+ * @brief Waits for batches and helps rasterizing them until the pool is stopped.
+ *
+ * @param data The value of poolFrame when the worker was started.
+ */
+static int rasterWorker(void *data) {
+    int seenFrame = (int)(intptr_t)data;
+
+    SDL_LockMutex(poolLock);
+    while (true) {
+        while (!poolQuit && seenFrame == poolFrame) SDL_CondWait(workReady, poolLock);
+        if (poolQuit) break;
+        seenFrame = poolFrame;
+        SDL_UnlockMutex(poolLock);
+
+        rasterizeTiles();
+
+        SDL_LockMutex(poolLock);
+        if (--poolBusy == 0) SDL_CondSignal(workDone);
+    }
+    SDL_UnlockMutex(poolLock);
+    return 0;
+}
+
+/**
+ * @brief Stops and joins the workers.
+ */
+static void stopPool(void) {
+    if (poolLock) {
+        SDL_LockMutex(poolLock);
+        poolQuit = true;
+        SDL_CondBroadcast(workReady);
+        SDL_UnlockMutex(poolLock);
+    }
+    for (int i = 0; i < workerCount; i++) {
+        SDL_WaitThread(workers[i], NULL);
+    }
+    workerCount = 0;
+    poolQuit = false;
+
+    if (workDone) SDL_DestroyCond(workDone);
+    if (workReady) SDL_DestroyCond(workReady);
+    if (poolLock) SDL_DestroyMutex(poolLock);
+    workDone = workReady = NULL;
+    poolLock = NULL;
+}
+
+/**
+ * @brief Starts one worker per thread wanted besides the main one.
+ *
+ * @return 0 on success, -1 if the pool could not be created.
+ */
+static int startPool(int threads) {
+    poolLock = SDL_CreateMutex();
+    workReady = SDL_CreateCond();
+    workDone = SDL_CreateCond();
+    if (!poolLock || !workReady || !workDone) {
+        stopPool();
+        return -1;
+    }
+
+    for (int i = 0; i < threads - 1; i++) {
+        workers[i] = SDL_CreateThread(rasterWorker, "raster", (void *)(intptr_t)poolFrame);
+        if (!workers[i]) {
+            stopPool();
+            return -1;
+        }
+        workerCount++;
+    }
+    return 0;
+}
+
+/**
+ * @brief Sets the number of threads rasterizing tiles, the main thread included.
+ *
+ * @param threads The number of threads, or 0 for one per CPU core.
+ */
+void setRasterThreads(int threads) {
+    requestedThreads = SDL_max(0, SDL_min(threads, RASTER_MAX_THREADS));
+    stopPool();
+    noPool = false;
+}
+
+/**
+ * @brief Returns the number of threads that rasterize the next batch.
+ */
+int getRasterThreads(void) {
+    int threads = requestedThreads ? requestedThreads : SDL_GetCPUCount();
+    return SDL_max(1, SDL_min(threads, RASTER_MAX_THREADS));
+}
+
+/**
+ * @brief Releases the pixel buffer, the tile bins and the texture.
+ */
+static void releaseBuffers(void) {
+    for (int i = 0; i < tilesX * tilesY; i++) free(bins[i].shapes);
+    free(bins);
+    free(activeTiles);
+    free(pixels);
+    if (texture) SDL_DestroyTexture(texture);
+    bins = NULL;
+    activeTiles = NULL;
+    pixels = NULL;
+    texture = NULL;
+    rasterWidth = rasterHeight = tilesX = tilesY = 0;
+}
+
+/**
+ * @brief Resizes the pixel buffer, the tile bins and the texture to the output.
+ *
+ * @return 0 on success, -1 if the memory or the texture could not be allocated.
+ */
+static int resizeRaster(SDL_Renderer *renderer, int width, int height) {
+    releaseBuffers();
+
+    int columns = (width + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+    int rows = (height + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+    pixels = calloc((size_t)width * height, sizeof(Uint32));
+    bins = calloc((size_t)columns * rows, sizeof(TileBin));
+    activeTiles = malloc((size_t)columns * rows * sizeof(int));
+    if (!pixels || !bins || !activeTiles) {
+        printf("%sExecutionError: Failed to allocate memory for the software rasterizer\n", RED_COLOR);
+        return -1;
+    }
+    tilesX = columns;
+    tilesY = rows;
+
+    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING, width, height);
+    if (!texture) {
+        printf("%sExecutionError: Failed to create the software rasterizer texture: %s\n", RED_COLOR, SDL_GetError());
+        return -1;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    rasterWidth = width;
+    rasterHeight = height;
+    return 0;
+}
+
+/**
+ * @brief Adds a shape to the bins of the tiles its triangles overlap.
+ *
+ * @return 0 on success, -1 if a bin could not grow.
+ */
+static int binShape(int index) {
+    const RasterShape *shape = &job.shapes[index];
+    if (shape->lastIndex - shape->firstIndex < 3) return 0;
+
+    float minX = job.vertices[job.indices[shape->firstIndex]].position.x, maxX = minX;
+    float minY = job.vertices[job.indices[shape->firstIndex]].position.y, maxY = minY;
+    for (int i = shape->firstIndex + 1; i < shape->lastIndex; i++) {
+        SDL_FPoint position = job.vertices[job.indices[i]].position;
+        minX = SDL_min(minX, position.x);
+        maxX = SDL_max(maxX, position.x);
+        minY = SDL_min(minY, position.y);
+        maxY = SDL_max(maxY, position.y);
+    }
+
+    // One pixel of slack covers the centers fillTriangle may reach
+    SDL_Rect bounds = {(int)floorf(minX) - 1, (int)floorf(minY) - 1, 0, 0};
+    bounds.w = (int)ceilf(maxX) + 2 - bounds.x;
+    bounds.h = (int)ceilf(maxY) + 2 - bounds.y;
+    if (!SDL_IntersectRect(&bounds, &job.region, &bounds)) return 0;
+
+    int firstColumn = bounds.x / RASTER_TILE_SIZE, lastColumn = (bounds.x + bounds.w - 1) / RASTER_TILE_SIZE;
+    int firstRow = bounds.y / RASTER_TILE_SIZE, lastRow = (bounds.y + bounds.h - 1) / RASTER_TILE_SIZE;
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int column = firstColumn; column <= lastColumn; column++) {
+            TileBin *bin = &bins[row * tilesX + column];
+            if (bin->count == bin->capacity) {
+                int capacity = bin->capacity ? bin->capacity * 2 : 16;
+                int *newShapes = realloc(bin->shapes, capacity * sizeof(int));
+                if (!newShapes) return -1;
+                bin->shapes = newShapes;
+                bin->capacity = capacity;
+            }
+            bin->shapes[bin->count++] = index;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Rasterizes the tiles of the current job on the pool and the calling thread.
+ */
+static void runJob(void) {
+    int threads = getRasterThreads();
+    if (!noPool && threads > 1 && workerCount != threads - 1) {
+        stopPool();
+        if (startPool(threads) != 0) {
+            printf("%sExecutionError: Failed to start the rasterizer threads, using one: %s\n", RED_COLOR, SDL_GetError());
+            noPool = true;
+        }
+    }
+
+    SDL_AtomicSet(&nextTile, 0);
+    if (workerCount == 0 || job.tileCount < 2) {
+        rasterizeTiles();
+        return;
+    }
+
+    SDL_LockMutex(poolLock);
+    poolFrame++;
+    poolBusy = workerCount;
+    SDL_CondBroadcast(workReady);
+    SDL_UnlockMutex(poolLock);
+
+    rasterizeTiles();
+
+    SDL_LockMutex(poolLock);
+    while (poolBusy > 0) SDL_CondWait(workDone, poolLock);
+    SDL_UnlockMutex(poolLock);
+}
+
+/**
+ * @brief Draws tessellated shapes on the CPU and copies the result to the renderer.
+ *
+ * The output is split into RASTER_TILE_SIZE tiles. Every shape is binned into the
+ * tiles its bounding box overlaps, then the tiles are rasterized in parallel: each
+ * thread owns whole tiles, so no pixel is ever written by two threads, and each tile
+ * draws its shapes in order, so the z-order is kept.
+ *
+ * @param renderer The renderer the result is copied to.
+ * @param area Only this area is redrawn, NULL for the whole output.
+ * @param vertices Vertices of the batch.
+ * @param indices Three indices per triangle.
+ * @param rasterShapes Triangles of each shape, in draw order.
+ * @param count Number of shapes.
+ * @return 0 on success, -1 if the buffers could not be allocated.
+ */
+int rasterizeShapes(SDL_Renderer *renderer, const SDL_Rect *area, const SDL_Vertex *vertices,
+                    const int *indices, const RasterShape *rasterShapes, int count) {
+    int width, height;
+    SDL_GetRendererOutputSize(renderer, &width, &height);
+    if (!texture || width != rasterWidth || height != rasterHeight) {
+        if (resizeRaster(renderer, width, height) != 0) return -1;
+    }
+
+    SDL_Rect output = {0, 0, width, height};
+    job.region = output;
+    if (area && !SDL_IntersectRect(area, &output, &job.region)) return 0;
+    job.vertices = vertices;
+    job.indices = indices;
+    job.shapes = rasterShapes;
+
+    for (int y = job.region.y; y < job.region.y + job.region.h; y++) {
+        memset(pixels + (size_t)y * width + job.region.x, 0, job.region.w * sizeof(Uint32));
+    }
+
+    for (int i = 0; i < tilesX * tilesY; i++) bins[i].count = 0;
+    for (int i = 0; i < count; i++) {
+        if (binShape(i) != 0) {
+            printf("%sExecutionError: Failed to allocate memory for the rasterizer tiles\n", RED_COLOR);
+            return -1;
+        }
+    }
+    job.tileCount = 0;
+    for (int i = 0; i < tilesX * tilesY; i++) {
+        if (bins[i].count > 0) activeTiles[job.tileCount++] = i;
+    }
+    job.tiles = activeTiles;
+
+    runJob();
+
+    SDL_UpdateTexture(texture, &job.region, pixels + (size_t)job.region.y * width + job.region.x, width * sizeof(Uint32));
+    SDL_RenderCopy(renderer, texture, &job.region, &job.region);
+    return 0;
+}
+
+/**
+ * @brief Stops the workers and releases the buffers and the texture.
+ *
+ * Must be called before the renderer is destroyed.
+ */
+void freeSoftRaster(void) {
+    stopPool();
+    noPool = false;
+    releaseBuffers();
+}
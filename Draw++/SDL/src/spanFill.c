@@ -0,0 +1,400 @@
+#include "../files.h/spanFill.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// ANSI escape codes for colors
+#define RED_COLOR "-#red "
+
+#ifdef KERNELS_X86
+#include <immintrin.h>
+#endif
+
+// Slack on the edge intersections, so a pixel center exactly on an edge does not flicker in and out
+#define SPAN_EPSILON 1e-9
+
+#define STAMP_BLOCK 64  // The stamp texture grows by multiples of this many pixels
+
+typedef void (*SpanWriter)(Uint32 *row, int count, Uint32 pixel);
+
+static SDL_Renderer *stampRenderer = NULL;
+static SDL_Texture *stamp = NULL;   // Streaming texture the spans are written into, RGBA8888 straight alpha
+static int stampWidth = 0;
+static int stampHeight = 0;
+
+static KernelSelection spanKernels = {KERNEL_SCALAR, false};
+
+/**
+ * @brief Appends a span, empty spans (x1 > x2) are skipped.
+ *
+ * @return 0 on success, -1 if the list could not grow (the list is then freed).
+ */
+static int pushSpan(SpanList *list, int y, int x1, int x2) {
+    if (x1 > x2) return 0;
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 64;
+        FillSpan *grown = realloc(list->items, capacity * sizeof(FillSpan));
+        if (!grown) {
+            printf("%sExecutionError: Memory allocation failed for the fill spans\n", RED_COLOR);
+            free(list->items);
+            *list = (SpanList){0};
+            return -1;
+        }
+        list->items = grown;
+        list->capacity = capacity;
+    }
+    list->items[list->count++] = (FillSpan){y, x1, x2};
+    return 0;
+}
+
+/**
+ * @brief Appends the rows of a filled circle, the same pixels as the animated circle always drew.
+ *
+ * @return 0 on success, -1 if the list could not grow.
+ */
+int pushCircleSpans(SpanList *list, int cx, int cy, int radius) {
+    for (int dy = -radius; dy <= radius; dy++) {
+        int dx = (int)sqrt((double)radius * radius - (double)dy * dy);
+        if (pushSpan(list, cy + dy, cx - dx, cx + dx) == -1) return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Appends the rows of a filled ellipse.
+ *
+ * @return 0 on success, -1 if the list could not grow.
+ */
+int pushEllipseSpans(SpanList *list, int cx, int cy, int rx, int ry) {
+    if (rx < 0 || ry < 0) return 0;
+    for (int dy = -ry; dy <= ry; dy++) {
+        int dx = (ry == 0) ? rx : (int)(rx * sqrt(1.0 - (double)dy * dy / ((double)ry * ry)));
+        if (pushSpan(list, cy + dy, cx - dx, cx + dx) == -1) return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Narrows [*lo, *hi] to the integer x with a * x + b >= 0, or > 0 when strict.
+ *
+ * @return false if no x is left.
+ */
+static bool clipHalfPlane(double a, double b, bool strict, int *lo, int *hi) {
+    if (fabs(a) < SPAN_EPSILON) {
+        bool inside = strict ? (b > SPAN_EPSILON) : (b >= -SPAN_EPSILON);
+        if (!inside) *hi = *lo - 1;
+    } else {
+        double t = -b / a;
+        if (a > 0) {
+            int first = strict ? (int)floor(t + SPAN_EPSILON) + 1 : (int)ceil(t - SPAN_EPSILON);
+            if (first > *lo) *lo = first;
+        } else {
+            int last = strict ? (int)ceil(t - SPAN_EPSILON) - 1 : (int)floor(t + SPAN_EPSILON);
+            if (last < *hi) *hi = last;
+        }
+    }
+    return *lo <= *hi;
+}
+
+/**
+ * @brief Appends the rows of a filled pie, the sector of a circle between two angles.
+ *
+ * Angles are in degrees and grow clockwise on screen like SDL2_gfx's filledPieRGBA,
+ * an end angle below the start one wraps around. A sector of at most half a turn is
+ * the circle cut by two half-planes, a wider one is the circle minus the narrower
+ * opposite sector, so each row has at most two spans.
+ *
+ * @return 0 on success, -1 if the list could not grow.
+ */
+int pushPieSpans(SpanList *list, int cx, int cy, int radius, double startAngle, double endAngle) {
+    double sweep = endAngle - startAngle;
+    bool full = (sweep >= 360.0 || sweep <= -360.0);
+    sweep = fmod(sweep, 360.0);
+    if (sweep < 0) sweep += 360.0;
+
+    double start = startAngle * M_PI / 180.0, end = (startAngle + sweep) * M_PI / 180.0;
+    double sx = cos(start), sy = sin(start);
+    double ex = cos(end), ey = sin(end);
+
+    for (int dy = -radius; dy <= radius; dy++) {
+        int w = (int)sqrt((double)radius * radius - (double)dy * dy);
+        int lo = -w, hi = w;
+
+        if (full) {
+            if (pushSpan(list, cy + dy, cx + lo, cx + hi) == -1) return -1;
+        } else if (sweep <= 180.0) {
+            // Clockwise of the start ray and counter-clockwise of the end ray
+            if (clipHalfPlane(-sy, sx * dy, false, &lo, &hi) && clipHalfPlane(ey, -ex * dy, false, &lo, &hi)) {
+                if (pushSpan(list, cy + dy, cx + lo, cx + hi) == -1) return -1;
+            }
+        } else {
+            // Strictly inside the sector going from the end ray back to the start ray
+            int gapLo = lo, gapHi = hi;
+            if (clipHalfPlane(-ey, ex * dy, true, &gapLo, &gapHi) && clipHalfPlane(sy, -sx * dy, true, &gapLo, &gapHi)) {
+                if (pushSpan(list, cy + dy, cx + lo, cx + gapLo - 1) == -1) return -1;
+                if (pushSpan(list, cy + dy, cx + gapHi + 1, cx + hi) == -1) return -1;
+            } else if (pushSpan(list, cy + dy, cx + lo, cx + hi) == -1) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Appends the rows of a filled convex polygon.
+ *
+ * Pixel centers sit on integer coordinates and follow a top-left rule: a pixel on
+ * the left or top edge is in, one on the right or bottom edge is out, so polygons
+ * sharing an edge never fill a pixel twice.
+ *
+ * @param points Vertices in order, clockwise or not.
+ * @return 0 on success, -1 if the list could not grow.
+ */
+int pushConvexSpans(SpanList *list, const SDL_FPoint *points, int count) {
+    if (count < 3) return 0;
+
+    float minY = points[0].y, maxY = points[0].y;
+    for (int i = 1; i < count; i++) {
+        minY = SDL_min(minY, points[i].y);
+        maxY = SDL_max(maxY, points[i].y);
+    }
+
+    for (int y = (int)ceil(minY); y < maxY; y++) {
+        double left = INFINITY, right = -INFINITY;
+
+        // A convex polygon crosses each row on exactly two non-horizontal edges
+        for (int i = 0; i < count; i++) {
+            SDL_FPoint a = points[i], b = points[(i + 1) % count];
+            if ((a.y <= y && b.y > y) || (b.y <= y && a.y > y)) {
+                double x = a.x + (y - a.y) * (double)(b.x - a.x) / (b.y - a.y);
+                left = SDL_min(left, x);
+                right = SDL_max(right, x);
+            }
+        }
+        if (left > right) continue;
+        if (pushSpan(list, y, (int)ceil(left - SPAN_EPSILON), (int)ceil(right - SPAN_EPSILON) - 1) == -1) return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Appends the rows of a filled rectangle turned around its center.
+ *
+ * @param cx X-coordinate of the center.
+ * @param cy Y-coordinate of the center.
+ * @param w Width before the rotation.
+ * @param h Height before the rotation.
+ * @param angle Rotation in degrees, clockwise on screen.
+ * @return 0 on success, -1 if the list could not grow.
+ */
+int pushRotatedRectSpans(SpanList *list, float cx, float cy, float w, float h, float angle) {
+    double rad = angle * M_PI / 180.0;
+    double c = cos(rad), s = sin(rad);
+    double hw = w / 2.0, hh = h / 2.0;
+
+    SDL_FPoint corners[4];
+    const double signs[4][2] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+    for (int i = 0; i < 4; i++) {
+        double x = signs[i][0] * hw, y = signs[i][1] * hh;
+        corners[i].x = (float)(cx + x * c - y * s);
+        corners[i].y = (float)(cy + x * s + y * c);
+    }
+    return pushConvexSpans(list, corners, 4);
+}
+
+/**
+ * @brief Tells if a polygon is convex: it always turns the same way and goes
+ *        up and down only once, which rules out stars.
+ */
+bool isConvexPolygon(const SDL_FPoint *points, int count) {
+    if (count < 3) return false;
+
+    int turn = 0, flips = 0, direction = 0;
+    for (int i = 0; i < count; i++) {
+        SDL_FPoint a = points[i], b = points[(i + 1) % count], c = points[(i + 2) % count];
+        double cross = (double)(b.x - a.x) * (c.y - b.y) - (double)(b.y - a.y) * (c.x - b.x);
+        int sign = (cross > 0) - (cross < 0);
+        if (sign != 0) {
+            if (turn != 0 && sign != turn) return false;
+            turn = sign;
+        }
+
+        int edge = (b.y > a.y) - (b.y < a.y);
+        if (edge != 0) {
+            if (direction != 0 && edge != direction) flips++;
+            direction = edge;
+        }
+    }
+    return turn != 0 && flips <= 2;
+}
+
+// Span writers, one per instruction set, all storing the same packed pixel
+
+static void writeSpanScalar(Uint32 *row, int count, Uint32 pixel) {
+    for (int i = 0; i < count; i++) {
+        row[i] = pixel;
+    }
+}
+
+#ifdef KERNELS_X86
+
+TARGET_SSE2 static void writeSpanSSE2(Uint32 *row, int count, Uint32 pixel) {
+    const __m128i v = _mm_set1_epi32((int)pixel);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm_storeu_si128((__m128i *)(row + i), v);
+        _mm_storeu_si128((__m128i *)(row + i + 4), v);
+    }
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_si128((__m128i *)(row + i), v);
+    }
+    writeSpanScalar(row + i, count - i, pixel);
+}
+
+TARGET_AVX2 static void writeSpanAVX2(Uint32 *row, int count, Uint32 pixel) {
+    const __m256i v = _mm256_set1_epi32((int)pixel);
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        _mm256_storeu_si256((__m256i *)(row + i), v);
+        _mm256_storeu_si256((__m256i *)(row + i + 8), v);
+    }
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_si256((__m256i *)(row + i), v);
+    }
+    writeSpanScalar(row + i, count - i, pixel);
+}
+
+#endif // KERNELS_X86
+
+static const SpanWriter writerTable[] = {
+    [KERNEL_SCALAR] = writeSpanScalar,
+#ifdef KERNELS_X86
+    [KERNEL_SSE2] = writeSpanSSE2,
+    [KERNEL_AVX2] = writeSpanAVX2,
+#endif
+};
+
+/**
+ * @brief Selects the span writer used by fillSpans, see selectKernelLevel.
+ *
+ * @param level The requested instruction set.
+ * @return The level actually selected.
+ */
+KernelLevel setSpanKernels(KernelLevel level) {
+    return selectKernelLevel(&spanKernels, level);
+}
+
+/**
+ * @brief Returns the level of the span writer in use, selecting the fastest one on first use.
+ */
+KernelLevel getSpanKernelLevel(void) {
+    return getSelectedKernelLevel(&spanKernels);
+}
+
+/**
+ * @brief Makes sure the stamp texture holds at least width x height pixels for this renderer.
+ *
+ * @return 0 on success, -1 if the texture could not be created.
+ */
+static int reserveStamp(SDL_Renderer *renderer, int width, int height) {
+    if (stamp && renderer == stampRenderer && width <= stampWidth && height <= stampHeight) return 0;
+
+    // Grow by whole blocks and never shrink, so shapes of varying sizes reuse the texture
+    if (renderer == stampRenderer) {
+        width = SDL_max(width, stampWidth);
+        height = SDL_max(height, stampHeight);
+    }
+    width = (width + STAMP_BLOCK - 1) / STAMP_BLOCK * STAMP_BLOCK;
+    height = (height + STAMP_BLOCK - 1) / STAMP_BLOCK * STAMP_BLOCK;
+    freeSpanFill();
+
+    stamp = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING, width, height);
+    if (!stamp) {
+        printf("%sExecutionError: Failed to create the span fill texture: %s\n", RED_COLOR, SDL_GetError());
+        return -1;
+    }
+    SDL_SetTextureBlendMode(stamp, SDL_BLENDMODE_BLEND);
+    stampRenderer = renderer;
+    stampWidth = width;
+    stampHeight = height;
+    return 0;
+}
+
+/**
+ * @brief Fills spans with one color on the current render target.
+ *
+ * The spans are written into a locked streaming texture covering their bounds, then
+ * blended in a single copy, so a shape costs one draw call whatever its size. The
+ * spans must not overlap, each pixel is blended once.
+ *
+ * @param renderer The renderer to draw with, its render target is kept.
+ * @param spans Spans to fill, in any order.
+ * @param count Number of spans.
+ * @param color Fill color, blended like SDL_BLENDMODE_BLEND.
+ * @return 0 on success, -1 if the texture could not be created or locked.
+ */
+int fillSpans(SDL_Renderer *renderer, const FillSpan *spans, int count, SDL_Color color) {
+    if (count <= 0) return 0;
+
+    int targetWidth, targetHeight;
+    SDL_Texture *target = SDL_GetRenderTarget(renderer);
+    if (!target || SDL_QueryTexture(target, NULL, NULL, &targetWidth, &targetHeight) != 0) {
+        SDL_GetRendererOutputSize(renderer, &targetWidth, &targetHeight);
+    }
+
+    // Bounds of the spans, clipped to the target
+    int minX = spans[0].x1, maxX = spans[0].x2, minY = spans[0].y, maxY = spans[0].y;
+    for (int i = 1; i < count; i++) {
+        minX = SDL_min(minX, spans[i].x1);
+        maxX = SDL_max(maxX, spans[i].x2);
+        minY = SDL_min(minY, spans[i].y);
+        maxY = SDL_max(maxY, spans[i].y);
+    }
+    SDL_Rect output = {0, 0, targetWidth, targetHeight};
+    SDL_Rect bounds = {minX, minY, maxX - minX + 1, maxY - minY + 1};
+    if (!SDL_IntersectRect(&bounds, &output, &bounds)) return 0;
+
+    if (reserveStamp(renderer, bounds.w, bounds.h) != 0) return -1;
+
+    void *locked;
+    int pitch;
+    SDL_Rect source = {0, 0, bounds.w, bounds.h};
+    if (SDL_LockTexture(stamp, &source, &locked, &pitch) != 0) {
+        printf("%sExecutionError: Failed to lock the span fill texture: %s\n", RED_COLOR, SDL_GetError());
+        return -1;
+    }
+
+    // Locked pixels are undefined, everything outside the spans must stay transparent
+    for (int y = 0; y < bounds.h; y++) {
+        memset((Uint8 *)locked + (size_t)y * pitch, 0, bounds.w * sizeof(Uint32));
+    }
+
+    SpanWriter write = writerTable[getSpanKernelLevel()];
+    Uint32 pixel = ((Uint32)color.r << 24) | ((Uint32)color.g << 16) | ((Uint32)color.b << 8) | color.a;
+    for (int i = 0; i < count; i++) {
+        int y = spans[i].y - bounds.y;
+        int x1 = SDL_max(spans[i].x1, bounds.x), x2 = SDL_min(spans[i].x2, bounds.x + bounds.w - 1);
+        if (y < 0 || y >= bounds.h || x1 > x2) continue;
+        Uint32 *row = (Uint32 *)((Uint8 *)locked + (size_t)y * pitch);
+        write(row + (x1 - bounds.x), x2 - x1 + 1, pixel);
+    }
+
+    SDL_UnlockTexture(stamp);
+    SDL_RenderCopy(renderer, stamp, &source, &bounds);
+    return 0;
+}
+
+/**
+ * @brief Releases the span fill texture.
+ *
+ * Must be called before the renderer is destroyed.
+ */
+void freeSpanFill(void) {
+    if (stamp) SDL_DestroyTexture(stamp);
+    stamp = NULL;
+    stampRenderer = NULL;
+    stampWidth = 0;
+    stampHeight = 0;
+}
@@ -0,0 +1,285 @@
+#include "../files.h/spatialGrid.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ANSI escape codes for colors
+#define RED_COLOR "-#red "
+
+/**
+ * @brief Prepares an empty grid. No memory is allocated until the first box is added.
+ *
+ * @param grid The grid to initialize.
+ * @param cellSize Side of a cell in pixels.
+ */
+void initSpatialGrid(SpatialGrid *grid, int cellSize) {
+    memset(grid, 0, sizeof(SpatialGrid));
+    grid->cellSize = cellSize > 0 ? cellSize : GRID_CELL_SIZE;
+}
+
+/**
+ * @brief Cell coordinate of a pixel coordinate, rounding towards negative infinity.
+ */
+static int toCell(const SpatialGrid *grid, int v) {
+    return (v >= 0) ? v / grid->cellSize : -((-v + grid->cellSize - 1) / grid->cellSize);
+}
+
+static GridList* getBucket(const SpatialGrid *grid, int cx, int cy) {
+    Uint32 hash = ((Uint32)cx * 73856093u) ^ ((Uint32)cy * 19349663u);
+    return &grid->buckets[hash & (Uint32)(grid->bucketCount - 1)];
+}
+
+static int pushKey(GridList *list, Uint32 key) {
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 4;
+        Uint32 *keys = realloc(list->keys, capacity * sizeof(Uint32));
+        if (!keys) return -1;
+        list->keys = keys;
+        list->capacity = capacity;
+    }
+    list->keys[list->count++] = key;
+    return 0;
+}
+
+/**
+ * @brief Removes one occurrence of a key from a list, without keeping the order.
+ *
+ * @return true if the key was found.
+ */
+static bool dropKey(GridList *list, Uint32 key) {
+    for (int i = 0; i < list->count; i++) {
+        if (list->keys[i] == key) {
+            list->keys[i] = list->keys[--list->count];
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Adds a key to every cell of its entry, or to the oversized list.
+ */
+static int insertEntry(SpatialGrid *grid, Uint32 key) {
+    GridEntry *entry = &grid->entries[key];
+    if (entry->oversized) return pushKey(&grid->oversized, key);
+
+    for (int cy = entry->minCY; cy <= entry->maxCY; cy++) {
+        for (int cx = entry->minCX; cx <= entry->maxCX; cx++) {
+            if (pushKey(getBucket(grid, cx, cy), key) != 0) return -1;
+            grid->cellEntries++;
+        }
+    }
+    return 0;
+}
+
+static void eraseEntry(SpatialGrid *grid, Uint32 key) {
+    GridEntry *entry = &grid->entries[key];
+    if (entry->oversized) {
+        dropKey(&grid->oversized, key);
+        return;
+    }
+
+    for (int cy = entry->minCY; cy <= entry->maxCY; cy++) {
+        for (int cx = entry->minCX; cx <= entry->maxCX; cx++) {
+            if (dropKey(getBucket(grid, cx, cy), key)) grid->cellEntries--;
+        }
+    }
+}
+
+/**
+ * @brief Changes the number of buckets and redistributes every stored key.
+ *
+ * @return 0 on success, -1 if memory ran out. The grid is unchanged if the buckets could
+ *         not be allocated, otherwise the keys that did not fit are missing from it.
+ */
+static int resizeBuckets(SpatialGrid *grid, int bucketCount) {
+    GridList *buckets = calloc(bucketCount, sizeof(GridList));
+    if (!buckets) return -1;
+
+    GridList *old = grid->buckets;
+    int oldCount = grid->bucketCount;
+    grid->buckets = buckets;
+    grid->bucketCount = bucketCount;
+    grid->cellEntries = 0;
+
+    for (int b = 0; b < oldCount; b++) {
+        free(old[b].keys);
+    }
+    free(old);
+
+    for (int key = 0; key < grid->entryCapacity; key++) {
+        GridEntry *entry = &grid->entries[key];
+        if (entry->inserted && !entry->oversized && insertEntry(grid, (Uint32)key) != 0) return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Inserts a box or moves it to its new position.
+ *
+ * Only the cells the box enters or leaves are touched, so moving a shape inside its
+ * cells costs nothing but the box update.
+ *
+ * @param grid The grid.
+ * @param key Identifier of the box.
+ * @param minX,minY,maxX,maxY The box in pixels, inclusive.
+ * @return 0 on success, -1 on allocation failure (the key is then left out of the grid).
+ */
+int updateGridBox(SpatialGrid *grid, Uint32 key, int minX, int minY, int maxX, int maxY) {
+    if ((int)key >= grid->entryCapacity) {
+        int capacity = grid->entryCapacity ? grid->entryCapacity : 64;
+        while (capacity <= (int)key) capacity *= 2;
+        GridEntry *entries = realloc(grid->entries, capacity * sizeof(GridEntry));
+        if (!entries) {
+            printf("%sExecutionError: Memory allocation failed for the spatial grid\n", RED_COLOR);
+            return -1;
+        }
+        memset(entries + grid->entryCapacity, 0, (capacity - grid->entryCapacity) * sizeof(GridEntry));
+        grid->entries = entries;
+        grid->entryCapacity = capacity;
+    }
+    if (grid->cellSize <= 0) grid->cellSize = GRID_CELL_SIZE;  // Zero-initialized grid
+    if (!grid->buckets && resizeBuckets(grid, GRID_INITIAL_BUCKETS) != 0) {
+        printf("%sExecutionError: Memory allocation failed for the spatial grid\n", RED_COLOR);
+        return -1;
+    }
+
+    if (minX > maxX) { int t = minX; minX = maxX; maxX = t; }
+    if (minY > maxY) { int t = minY; minY = maxY; maxY = t; }
+
+    GridEntry *entry = &grid->entries[key];
+    int minCX = toCell(grid, minX), minCY = toCell(grid, minY);
+    int maxCX = toCell(grid, maxX), maxCY = toCell(grid, maxY);
+
+    entry->minX = minX; entry->minY = minY;
+    entry->maxX = maxX; entry->maxY = maxY;
+    if (entry->inserted && minCX == entry->minCX && minCY == entry->minCY &&
+        maxCX == entry->maxCX && maxCY == entry->maxCY) {
+        return 0;
+    }
+
+    if (entry->inserted) eraseEntry(grid, key);
+    entry->minCX = minCX; entry->minCY = minCY;
+    entry->maxCX = maxCX; entry->maxCY = maxCY;
+    entry->oversized = (Sint64)(maxCX - minCX + 1) * (maxCY - minCY + 1) > GRID_MAX_CELLS;
+    entry->inserted = true;
+
+    if (insertEntry(grid, key) != 0) {
+        printf("%sExecutionError: Memory allocation failed for the spatial grid\n", RED_COLOR);
+        eraseEntry(grid, key);
+        entry->inserted = false;
+        return -1;
+    }
+
+    // Keep about two keys per bucket
+    if (grid->cellEntries > grid->bucketCount * 2) {
+        resizeBuckets(grid, grid->bucketCount * 2);
+    }
+    return 0;
+}
+
+/**
+ * @brief Removes a key from the grid. Unknown keys are ignored.
+ */
+void removeGridBox(SpatialGrid *grid, Uint32 key) {
+    if ((int)key >= grid->entryCapacity || !grid->entries[key].inserted) return;
+    eraseEntry(grid, key);
+    grid->entries[key].inserted = false;
+}
+
+/**
+ * @brief Appends a key to the results if its box overlaps the query box and it was not returned yet.
+ */
+static void collectKey(SpatialGrid *grid, Uint32 key, int minX, int minY, int maxX, int maxY) {
+    GridEntry *entry = &grid->entries[key];
+    if (entry->stamp == grid->stamp) return;
+    if (maxX < entry->minX || minX > entry->maxX || maxY < entry->minY || minY > entry->maxY) return;
+    entry->stamp = grid->stamp;
+    pushKey(&grid->results, key);
+}
+
+/**
+ * @brief Starts a query: empties the results and marks every key as not returned yet.
+ */
+static void beginQuery(SpatialGrid *grid) {
+    grid->results.count = 0;
+    if (++grid->stamp == 0) {
+        for (int key = 0; key < grid->entryCapacity; key++) grid->entries[key].stamp = 0;
+        grid->stamp = 1;
+    }
+}
+
+/**
+ * @brief Returns the keys whose box contains a point.
+ *
+ * Only the bucket of the point's cell and the oversized boxes are looked at. Each key
+ * is returned once, in no particular order.
+ *
+ * @param grid The grid.
+ * @param x,y The point in pixels.
+ * @param keys Receives the keys, valid until the next query or update.
+ * @return The number of keys.
+ */
+int queryGridPoint(SpatialGrid *grid, int x, int y, const Uint32 **keys) {
+    beginQuery(grid);
+    if (grid->buckets) {
+        GridList *bucket = getBucket(grid, toCell(grid, x), toCell(grid, y));
+        for (int i = 0; i < bucket->count; i++) collectKey(grid, bucket->keys[i], x, y, x, y);
+        for (int i = 0; i < grid->oversized.count; i++) collectKey(grid, grid->oversized.keys[i], x, y, x, y);
+    }
+
+    *keys = grid->results.keys;
+    return grid->results.count;
+}
+
+/**
+ * @brief Returns the keys whose box overlaps a query box.
+ *
+ * Looks at the buckets of every cell the query covers, so it is meant for boxes about
+ * the size of a cell. Each key is returned once, in no particular order.
+ *
+ * @param grid The grid.
+ * @param minX,minY,maxX,maxY The query box in pixels, inclusive.
+ * @param keys Receives the keys, valid until the next query or update.
+ * @return The number of keys.
+ */
+int queryGridBox(SpatialGrid *grid, int minX, int minY, int maxX, int maxY, const Uint32 **keys) {
+    beginQuery(grid);
+    if (grid->buckets) {
+        for (int cy = toCell(grid, minY); cy <= toCell(grid, maxY); cy++) {
+            for (int cx = toCell(grid, minX); cx <= toCell(grid, maxX); cx++) {
+                GridList *bucket = getBucket(grid, cx, cy);
+                for (int i = 0; i < bucket->count; i++) collectKey(grid, bucket->keys[i], minX, minY, maxX, maxY);
+            }
+        }
+        for (int i = 0; i < grid->oversized.count; i++) {
+            collectKey(grid, grid->oversized.keys[i], minX, minY, maxX, maxY);
+        }
+    }
+
+    *keys = grid->results.keys;
+    return grid->results.count;
+}
+
+/**
+ * @brief Removes every key, keeping the memory for reuse.
+ */
+void clearSpatialGrid(SpatialGrid *grid) {
+    for (int b = 0; b < grid->bucketCount; b++) grid->buckets[b].count = 0;
+    for (int key = 0; key < grid->entryCapacity; key++) grid->entries[key].inserted = false;
+    grid->oversized.count = 0;
+    grid->results.count = 0;
+    grid->cellEntries = 0;
+}
+
+/**
+ * @brief Releases the memory of the grid and leaves it empty.
+ */
+void freeSpatialGrid(SpatialGrid *grid) {
+    for (int b = 0; b < grid->bucketCount; b++) free(grid->buckets[b].keys);
+    free(grid->buckets);
+    free(grid->entries);
+    free(grid->oversized.keys);
+    free(grid->results.keys);
+    initSpatialGrid(grid, grid->cellSize);
+}
@@ -0,0 +1,356 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include "../files.h/text.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ANSI escape codes for colors
+#define RED_COLOR "-#red "
+
+#define FIRST_GLYPH 32          // ' '
+#define LAST_GLYPH 126          // '~'
+#define GLYPH_COUNT (LAST_GLYPH - FIRST_GLYPH + 1)
+#define ATLAS_WIDTH 512
+#define LAYOUT_CACHE_SIZE 32    // Laid out strings kept between frames
+#define LAYOUT_TEXT_MAX 256     // Longer strings are laid out but never cached
+
+// Position of one glyph in the atlas
+typedef struct {
+    SDL_Rect src;
+    int advance;
+} Glyph;
+
+// One glyph of a laid out string, relative to the string's top-left corner
+typedef struct {
+    SDL_Rect src;
+    SDL_Rect dst;
+} TextQuad;
+
+// A string laid out for a given scale and wrap width. Used both for the cache and
+// as scratch space for strings too long to be cached.
+typedef struct {
+    char text[LAYOUT_TEXT_MAX];
+    float scale;
+    int wrapWidth;
+    bool used;
+    int width;
+    int height;
+    TextQuad *quads;
+    int quadCount;
+    int quadCapacity;
+} TextLayout;
+
+static SDL_Texture *atlas = NULL;
+static Glyph glyphs[GLYPH_COUNT];
+static int lineSkip = 0;
+static int lineHeight = 0;
+
+static TextLayout layoutCache[LAYOUT_CACHE_SIZE];
+static int nextLayout = 0;      // Round-robin eviction cursor
+static TextLayout scratchLayout;
+
+static SDL_Vertex *vertices = NULL;
+static int *indices = NULL;
+static int vertexCapacity = 0;
+
+/**
+ * @brief Rasterizes the printable ASCII glyphs of a font into a single texture.
+ *
+ * Glyphs are rendered white so that any text color can be applied at draw time.
+ * Must be called once the renderer and font exist; calling it again rebuilds the atlas.
+ *
+ * @param renderer The renderer that will own the atlas texture.
+ * @param font The font to rasterize.
+ * @return 0 on success, -1 on failure.
+ */
+int initTextAtlas(SDL_Renderer *renderer, TTF_Font *font) {
+    if (!renderer || !font) return -1;
+    freeTextAtlas();
+
+    SDL_Color white = {255, 255, 255, 255};
+    SDL_Surface *rendered[GLYPH_COUNT] = {NULL};
+
+    // Shelf-pack the glyphs in rows of ATLAS_WIDTH pixels
+    int x = 0, y = 0, rowHeight = 0;
+    for (int i = 0; i < GLYPH_COUNT; i++) {
+        Uint16 ch = (Uint16)(FIRST_GLYPH + i);
+        int minx, maxx, miny, maxy, advance;
+        if (TTF_GlyphMetrics(font, ch, &minx, &maxx, &miny, &maxy, &advance) < 0) {
+            advance = 0;
+        }
+
+        rendered[i] = TTF_RenderGlyph_Blended(font, ch, white);
+        if (!rendered[i]) {
+            glyphs[i].src = (SDL_Rect){0, 0, 0, 0};
+            glyphs[i].advance = advance;
+            continue;
+        }
+
+        int w = rendered[i]->w, h = rendered[i]->h;
+        if (x + w > ATLAS_WIDTH) {
+            x = 0;
+            y += rowHeight + 1;
+            rowHeight = 0;
+        }
+        glyphs[i].src = (SDL_Rect){x, y, w, h};
+        glyphs[i].advance = advance > 0 ? advance : w;
+        x += w + 1;
+        if (h > rowHeight) rowHeight = h;
+    }
+
+    SDL_Surface *sheet = SDL_CreateRGBSurfaceWithFormat(0, ATLAS_WIDTH, y + rowHeight, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!sheet) {
+        printf("%sExecutionError: Failed to create glyph atlas: %s\n", RED_COLOR, SDL_GetError());
+        for (int i = 0; i < GLYPH_COUNT; i++) SDL_FreeSurface(rendered[i]);
+        return -1;
+    }
+    SDL_FillRect(sheet, NULL, 0);
+
+    for (int i = 0; i < GLYPH_COUNT; i++) {
+        if (!rendered[i]) continue;
+        // Copy the glyph's alpha as-is instead of blending it onto the empty sheet
+        SDL_SetSurfaceBlendMode(rendered[i], SDL_BLENDMODE_NONE);
+        SDL_Rect dst = glyphs[i].src;
+        SDL_BlitSurface(rendered[i], NULL, sheet, &dst);
+        SDL_FreeSurface(rendered[i]);
+    }
+
+    atlas = SDL_CreateTextureFromSurface(renderer, sheet);
+    SDL_FreeSurface(sheet);
+    if (!atlas) {
+        printf("%sExecutionError: Failed to create glyph atlas texture: %s\n", RED_COLOR, SDL_GetError());
+        return -1;
+    }
+    SDL_SetTextureBlendMode(atlas, SDL_BLENDMODE_BLEND);
+
+    lineSkip = TTF_FontLineSkip(font);
+    lineHeight = TTF_FontHeight(font);
+    return 0;
+}
+
+/**
+ * @brief Releases the atlas texture and every cached layout.
+ */
+void freeTextAtlas(void) {
+    if (atlas) SDL_DestroyTexture(atlas);
+    atlas = NULL;
+
+    for (int i = 0; i < LAYOUT_CACHE_SIZE; i++) {
+        free(layoutCache[i].quads);
+    }
+    free(scratchLayout.quads);
+    memset(layoutCache, 0, sizeof(layoutCache));
+    memset(&scratchLayout, 0, sizeof(scratchLayout));
+    nextLayout = 0;
+
+    free(vertices);
+    free(indices);
+    vertices = NULL;
+    indices = NULL;
+    vertexCapacity = 0;
+}
+
+/**
+ * @brief Returns the atlas entry for a character, non-printable ones map to '?'.
+ */
+static const Glyph* getGlyph(char c) {
+    unsigned char ch = (unsigned char)c;
+    if (ch < FIRST_GLYPH || ch > LAST_GLYPH) ch = '?';
+    return &glyphs[ch - FIRST_GLYPH];
+}
+
+/**
+ * @brief Width in unscaled pixels of text[start..end).
+ */
+static int measureRun(const char *text, int start, int end) {
+    int width = 0;
+    for (int i = start; i < end; i++) {
+        width += getGlyph(text[i])->advance;
+    }
+    return width;
+}
+
+/**
+ * @brief Appends the glyphs of text[start..end) as one line of the layout.
+ */
+static void layoutLine(TextLayout *layout, const char *text, int start, int end, int line) {
+    int penX = 0;
+    int penY = line * lineSkip;
+
+    for (int i = start; i < end; i++) {
+        const Glyph *glyph = getGlyph(text[i]);
+        if (glyph->src.w > 0 && text[i] != ' ') {
+            if (layout->quadCount == layout->quadCapacity) {
+                int capacity = layout->quadCapacity ? layout->quadCapacity * 2 : 64;
+                TextQuad *grown = realloc(layout->quads, capacity * sizeof(TextQuad));
+                if (!grown) return;
+                layout->quads = grown;
+                layout->quadCapacity = capacity;
+            }
+            TextQuad *quad = &layout->quads[layout->quadCount++];
+            quad->src = glyph->src;
+            quad->dst = (SDL_Rect){
+                (int)(penX * layout->scale), (int)(penY * layout->scale),
+                (int)(glyph->src.w * layout->scale), (int)(glyph->src.h * layout->scale)
+            };
+        }
+        penX += glyph->advance;
+    }
+
+    int width = (int)(penX * layout->scale);
+    if (width > layout->width) layout->width = width;
+}
+
+/**
+ * @brief Lays out a string, honouring '\n' and breaking lines on spaces once they
+ *        get wider than wrapWidth (0 disables wrapping).
+ */
+static void layoutText(TextLayout *layout, const char *text, float scale, int wrapWidth) {
+    layout->scale = scale;
+    layout->wrapWidth = wrapWidth;
+    layout->width = 0;
+    layout->quadCount = 0;
+
+    int line = 0;
+    int lineStart = 0;
+    while (1) {
+        int lineEnd = lineStart;
+        while (text[lineEnd] != '\0' && text[lineEnd] != '\n') lineEnd++;
+
+        if (wrapWidth > 0) {
+            // Greedy word wrap within the hard line
+            int start = lineStart;
+            while (measureRun(text, start, lineEnd) > wrapWidth) {
+                int breakAt = -1;
+                for (int i = start + 1; i < lineEnd; i++) {
+                    if (text[i] != ' ') continue;
+                    if (breakAt >= 0 && measureRun(text, start, i) > wrapWidth) break;
+                    breakAt = i;
+                }
+                if (breakAt < 0) break;   // Single word wider than the wrap width
+                layoutLine(layout, text, start, breakAt, line++);
+                start = breakAt + 1;
+            }
+            layoutLine(layout, text, start, lineEnd, line++);
+        } else {
+            layoutLine(layout, text, lineStart, lineEnd, line++);
+        }
+
+        if (text[lineEnd] == '\0') break;
+        lineStart = lineEnd + 1;
+    }
+
+    layout->height = (int)(((line - 1) * lineSkip + lineHeight) * scale);
+}
+
+/**
+ * @brief Returns the layout of a string, reusing a cached one when possible.
+ */
+static TextLayout* getLayout(const char *text, float scale, int wrapWidth) {
+    if (strlen(text) >= LAYOUT_TEXT_MAX) {
+        layoutText(&scratchLayout, text, scale, wrapWidth);
+        return &scratchLayout;
+    }
+
+    for (int i = 0; i < LAYOUT_CACHE_SIZE; i++) {
+        TextLayout *layout = &layoutCache[i];
+        if (layout->used && layout->scale == scale && layout->wrapWidth == wrapWidth &&
+            strcmp(layout->text, text) == 0) {
+            return layout;
+        }
+    }
+
+    TextLayout *layout = &layoutCache[nextLayout];
+    nextLayout = (nextLayout + 1) % LAYOUT_CACHE_SIZE;
+    strcpy(layout->text, text);
+    layout->used = true;
+    layoutText(layout, text, scale, wrapWidth);
+    return layout;
+}
+
+/**
+ * @brief Computes the size a string would have once rendered.
+ *
+ * @param text The string to measure.
+ * @param scale Size multiplier applied to the font.
+ * @param wrapWidth Wrap width in unscaled font pixels, 0 to disable wrapping.
+ * @param w Receives the width in pixels (may be NULL).
+ * @param h Receives the height in pixels (may be NULL).
+ */
+void getTextSize(const char *text, float scale, int wrapWidth, int *w, int *h) {
+    if (w) *w = 0;
+    if (h) *h = 0;
+    if (!atlas || !text) return;
+
+    TextLayout *layout = getLayout(text, scale, wrapWidth);
+    if (w) *w = layout->width;
+    if (h) *h = layout->height;
+}
+
+/**
+ * @brief Draws a string with its top-left corner at (x, y) in a single batch.
+ *
+ * @param renderer The renderer that owns the atlas.
+ * @param text The string to draw.
+ * @param x Left edge in pixels.
+ * @param y Top edge in pixels.
+ * @param color Text color.
+ * @param scale Size multiplier applied to the font.
+ * @param wrapWidth Wrap width in unscaled font pixels, 0 to disable wrapping.
+ */
+void renderText(SDL_Renderer *renderer, const char *text, int x, int y, SDL_Color color, float scale, int wrapWidth) {
+    if (!atlas || !text) return;
+
+    TextLayout *layout = getLayout(text, scale, wrapWidth);
+    if (layout->quadCount == 0) return;
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    if (layout->quadCount * 4 > vertexCapacity) {
+        int capacity = vertexCapacity ? vertexCapacity : 256;
+        while (capacity < layout->quadCount * 4) capacity *= 2;
+        SDL_Vertex *grownVertices = realloc(vertices, capacity * sizeof(SDL_Vertex));
+        if (!grownVertices) return;
+        vertices = grownVertices;
+        int *grownIndices = realloc(indices, capacity / 4 * 6 * sizeof(int));
+        if (!grownIndices) return;
+        indices = grownIndices;
+        vertexCapacity = capacity;
+    }
+
+    int atlasW, atlasH;
+    SDL_QueryTexture(atlas, NULL, NULL, &atlasW, &atlasH);
+
+    for (int i = 0; i < layout->quadCount; i++) {
+        const TextQuad *quad = &layout->quads[i];
+        float left = (float)(x + quad->dst.x), top = (float)(y + quad->dst.y);
+        float right = left + quad->dst.w, bottom = top + quad->dst.h;
+        float u0 = (float)quad->src.x / atlasW, v0 = (float)quad->src.y / atlasH;
+        float u1 = (float)(quad->src.x + quad->src.w) / atlasW, v1 = (float)(quad->src.y + quad->src.h) / atlasH;
+
+        SDL_Vertex *v = &vertices[i * 4];
+        v[0] = (SDL_Vertex){{left, top}, color, {u0, v0}};
+        v[1] = (SDL_Vertex){{right, top}, color, {u1, v0}};
+        v[2] = (SDL_Vertex){{right, bottom}, color, {u1, v1}};
+        v[3] = (SDL_Vertex){{left, bottom}, color, {u0, v1}};
+
+        int *index = &indices[i * 6];
+        index[0] = i * 4;     index[1] = i * 4 + 1; index[2] = i * 4 + 2;
+        index[3] = i * 4;     index[4] = i * 4 + 2; index[5] = i * 4 + 3;
+    }
+
+    SDL_RenderGeometry(renderer, atlas, vertices, layout->quadCount * 4, indices, layout->quadCount * 6);
+#else
+    // No SDL_RenderGeometry: one copy per glyph, still from the shared atlas
+    SDL_SetTextureColorMod(atlas, color.r, color.g, color.b);
+    SDL_SetTextureAlphaMod(atlas, color.a);
+    for (int i = 0; i < layout->quadCount; i++) {
+        SDL_Rect dst = layout->quads[i].dst;
+        dst.x += x;
+        dst.y += y;
+        SDL_RenderCopy(renderer, atlas, &layout->quads[i].src, &dst);
+    }
+#endif
+}
@@ -0,0 +1,468 @@
+#include "../files.h/vm.h"
+#include "../files.h/colors.h"
+#include "../files.h/form.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ANSI escape codes for colors
+#define RED_COLOR "-#red "
+
+#define BYTECODE_HEADER_SIZE 72
+
+typedef enum {
+    VALUE_INT,
+    VALUE_FLOAT,
+    VALUE_STRING
+} ValueType;
+
+// Value of a variable or of an expression, with the type the C translation would give it
+typedef struct {
+    ValueType type;
+    union {
+        int i;
+        double f;
+        const char *s;
+    } as;
+} Value;
+
+typedef struct {
+    const BytecodeFunction *function;
+    Uint32 returnAddress;
+    int base;                        // First slot of the frame in the stack
+} Frame;
+
+// Sequential little-endian reader over a byte buffer, failed is set on overrun
+typedef struct {
+    const Uint8 *bytes;
+    size_t size;
+    size_t offset;
+    bool failed;
+} ByteReader;
+
+// Shapes in the order of bytecode.py, with the number of integers drawShape takes after the color
+static const ShapeType shapeTypes[] = {SHAPE_CIRCLE, SHAPE_ELLIPSE, SHAPE_LINE, SHAPE_POLYGON, SHAPE_RECTANGLE, SHAPE_ARC, SHAPE_TRIANGLE, SHAPE_SQUARE};
+static const int shapeArgCounts[] = {3, 4, 5, 4, 4, 5, 3, 3};
+#define SHAPE_CODE_COUNT (int)(sizeof(shapeTypes) / sizeof(shapeTypes[0]))
+
+static const struct {
+    const char *name;
+    const SDL_Color *color;
+} namedColors[] = {
+    {"red", &red}, {"green", &green}, {"blue", &blue}, {"white", &white}, {"black", &black},
+    {"yellow", &yellow}, {"cyan", &cyan}, {"magenta", &magenta}, {"gray", &gray},
+    {"light_gray", &light_gray}, {"dark_gray", &dark_gray}, {"orange", &orange},
+    {"purple", &purple}, {"brown", &brown}, {"pink", &pink}, {"gold", &gold},
+    {"silver", &silver}, {"bronze", &bronze}
+};
+
+static bool canRead(ByteReader *reader, size_t size) {
+    if (reader->failed || reader->size - reader->offset < size) {
+        reader->failed = true;
+        return false;
+    }
+    return true;
+}
+
+static Uint8 readU8(ByteReader *reader) {
+    return canRead(reader, 1) ? reader->bytes[reader->offset++] : 0;
+}
+
+static Uint16 readU16(ByteReader *reader) {
+    Uint16 value = 0;
+    if (canRead(reader, 2)) {
+        memcpy(&value, reader->bytes + reader->offset, 2);
+        reader->offset += 2;
+    }
+    return SDL_SwapLE16(value);
+}
+
+static Uint32 readU32(ByteReader *reader) {
+    Uint32 value = 0;
+    if (canRead(reader, 4)) {
+        memcpy(&value, reader->bytes + reader->offset, 4);
+        reader->offset += 4;
+    }
+    return SDL_SwapLE32(value);
+}
+
+static Uint64 readU64(ByteReader *reader) {
+    Uint64 value = 0;
+    if (canRead(reader, 8)) {
+        memcpy(&value, reader->bytes + reader->offset, 8);
+        reader->offset += 8;
+    }
+    return SDL_SwapLE64(value);
+}
+
+static double readF64(ByteReader *reader) {
+    Uint64 bits = readU64(reader);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Reads a whole file into memory.
+ *
+ * @return The contents, to free, or NULL if the file cannot be read.
+ */
+static Uint8 *readFile(const char *path, size_t *size) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return NULL;
+
+    Uint8 *data = NULL;
+    long length = 0;
+    if (fseek(file, 0, SEEK_END) == 0 && (length = ftell(file)) > 0 && fseek(file, 0, SEEK_SET) == 0) {
+        data = malloc(length);
+        if (data && fread(data, 1, length, file) != (size_t)length) {
+            free(data);
+            data = NULL;
+        }
+    }
+    fclose(file);
+    *size = data ? (size_t)length : 0;
+    return data;
+}
+
+/**
+ * @brief Loads and validates a bytecode file.
+ *
+ * Function entries, slot counts and the layout are checked here, the
+ * operands are checked as they are executed by runBytecode.
+ *
+ * @param path File written by interpreter.py --bytecode.
+ * @param program Filled on success, release it with freeBytecode.
+ * @return 0 on success, -1 if the file is missing or invalid.
+ */
+int loadBytecode(const char *path, Bytecode *program) {
+    memset(program, 0, sizeof(*program));
+
+    size_t size;
+    program->data = readFile(path, &size);
+    if (!program->data) {
+        printf("%sExecutionError: Failed to read bytecode file %s.\n", RED_COLOR, path);
+        return -1;
+    }
+
+    ByteReader reader = {program->data, size, 0, false};
+    if (size < BYTECODE_HEADER_SIZE || memcmp(program->data, BYTECODE_MAGIC, 4) != 0) {
+        printf("%sExecutionError: %s is not a Draw++ bytecode file.\n", RED_COLOR, path);
+        freeBytecode(program);
+        return -1;
+    }
+    reader.offset = 4;
+    if (readU16(&reader) != BYTECODE_VERSION) {
+        printf("%sExecutionError: %s was compiled by another version of Draw++.\n", RED_COLOR, path);
+        freeBytecode(program);
+        return -1;
+    }
+    readU16(&reader);  // Reserved
+
+    program->programHash = readU64(&reader);
+    program->windowW = (int)readU32(&reader);
+    program->windowH = (int)readU32(&reader);
+    program->bgcolorR = (int)readU32(&reader);
+    program->bgcolorG = (int)readU32(&reader);
+    program->bgcolorB = (int)readU32(&reader);
+    program->cursorColor.r = (Uint8)readU32(&reader);
+    program->cursorColor.g = (Uint8)readU32(&reader);
+    program->cursorColor.b = (Uint8)readU32(&reader);
+    program->cursorColor.a = (Uint8)readU32(&reader);
+    program->cursorSize = (int)readU32(&reader);
+    program->drawBatch = (int)readU32(&reader);
+    Uint32 functionCount = readU32(&reader);
+    Uint32 stringCount = readU32(&reader);
+    program->codeSize = readU32(&reader);
+
+    // Every count is bounded by the file size before anything is allocated
+    bool valid = program->windowW > 0 && program->windowH > 0 && functionCount > 0 && stringCount > 0 &&
+                 functionCount <= size / sizeof(BytecodeFunction) && stringCount <= size / 2;
+    program->functions = valid ? calloc(functionCount, sizeof(BytecodeFunction)) : NULL;
+    program->strings = valid ? calloc(stringCount, sizeof(char *)) : NULL;
+    valid = program->functions && program->strings;
+
+    for (Uint32 i = 0; valid && i < functionCount; i++) {
+        BytecodeFunction *function = &program->functions[i];
+        function->entry = readU32(&reader);
+        function->paramCount = readU16(&reader);
+        function->slotCount = readU16(&reader);
+        valid = function->entry < program->codeSize && function->paramCount <= function->slotCount &&
+                function->slotCount < VM_STACK_SIZE;
+        program->functionCount++;
+    }
+    for (Uint32 i = 0; valid && i < stringCount; i++) {
+        Uint16 length = readU16(&reader);
+        valid = canRead(&reader, length) && (program->strings[i] = malloc(length + 1)) != NULL;
+        if (!valid) break;
+        memcpy(program->strings[i], reader.bytes + reader.offset, length);
+        program->strings[i][length] = '\0';
+        reader.offset += length;
+        program->stringCount++;
+    }
+
+    valid = valid && !reader.failed && size - reader.offset == program->codeSize;
+    if (!valid) {
+        printf("%sExecutionError: %s is corrupt.\n", RED_COLOR, path);
+        freeBytecode(program);
+        return -1;
+    }
+
+    program->code = program->data + reader.offset;
+    program->title = program->strings[0];
+    return 0;
+}
+
+/**
+ * @brief Releases a program loaded by loadBytecode.
+ */
+void freeBytecode(Bytecode *program) {
+    for (int i = 0; i < program->stringCount; i++) {
+        free(program->strings[i]);
+    }
+    free(program->strings);
+    free(program->functions);
+    free(program->data);
+    memset(program, 0, sizeof(*program));
+}
+
+static const SDL_Color *findColor(const char *name) {
+    for (size_t i = 0; i < sizeof(namedColors) / sizeof(namedColors[0]); i++) {
+        if (strcmp(namedColors[i].name, name) == 0) return namedColors[i].color;
+    }
+    return NULL;
+}
+
+static bool isTruthy(Value value) {
+    return value.type == VALUE_FLOAT ? value.as.f != 0 : value.as.i != 0;
+}
+
+static double asDouble(Value value) {
+    return value.type == VALUE_FLOAT ? value.as.f : value.as.i;
+}
+
+/**
+ * @brief Applies an arithmetic, comparison or logical opcode.
+ *
+ * Integers stay integers (with C division) unless one side is a float, like in
+ * the C translation.
+ *
+ * @return false if the operation is invalid (string operand, division by zero).
+ */
+static bool applyOperator(Opcode op, Value left, Value right, Value *result) {
+    if (left.type == VALUE_STRING || right.type == VALUE_STRING) return false;
+
+    if (op == OP_AND || op == OP_OR) {
+        bool value = op == OP_AND ? isTruthy(left) && isTruthy(right) : isTruthy(left) || isTruthy(right);
+        *result = (Value){VALUE_INT, {.i = value}};
+        return true;
+    }
+
+    if (left.type == VALUE_INT && right.type == VALUE_INT) {
+        // Wraps on overflow instead of the undefined behavior of signed arithmetic
+        Uint32 a = (Uint32)left.as.i, b = (Uint32)right.as.i;
+        switch (op) {
+            case OP_ADD: *result = (Value){VALUE_INT, {.i = (int)(a + b)}}; return true;
+            case OP_SUB: *result = (Value){VALUE_INT, {.i = (int)(a - b)}}; return true;
+            case OP_MUL: *result = (Value){VALUE_INT, {.i = (int)(a * b)}}; return true;
+            case OP_DIV:
+                if (b == 0) return false;
+                *result = (Value){VALUE_INT, {.i = right.as.i == -1 ? (int)(0 - a) : left.as.i / right.as.i}};
+                return true;
+            default: break;
+        }
+    }
+
+    double a = asDouble(left), b = asDouble(right);
+    switch (op) {
+        case OP_ADD: *result = (Value){VALUE_FLOAT, {.f = a + b}}; return true;
+        case OP_SUB: *result = (Value){VALUE_FLOAT, {.f = a - b}}; return true;
+        case OP_MUL: *result = (Value){VALUE_FLOAT, {.f = a * b}}; return true;
+        case OP_DIV: *result = (Value){VALUE_FLOAT, {.f = a / b}}; return true;
+        case OP_EQ: *result = (Value){VALUE_INT, {.i = a == b}}; return true;
+        case OP_NE: *result = (Value){VALUE_INT, {.i = a != b}}; return true;
+        case OP_LT: *result = (Value){VALUE_INT, {.i = a < b}}; return true;
+        case OP_GT: *result = (Value){VALUE_INT, {.i = a > b}}; return true;
+        case OP_LE: *result = (Value){VALUE_INT, {.i = a <= b}}; return true;
+        case OP_GE: *result = (Value){VALUE_INT, {.i = a >= b}}; return true;
+        default: return false;
+    }
+}
+
+/**
+ * @brief Draws one shape with the integers popped by OP_DRAW.
+ */
+static int drawFromBytecode(SDL_Renderer *renderer, SDL_Texture *mainTexture, int shape, Uint8 flags,
+                            SDL_Color color, const int *args) {
+    ShapeDesc desc = {0};
+    desc.shape = shapeTypes[shape];
+    desc.mode = (flags & DRAW_ANIMATED) ? DRAW_MODE_ANIMATED : DRAW_MODE_INSTANT;
+    desc.type = (flags & DRAW_FILLED) ? FORM_FILLED : FORM_EMPTY;
+    desc.color = color;
+    memcpy(desc.args, args, shapeArgCounts[shape] * sizeof(int));
+    return drawShapes(renderer, mainTexture, &desc, 1, DRAW_SHAPES_DEFAULT);
+}
+
+/**
+ * @brief Executes the main program of a loaded bytecode file.
+ *
+ * The draws go through drawShapes like the compiled programs, onto mainTexture.
+ *
+ * @return 0 when the program ends, -1 if a draw fails or the bytecode is invalid.
+ */
+int runBytecode(const Bytecode *program, SDL_Renderer *renderer, SDL_Texture *mainTexture) {
+    Value *stack = malloc(VM_STACK_SIZE * sizeof(Value));
+    Frame frames[VM_MAX_FRAMES];
+    if (!stack) {
+        printf("%sExecutionError: Failed to allocate the program stack.\n", RED_COLOR);
+        return -1;
+    }
+
+    const BytecodeFunction *mainFunction = &program->functions[0];
+    Frame *frame = frames;
+    *frame = (Frame){mainFunction, 0, 0};
+    int sp = mainFunction->slotCount;
+    for (int i = 0; i < sp; i++) stack[i] = (Value){VALUE_INT, {.i = 0}};
+
+    ByteReader reader = {program->code, program->codeSize, mainFunction->entry, false};
+    const char *error = NULL;
+
+#define PUSH(value) do { if (sp >= VM_STACK_SIZE) { error = "stack overflow"; goto fail; } stack[sp++] = (value); } while (0)
+#define POP(target) do { if (sp <= frame->base + frame->function->slotCount) { error = "stack underflow"; goto fail; } (target) = stack[--sp]; } while (0)
+
+    for (;;) {
+        Opcode op = (Opcode)readU8(&reader);
+        if (reader.failed) {
+            error = "code overrun";
+            goto fail;
+        }
+
+        switch (op) {
+            case OP_INT: {
+                Value value = {VALUE_INT, {.i = (int)readU32(&reader)}};
+                PUSH(value);
+                break;
+            }
+            case OP_FLOAT: {
+                Value value = {VALUE_FLOAT, {.f = readF64(&reader)}};
+                PUSH(value);
+                break;
+            }
+            case OP_STRING: {
+                Uint16 index = readU16(&reader);
+                if (index >= program->stringCount) { error = "invalid string"; goto fail; }
+                Value value = {VALUE_STRING, {.s = program->strings[index]}};
+                PUSH(value);
+                break;
+            }
+            case OP_LOAD:
+            case OP_STORE: {
+                Uint16 slot = readU16(&reader);
+                if (slot >= frame->function->slotCount) { error = "invalid variable"; goto fail; }
+                if (op == OP_LOAD) {
+                    PUSH(stack[frame->base + slot]);
+                } else {
+                    POP(stack[frame->base + slot]);
+                }
+                break;
+            }
+            case OP_ADD: case OP_SUB: case OP_MUL: case OP_DIV:
+            case OP_EQ: case OP_NE: case OP_LT: case OP_GT: case OP_LE: case OP_GE:
+            case OP_AND: case OP_OR: {
+                Value left, right, result;
+                POP(right);
+                POP(left);
+                if (!applyOperator(op, left, right, &result)) {
+                    error = (op == OP_DIV && right.type == VALUE_INT && right.as.i == 0) ? "division by zero" : "invalid operands";
+                    goto fail;
+                }
+                PUSH(result);
+                break;
+            }
+            case OP_JUMP:
+            case OP_JUMP_IF_FALSE: {
+                Uint32 target = readU32(&reader);
+                if (target >= program->codeSize) { error = "invalid jump"; goto fail; }
+                if (op == OP_JUMP_IF_FALSE) {
+                    Value condition;
+                    POP(condition);
+                    if (isTruthy(condition)) break;
+                }
+                reader.offset = target;
+                break;
+            }
+            case OP_CALL: {
+                Uint16 index = readU16(&reader);
+                if (index == 0 || index >= program->functionCount) { error = "invalid function"; goto fail; }
+                const BytecodeFunction *function = &program->functions[index];
+                int base = sp - function->paramCount;
+                if (base < frame->base + frame->function->slotCount) { error = "missing arguments"; goto fail; }
+                if (frame + 1 >= frames + VM_MAX_FRAMES || base + function->slotCount >= VM_STACK_SIZE) {
+                    error = "too many nested calls";
+                    goto fail;
+                }
+                for (sp = base + function->paramCount; sp < base + function->slotCount; sp++) {
+                    stack[sp] = (Value){VALUE_INT, {.i = 0}};
+                }
+                *++frame = (Frame){function, (Uint32)reader.offset, base};
+                reader.offset = function->entry;
+                break;
+            }
+            case OP_RETURN: {
+                Value result;
+                POP(result);
+                if (frame == frames) {
+                    free(stack);
+                    return 0;  // End of the main program
+                }
+                sp = frame->base;
+                reader.offset = frame->returnAddress;
+                frame--;
+                PUSH(result);
+                break;
+            }
+            case OP_POP: {
+                Value discarded;
+                POP(discarded);
+                (void)discarded;
+                break;
+            }
+            case OP_DRAW: {
+                Uint8 shape = readU8(&reader);
+                Uint8 flags = readU8(&reader);
+                Uint16 colorIndex = readU16(&reader);
+                Uint8 argCount = readU8(&reader);
+                const SDL_Color *color = colorIndex < program->stringCount ? findColor(program->strings[colorIndex]) : NULL;
+                if (shape >= SHAPE_CODE_COUNT || !color || argCount != shapeArgCounts[shape]) {
+                    error = "invalid draw";
+                    goto fail;
+                }
+
+                int args[5];
+                for (int i = argCount - 1; i >= 0; i--) {
+                    Value value;
+                    POP(value);
+                    if (value.type == VALUE_STRING) { error = "invalid draw"; goto fail; }
+                    args[i] = value.type == VALUE_FLOAT ? (int)value.as.f : value.as.i;
+                }
+                if (drawFromBytecode(renderer, mainTexture, shape, flags, *color, args) == -1) {
+                    free(stack);
+                    return -1;
+                }
+                break;
+            }
+            default:
+                error = "unknown opcode";
+                goto fail;
+        }
+    }
+
+#undef PUSH
+#undef POP
+
+fail:
+    printf("%sExecutionError: Invalid bytecode at offset %u (%s).\n", RED_COLOR, (unsigned)reader.offset, error);
+    free(stack);
+    return -1;
+}
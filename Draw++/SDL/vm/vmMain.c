@@ -0,0 +1,94 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+
+#include "../files.h/runtime.h"
+#include "../files.h/vm.h"
+
+// ANSI escape codes for colors
+#define RED_COLOR "-#red "
+
+/**
+ * @brief Runs a program compiled to bytecode by interpreter.py --bytecode.
+ *
+ * Does what the main function of a compiled program does, with the
+ * configuration read from the bytecode instead of defines, so a script runs
+ * without compiling any C. Built once with the runtime library (make vm).
+ * Usage: dppvm FILE [--headless ...] [--batch N] [--snapshot FILE]
+ */
+int main(int argc, char *argv[]) {
+    SDL_Window *window = NULL;
+    SDL_Renderer *renderer = NULL;
+    SDL_Event event;
+    SDL_Texture* mainTexture = NULL;
+    Bytecode program;
+
+    if (argc < 2) {
+        printf("%sExecutionError: Usage: %s FILE [options]\n", RED_COLOR, argv[0]);
+        return -1;
+    }
+    if (loadBytecode(argv[1], &program) != 0) return -1;
+
+    setDrawBatch(program.drawBatch);
+    snapshot.programHash = program.programHash;
+    if (parseHeadlessArgs(argc, argv) != 0 || parseDrawBatchArgs(argc, argv) != 0 || parseSnapshotArgs(argc, argv) != 0) {
+        freeBytecode(&program);
+        return -1;
+    }
+    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS) != 0) {
+        printf("%sExecutionError: Failed to initialize SDL.\n", RED_COLOR);
+        freeBytecode(&program);
+        return -1;
+    }
+    if (headless.enabled) {
+        if (createHeadlessRenderer(program.windowW, program.windowH, &renderer) != 0) {
+            SDL_Quit();
+            freeBytecode(&program);
+            return -1;
+        }
+    } else {
+        if (SDL_CreateWindowAndRenderer(program.windowW, program.windowH, SDL_WINDOW_RESIZABLE, &window, &renderer) != 0) {
+            printf("%sExecutionError: Failed to create window and renderer.\n", RED_COLOR);
+            SDL_Quit();
+            freeBytecode(&program);
+            return -1;
+        }
+        SDL_Surface* icon = SDL_LoadBMP("IDE/Dpp_circle.bmp");
+        if (icon) {
+            SDL_SetWindowIcon(window, icon);
+            SDL_FreeSurface(icon);
+        }
+        SDL_SetWindowTitle(window, program.title);
+    }
+
+    mainTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, program.windowW, program.windowH);
+    if (!mainTexture || SDL_SetRenderTarget(renderer, mainTexture) != 0) {
+        printf("%sExecutionError: Failed to create main texture.\n", RED_COLOR);
+        cleanup(mainTexture, renderer, window);
+        freeBytecode(&program);
+        return -1;
+    }
+    SDL_SetRenderDrawColor(renderer, program.bgcolorR, program.bgcolorG, program.bgcolorB, 255);
+    SDL_RenderClear(renderer);
+    Cursor cursor = createCursor(program.windowW / 2, program.windowH / 2, program.cursorColor, program.cursorSize, true);
+
+    bool sceneRestored = snapshot.enabled && loadSnapshot(snapshot.path) == 0;
+    if (!sceneRestored && runBytecode(&program, renderer, mainTexture) != 0) {
+        cleanup(mainTexture, renderer, window);
+        freeBytecode(&program);
+        return -1;
+    }
+
+    SDL_SetRenderTarget(renderer, NULL);
+    SDL_RenderCopy(renderer, mainTexture, NULL, NULL);
+    SDL_RenderPresent(renderer);
+
+    int result = 0;
+    if (headless.enabled) {
+        result = runHeadless(renderer, program.bgcolorR, program.bgcolorG, program.bgcolorB);
+    } else {
+        mainLoop(window, renderer, event, cursor, program.bgcolorR, program.bgcolorG, program.bgcolorB);
+    }
+    cleanup(mainTexture, renderer, window);
+    freeBytecode(&program);
+    return result;
+}
@@ -1,5 +1,8 @@
 import os
 import sys
+import glob
+import shutil
+import hashlib
 import argparse
 import atexit
 
@@ -16,15 +19,76 @@ except ImportError:
 from COMPILATOR.src.lexer import init_lexer
 from COMPILATOR.src.parser import init_parser
 from COMPILATOR.src.myast import *
+from COMPILATOR.src.bytecode import write_bytecode
 
 DEBUG = False  # Debug mode is off by default
 
+# === 3. Compile Cache ===
+
+ROOT_DIR = os.path.dirname(os.path.abspath(__file__))
+CACHE_DIR = os.path.join(ROOT_DIR, "SDL", "files.cache")  # One folder per build, named by its key
+CACHE_KEY_FILE = os.path.join(ROOT_DIR, ".to_run.key")     # Key of .to_run.c, read by `make run`
+GENERATED_FILE = os.path.join(ROOT_DIR, ".to_run.c")
+CACHE_EXEC = "main.exe" if os.name == "nt" else "main"
+CACHE_MAX_ENTRIES = 16  # Older builds are removed past this count
+
+# @{
+# @brief Computes the cache key of a source file.
+# @details The key covers everything the executable is built from: the source,
+#          the program name, the debug flag, the compiler sources and the SDL
+#          runtime sources and headers, so editing any of them invalidates it.
+# @param filetxt The Draw++ source code.
+# @param filename The program name, used as the window title.
+# @return The hexadecimal key.
+def compute_cache_key(filetxt, filename):
+    digest = hashlib.sha256()
+    digest.update(f"{filename}\0{int(DEBUG)}\0{filetxt}\0".encode())
+    patterns = ["COMPILATOR/src/*.py", "SDL/src/*.c", "SDL/files.h/*.h", "Makefile"]
+    for pattern in patterns:
+        for path in sorted(glob.glob(os.path.join(ROOT_DIR, pattern))):
+            digest.update(os.path.relpath(path, ROOT_DIR).replace(os.sep, "/").encode() + b"\0")
+            with open(path, "rb") as file:
+                digest.update(hashlib.sha256(file.read()).digest())
+    return digest.hexdigest()[:32]
+
+# @brief Restores the generated C code of a cached build.
+# @param key The cache key of the source.
+# @return True if the build was cached, False if the source has to be compiled.
+def restore_cached_build(key):
+    entry = os.path.join(CACHE_DIR, key)
+    if not (os.path.isfile(os.path.join(entry, CACHE_EXEC)) and os.path.isfile(os.path.join(entry, "to_run.c"))):
+        return False
+    shutil.copyfile(os.path.join(entry, "to_run.c"), GENERATED_FILE)
+    os.utime(entry)  # Keeps recently used builds out of the pruning
+    return True
+
+# @brief Removes the least recently used builds past CACHE_MAX_ENTRIES.
+def prune_cache():
+    if not os.path.isdir(CACHE_DIR):
+        return
+    entries = [os.path.join(CACHE_DIR, name) for name in os.listdir(CACHE_DIR)]
+    entries = sorted((entry for entry in entries if os.path.isdir(entry)), key=os.path.getmtime, reverse=True)
+    for entry in entries[CACHE_MAX_ENTRIES:]:
+        shutil.rmtree(entry, ignore_errors=True)
+
+# @brief Writes the key of .to_run.c, `make run` stores or reuses the build under it.
+# @param key The cache key, None to disable the cache for this run.
+def write_cache_key(key):
+    if key is None:
+        if os.path.exists(CACHE_KEY_FILE):
+            os.remove(CACHE_KEY_FILE)
+        return
+    with open(CACHE_KEY_FILE, "w") as file:
+        file.write(key)
+# @}
+
 # === 4. File Analysis and Execution ===
 
 # @{
 # @brief Executes a source file written in the Draw++ language.
 # @param file_path The path to the Draw++ source file.
-def run_file(file_path, filename):
+# @param bytecode Writes .to_run.dpc for the runtime's virtual machine instead of .to_run.c.
+def run_file(file_path, filename, bytecode=False):
     """Executes a Draw++ source file."""
 
     lexer = init_lexer()
@@ -37,6 +101,14 @@ def run_file(file_path, filename):
     with open(file_path, 'r') as file:
         filetxt = file.read()
 
+    # An unchanged source reuses its generated code and executable
+    write_cache_key(None)
+    cache_key = compute_cache_key(filetxt, filename)
+    if not bytecode and restore_cached_build(cache_key):
+        write_cache_key(cache_key)
+        print(f"-#green Source unchanged, reusing the compiled program")
+        return
+
     if DEBUG:
         print(f"[DEBUG] File : {file_path}")
         print(f"[DEBUG] Content :\n")
@@ -77,9 +149,14 @@ def run_file(file_path, filename):
         elif ast is not None:
             print(f"[DEBUG] Single AST Node: {ast}")
 
-    if ast:
+    if ast and bytecode:
+        # Nothing to cache, the bytecode runs without compiling
+        write_bytecode(ast, DEBUG, filename)
+    elif ast:
         # Execute the AST
         execute_ast(ast, DEBUG, filename)
+        write_cache_key(cache_key)
+        prune_cache()
 # @}
 
 # === 5. Interactive Mode ===
@@ -178,6 +255,7 @@ def main():
     argparser.add_argument("file", nargs="?", help="Source file to execute (optional)")
     argparser.add_argument("-d", "--debug", action="store_true", help="Enable debug mode")
     argparser.add_argument("-n", "--name", default="test", help="Output filename without extension (default: test)")
+    argparser.add_argument("-b", "--bytecode", action="store_true", help="Write bytecode for the runtime's virtual machine instead of C")
     args = argparser.parse_args()
 
     # Set the debug mode flag globally
@@ -191,7 +269,7 @@ def main():
 
     if args.file:  # If a file is specified
         file_path = args.file
-        run_file(file_path, filename)
+        run_file(file_path, filename, args.bytecode)
     else:  # Interactive mode
         run_interactive()
 # @}